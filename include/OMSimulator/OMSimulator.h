@@ -72,6 +72,7 @@ OMSAPI oms_status_enu_t OMSCALL oms_addSubModel(const char* cref, const char* fm
 OMSAPI oms_status_enu_t OMSCALL oms_setExportName(const char* cref, const char* exportName); // set export name for a submodel
 OMSAPI oms_status_enu_t OMSCALL oms_addSystem(const char* cref, oms_system_enu_t type);
 OMSAPI oms_status_enu_t OMSCALL oms_addTimeIndicator(const char* signal);
+OMSAPI oms_status_enu_t OMSCALL oms_cloneModel(const char* cref, const char* newCref);
 OMSAPI int OMSCALL oms_compareSimulationResults(const char* filenameA, const char* filenameB, const char* var, double relTol, double absTol);
 OMSAPI oms_status_enu_t OMSCALL oms_copySystem(const char* source, const char* target);
 OMSAPI oms_status_enu_t OMSCALL oms_delete(const char* cref);
@@ -117,6 +118,7 @@ OMSAPI oms_status_enu_t OMSCALL oms_getWorkingDirectory(char** newWorkingDir);
 OMSAPI oms_status_enu_t OMSCALL oms_importFile(const char* filename, char** cref);
 OMSAPI oms_status_enu_t OMSCALL oms_importSnapshot(const char* cref, const char* snapshot, char** newCref);
 OMSAPI oms_status_enu_t OMSCALL oms_initialize(const char* cref);
+OMSAPI oms_status_enu_t OMSCALL oms_initializeFromCheckpoint(const char* cref, const char* filename);
 OMSAPI oms_status_enu_t OMSCALL oms_instantiate(const char* cref);
 OMSAPI oms_status_enu_t OMSCALL oms_list(const char* cref, char** contents);
 OMSAPI oms_status_enu_t OMSCALL oms_listUnconnectedConnectors(const char* cref, char** contents);
@@ -131,8 +133,11 @@ OMSAPI oms_status_enu_t OMSCALL oms_rename(const char* cref, const char* newCref
 OMSAPI oms_status_enu_t OMSCALL oms_replaceSubModel(const char* cref, const char* fmuPath, bool dryRun, int* warningCount);
 OMSAPI oms_status_enu_t OMSCALL oms_reset(const char* cref);
 OMSAPI oms_status_enu_t OMSCALL oms_RunFile(const char* filename);
+OMSAPI oms_status_enu_t OMSCALL oms_saveCheckpoint(const char* cref, const char* filename);
+OMSAPI oms_status_enu_t OMSCALL oms_setActivationRatio(const char* cref, int k);
 OMSAPI oms_status_enu_t OMSCALL oms_setBoolean(const char* cref, bool value);
 OMSAPI oms_status_enu_t OMSCALL oms_setBusGeometry(const char* bus, const ssd_connector_geometry_t* geometry);
+OMSAPI oms_status_enu_t OMSCALL oms_setCheckpointFile(const char* cref, const char* filename, double interval);
 OMSAPI oms_status_enu_t OMSCALL oms_setCommandLineOption(const char* cmd);
 OMSAPI oms_status_enu_t OMSCALL oms_setConnectionGeometry(const char* crefA, const char* crefB, const ssd_connection_geometry_t* geometry);
 OMSAPI oms_status_enu_t OMSCALL oms_setConnectorGeometry(const char* cref, const ssd_connector_geometry_t* geometry);
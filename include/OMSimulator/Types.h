@@ -72,6 +72,7 @@ typedef enum {
   oms_solver_sc_min,
   oms_solver_sc_explicit_euler,
   oms_solver_sc_cvode,  ///< default
+  oms_solver_sc_dopri5, ///< Embedded Runge-Kutta (Dormand-Prince 5(4)) with adaptive stepsize
   oms_solver_sc_max,
   oms_solver_wc_min,
   oms_solver_wc_ma,     ///< Fixed stepsize (default)
@@ -83,7 +84,8 @@ typedef enum {
 typedef enum {
   oms_alg_solver_none,
   oms_alg_solver_fixedpoint,  ///< Fixed-point-iteration (default)
-  oms_alg_solver_kinsol       ///< Kinsol solver
+  oms_alg_solver_kinsol,      ///< Kinsol solver
+  oms_alg_solver_anderson     ///< Anderson-accelerated fixed-point-iteration
 } oms_alg_solver_enu_t;
 
 typedef enum {
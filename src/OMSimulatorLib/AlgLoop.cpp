@@ -36,6 +36,9 @@
 #include "Flags.h"
 #include "System.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
 #include <sstream>
 
 /**
@@ -79,6 +82,14 @@ void oms::KinsolSolver::sundialsErrorHandlerFunction(int errorCode, const char *
   {
     kinsolUserData = (KINSOL_USER_DATA *)user_data;
     systNum = std::to_string(kinsolUserData->algLoopNumber);
+
+    // failures with an outdated Jacobian are retried with a new one
+    if (kinsolUserData->solver && kinsolUserData->solver->jacobianReused)
+    {
+      logDebug("SUNDIALS_ERROR: [system] " + systNum + " [module] " + mod + " | [function] " + func
+               + " | [error_code] " + std::to_string(errorCode) + "\n" + std::string(msg));
+      return;
+    }
   }
 
   logError("SUNDIALS_ERROR: [system] " + systNum + " [module] " + mod + " | [function] " + func
@@ -132,45 +143,193 @@ void oms::KinsolSolver::sundialsInfoHandlerFunction(const char *module, const ch
 int oms::KinsolSolver::nlsKinsolJac(N_Vector u, N_Vector fu, SUNMatrix J, void *user_data, N_Vector tmp1, N_Vector tmp2)
 {
   KINSOL_USER_DATA* kinsoluserData = (KINSOL_USER_DATA*) user_data;
-  System* syst = kinsoluserData->syst;
-  AlgLoop* algLoop = syst->getAlgLoop(kinsoluserData->algLoopNumber);
-  DirectedGraph* graph = kinsoluserData->graph;
-  const scc_t SCC = algLoop->getSCC();
-  const int size = SCC.connections.size();
+  KinsolSolver* solver = kinsoluserData->solver;
+  const SparsityPattern& pattern = solver->pattern;
+  const std::vector<int>& columnPointers = pattern.getColumnPointers();
+  const std::vector<int>& rowIndices = pattern.getRowIndices();
 
-  oms_status_enu_t status;
-  double *u_data = NV_DATA_S(u);
+  SUNMatZero(J);
+
+  if (solver->useDirectionalDerivative)
+  {
+    // one call per component and color; the loop residual is res = out(u) - u
+    for (JacobianGroup_t& group : solver->jacobianGroups)
+    {
+      if (oms_status_ok != group.component->getDirectionalDerivative(group.index, group.seed.data(), group.values.data()))
+        return logError("not recoverable error");
 
-  for(int j=0; j<size; j++)
+      for (size_t k = 0; k < group.values.size(); ++k)
+        SM_ELEMENT_D(J, group.rows[k], group.columns[k]) = group.values[k];
+    }
+
+    for (int i = 0; i < solver->size; ++i)
+      SM_ELEMENT_D(J, i, i) -= 1.0;
+
+    return 0;
+  }
+
+  // finite differences, all columns of the same color are perturbed at once
+  double *u_data = NV_DATA_S(u);
+  double *fu_data = NV_DATA_S(fu);
+  double *ftmp_data = NV_DATA_S(tmp1);
+  double *utmp_data = NV_DATA_S(tmp2);
+  const std::vector<int>& colorPointers = pattern.getColorPointers();
+  const std::vector<int>& columnsByColor = pattern.getColumnsByColor();
+  const double sqrtUround = sqrt(UNIT_ROUNDOFF);
+
+  for (int c = 0; c < pattern.getNumberOfColors(); ++c)
   {
-    const int output = SCC.connections[j].first;
-    const oms::ComRef& crefOutput = graph->getNodes()[output].getName();
-    const int input = SCC.connections[j].second;
-    const oms::ComRef& crefInput = graph->getNodes()[input].getName();
-    // res[j] = output - input
-    // std::cout << "res[" << j << "] = " << std::string(crefOutput) << " - " << std::string(crefInput) << std::endl;
+    for (int l = colorPointers[c]; l < colorPointers[c+1]; ++l)
+    {
+      const int col = columnsByColor[l];
+      utmp_data[col] = u_data[col];
+      u_data[col] += sqrtUround * std::max(fabs(u_data[col]), 1.0);
+    }
 
-    for(int i=0; i<size; i++)
+    int flag = nlsKinsolResiduals(u, tmp1, user_data);
+
+    for (int l = colorPointers[c]; l < colorPointers[c+1]; ++l)
     {
-      double der = 0.0;
-      const int input_col = SCC.connections[i].second;
-      oms::ComRef crefInput_col = graph->getNodes()[input_col].getName();
-      oms::ComRef front = crefInput_col.pop_front();
-
-      if (front == crefOutput.front())
-        if (oms_status_ok != syst->getDirectionalDerivative(crefOutput, crefInput_col, der))
-          return logError("not recoverable error");
-      if (input_col == input)
-        der -= 1.0;
-
-      SM_ELEMENT_D(J, j, i) = der;
-      // std::cout << "J[" << j << ", " << i << "] = " << der << std::endl;
+      const int col = columnsByColor[l];
+      const double inc = u_data[col] - utmp_data[col];
+      u_data[col] = utmp_data[col];
+      if (flag == 0)
+        for (int k = columnPointers[col]; k < columnPointers[col+1]; ++k)
+          SM_ELEMENT_D(J, rowIndices[k], col) = (ftmp_data[rowIndices[k]] - fu_data[rowIndices[k]]) / inc;
     }
+
+    if (flag != 0)
+      return flag;
   }
 
   return 0;
 }
 
+/**
+ * @brief Set up the sparsity pattern and coloring of the loop Jacobian.
+ *
+ * Entry (j, i) is structurally non-zero if output j of the loop depends
+ * on input i, i.e. if the graph contains the feedthrough edge input_i -> output_j.
+ *
+ * @param syst                Reference to System object
+ * @param graph               Reference to graph object
+ * @param SCC                 Strongly connected component of the loop
+ * @return oms_status_enu_t
+ */
+oms_status_enu_t oms::KinsolSolver::initializeJacobian(System& syst, DirectedGraph& graph, const scc_t& SCC)
+{
+  const int algLoopNumber = ((KINSOL_USER_DATA*)user_data)->algLoopNumber;
+
+  std::map<int, int> inputColumn;
+  std::map<int, std::vector<int>> outputRows;
+  for (int j = 0; j < size; ++j)
+  {
+    inputColumn[SCC.connections[j].second] = j;
+    outputRows[SCC.connections[j].first].push_back(j);
+  }
+
+  pattern.resize(size);
+  if (size < static_cast<int>(SCC.connections.size()))
+  {
+    // torn loop: the tear outputs depend on the iteration variables through the evaluated connections
+    for (int j = 0; j < size; ++j)
+      for (int i = 0; i < size; ++i)
+        pattern.addEntry(j, i);
+    useDirectionalDerivative = false;
+  }
+  else
+  {
+    for (const std::pair<int, int>& edge : graph.getEdges().connections)
+    {
+      auto input = inputColumn.find(edge.first);
+      if (input == inputColumn.end())
+        continue;
+      auto output = outputRows.find(edge.second);
+      if (output == outputRows.end())
+        continue;
+      for (int row : output->second)
+        pattern.addEntry(row, input->second);
+    }
+  }
+  pattern.compress();
+
+  logDebug("Jacobian of algebraic loop " + std::to_string(algLoopNumber) + ": " + std::to_string(size) + " x " + std::to_string(size)
+           + ", " + std::to_string(pattern.getNumberOfNonZeros()) + " non-zeros, " + std::to_string(pattern.getNumberOfColors()) + " colors");
+
+  jacobianGroups.clear();
+  if (!useDirectionalDerivative)
+    return oms_status_ok;
+
+  const std::vector<int>& columnPointers = pattern.getColumnPointers();
+  const std::vector<int>& rowIndices = pattern.getRowIndices();
+  const std::vector<int>& colorPointers = pattern.getColorPointers();
+  const std::vector<int>& columnsByColor = pattern.getColumnsByColor();
+
+  std::vector<std::vector<ComRef>> knowns;
+  std::vector<std::vector<ComRef>> unknowns;
+  for (int c = 0; c < pattern.getNumberOfColors(); ++c)
+  {
+    std::map<ComRef, size_t> groupIndex;
+    for (int l = colorPointers[c]; l < colorPointers[c+1]; ++l)
+    {
+      const int col = columnsByColor[l];
+      ComRef knownCref(graph.getNodes()[SCC.connections[col].second].getName());
+      ComRef front = knownCref.pop_front();
+
+      auto it = syst.getComponents().find(front);
+      if (it == syst.getComponents().end() || !it->second->getFMUInfo() || !it->second->getFMUInfo()->getProvidesDirectionalDerivative())
+      {
+        logDebug("Directional derivatives not available for \"" + std::string(front) + "\"; using finite differences for algebraic loop " + std::to_string(algLoopNumber));
+        jacobianGroups.clear();
+        useDirectionalDerivative = false;
+        return oms_status_ok;
+      }
+
+      if (groupIndex.find(front) == groupIndex.end())
+      {
+        groupIndex[front] = jacobianGroups.size();
+        jacobianGroups.push_back(JacobianGroup_t());
+        jacobianGroups.back().component = it->second;
+        knowns.push_back(std::vector<ComRef>());
+        unknowns.push_back(std::vector<ComRef>());
+      }
+      const size_t g = groupIndex[front];
+      JacobianGroup_t& group = jacobianGroups[g];
+      knowns[g].push_back(knownCref);
+      group.seed.push_back(1.0);
+
+      for (int k = columnPointers[col]; k < columnPointers[col+1]; ++k)
+      {
+        const int row = rowIndices[k];
+        ComRef unknownCref(graph.getNodes()[SCC.connections[row].first].getName());
+        if (unknownCref.pop_front() != front)
+          continue;
+        unknowns[g].push_back(unknownCref);
+        group.rows.push_back(row);
+        group.columns.push_back(col);
+      }
+    }
+  }
+
+  // groups without any dependent output don't need to be evaluated
+  size_t nGroups = 0;
+  for (size_t g = 0; g < jacobianGroups.size(); ++g)
+  {
+    if (unknowns[g].empty())
+      continue;
+    JacobianGroup_t& group = jacobianGroups[nGroups++];
+    if (&group != &jacobianGroups[g])
+      group = jacobianGroups[g];
+    if (oms_status_ok != group.component->prepareDirectionalDerivative(unknowns[g], knowns[g], group.index))
+      return oms_status_error;
+    group.values.resize(unknowns[g].size());
+  }
+  jacobianGroups.resize(nGroups);
+
+  logDebug("Jacobian of algebraic loop " + std::to_string(algLoopNumber) + " is evaluated with " + std::to_string(jacobianGroups.size()) + " directional derivative calls");
+  return oms_status_ok;
+}
+
 /**
  * @brief Residual function for KINSOL
  *
@@ -194,76 +353,232 @@ int oms::KinsolSolver::nlsKinsolResiduals(N_Vector u, N_Vector fval, void *user_
   double *fval_data = NV_DATA_S(fval);
 
   KINSOL_USER_DATA* kinsoluserData = (KINSOL_USER_DATA*) user_data;
+  KinsolSolver* solver = kinsoluserData->solver;
   System* syst = kinsoluserData->syst;
-  AlgLoop* algLoop = syst->getAlgLoop(kinsoluserData->algLoopNumber);
-  DirectedGraph* graph = kinsoluserData->graph;
-  const scc_t SCC = algLoop->getSCC();
   kinsoluserData->iteration++;
 
-  const int size = SCC.connections.size();
-  double maxRes;
+  const int size = solver->size;
   oms_status_enu_t status;
-  std::stringstream ss;
 
-  if (Flags::DumpAlgLoops())
+  // Set values from u
+  status = setLoopInputs(*syst, solver->loopInputs, u_data);
+  if (status == oms_status_discard || status == oms_status_error || status == oms_status_warning)
   {
-    ss << "iteration " << std::to_string(kinsoluserData->iteration) << std::endl;
-    ss << "inputs:" << std::endl;
+    logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": recoverable error (1)");
+    return 1 /* recoverable error */;
   }
-
-  // Set values from u
-  for (int i=0; i<size; ++i)
+  else if (status == oms_status_fatal)
   {
-    int input = SCC.connections[i].second;
-    status = syst->setReal(graph->getNodes()[input].getName(), u_data[i]);
-    if (Flags::DumpAlgLoops())
-      ss << "  " << graph->getNodes()[input].getName().c_str() << ": " << u_data[i] << std::endl;
-    if (status == oms_status_discard || status == oms_status_error || status == oms_status_warning)
-    {
-      logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": recoverable error (1)");
-      return 1 /* recoverable error */;
-    }
-    else if (status == oms_status_fatal)
-    {
-      logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": not recoverable error (1)");
-      return -1 /* not recoverable error */;
-    }
+    logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": not recoverable error (1)");
+    return -1 /* not recoverable error */;
   }
 
-  if (Flags::DumpAlgLoops())
-    ss << "outputs:" << std::endl;
+  // Evaluate the connections that aren't iteration variables
+  for (size_t k = 0; k < solver->innerOutputs.size() && oms_status_ok == status; ++k)
+  {
+    double value;
+    status = getLoopSignals(*syst, solver->innerOutputs[k], &value);
+    if (oms_status_ok == status)
+      status = setLoopSignals(*syst, solver->innerInputs[k], &value);
+  }
+  if (status == oms_status_discard || status == oms_status_error || status == oms_status_warning)
+  {
+    logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": recoverable error (3)");
+    return 1 /* recoverable error */;
+  }
+  else if (status == oms_status_fatal)
+  {
+    logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": not recoverable error (3)");
+    return -1 /* not recoverable error */;
+  }
 
   // Get updated values and calulate residual
-  for (int i=0; i<size; ++i)
+  status = getLoopOutputs(*syst, solver->loopOutputs, fval_data);
+  if (status == oms_status_discard || status == oms_status_error || status == oms_status_warning)
   {
-    int output = SCC.connections[i].first;
-    status = syst->getReal(graph->getNodes()[output].getName(), fval_data[i]);
-    if (Flags::DumpAlgLoops())
-      ss << "  " << graph->getNodes()[output].getName().c_str() << ": " << fval_data[i] << std::endl;
-    if (status == oms_status_discard || status == oms_status_error || status == oms_status_warning)
-    {
-      logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": recoverable error (2)");
-      return 1 /* recoverable error */;
-    }
-    else if (status == oms_status_fatal)
-    {
-      logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": not recoverable error (2)");
-      return -1 /* not recoverable error */;
-    }
-    fval_data[i] = fval_data[i] - u_data[i];
+    logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": recoverable error (2)");
+    return 1 /* recoverable error */;
+  }
+  else if (status == oms_status_fatal)
+  {
+    logInfo("iteration " + std::to_string(kinsoluserData->iteration) + ": not recoverable error (2)");
+    return -1 /* not recoverable error */;
   }
 
   if (Flags::DumpAlgLoops())
   {
+    const scc_t& SCC = syst->getAlgLoop(kinsoluserData->algLoopNumber)->getSCC();
+    const std::vector<Connector>& nodes = kinsoluserData->graph->getNodes();
+    std::stringstream ss;
+    ss << "iteration " << std::to_string(kinsoluserData->iteration) << std::endl;
+    ss << "inputs:" << std::endl;
+    for (int i=0; i<size; ++i)
+      ss << "  " << nodes[SCC.connections[i].second].getName().c_str() << ": " << u_data[i] << std::endl;
+    ss << "outputs:" << std::endl;
+    for (int i=0; i<size; ++i)
+      ss << "  " << nodes[SCC.connections[i].first].getName().c_str() << ": " << fval_data[i] << std::endl;
     ss << "residuals:" << std::endl;
     for (int i=0; i<size; ++i)
-      ss << "  res[" << i << "]: " << fval_data[i] << std::endl;
+      ss << "  res[" << i << "]: " << fval_data[i] - u_data[i] << std::endl;
     logInfo(ss.str());
   }
 
+  for (int i=0; i<size; ++i)
+    fval_data[i] = fval_data[i] - u_data[i];
+
   return 0 /* success */;
 }
 
+/**
+ * @brief Set signals of the loop
+ *
+ * @param syst       System of the loop, used for signals without component
+ * @param group      Precompiled signals
+ * @param u          Values in loop order
+ * @return oms_status_enu_t
+ */
+oms_status_enu_t oms::KinsolSolver::setLoopSignals(System& syst, LoopSignals_t& group, const double* u)
+{
+  oms_status_enu_t status;
+  if (group.component)
+  {
+    for (size_t k = 0; k < group.positions.size(); ++k)
+      group.buffer[k] = u[group.positions[k]];
+    return group.component->setRealSignals(group.index, group.buffer.data());
+  }
+
+  for (size_t k = 0; k < group.positions.size(); ++k)
+  {
+    status = syst.setReal(group.crefs[k], u[group.positions[k]]);
+    if (oms_status_ok != status)
+      return status;
+  }
+  return oms_status_ok;
+}
+
+/**
+ * @brief Get signals of the loop
+ *
+ * @param syst       System of the loop, used for signals without component
+ * @param group      Precompiled signals
+ * @param y          Values in loop order
+ * @return oms_status_enu_t
+ */
+oms_status_enu_t oms::KinsolSolver::getLoopSignals(System& syst, LoopSignals_t& group, double* y)
+{
+  oms_status_enu_t status;
+  if (group.component)
+  {
+    status = group.component->getRealSignals(group.index, group.buffer.data());
+    if (oms_status_ok != status)
+      return status;
+    for (size_t k = 0; k < group.positions.size(); ++k)
+      y[group.positions[k]] = group.buffer[k];
+    return oms_status_ok;
+  }
+
+  for (size_t k = 0; k < group.positions.size(); ++k)
+  {
+    status = syst.getReal(group.crefs[k], y[group.positions[k]]);
+    if (oms_status_ok != status)
+      return status;
+  }
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::KinsolSolver::setLoopInputs(System& syst, std::vector<LoopSignals_t>& signals, const double* u)
+{
+  for (LoopSignals_t& group : signals)
+  {
+    oms_status_enu_t status = setLoopSignals(syst, group, u);
+    if (oms_status_ok != status)
+      return status;
+  }
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::KinsolSolver::getLoopOutputs(System& syst, std::vector<LoopSignals_t>& signals, double* y)
+{
+  for (LoopSignals_t& group : signals)
+  {
+    oms_status_enu_t status = getLoopSignals(syst, group, y);
+    if (oms_status_ok != status)
+      return status;
+  }
+  return oms_status_ok;
+}
+
+/**
+ * @brief Group the inputs and outputs of the loop by FMU
+ *
+ * Signals of FMUs are resolved to value references once, all others are
+ * accessed by name through the system. The iteration variables are
+ * grouped by FMU; the connections that are evaluated in sequence (torn
+ * loops) get one entry per signal.
+ *
+ * @param syst                Reference to System object
+ * @param graph               Reference to graph object
+ * @param SCC                 Strongly connected component of the loop
+ * @return oms_status_enu_t
+ */
+oms_status_enu_t oms::KinsolSolver::initializeLoopSignals(System& syst, DirectedGraph& graph, const scc_t& SCC)
+{
+  const int n = static_cast<int>(SCC.connections.size());
+  for (int pass = 0; pass < 4; ++pass)
+  {
+    std::vector<LoopSignals_t>& signals = (pass == 0) ? loopInputs : (pass == 1) ? loopOutputs : (pass == 2) ? innerInputs : innerOutputs;
+    const bool grouped = (pass < 2);
+    std::map<ComRef, size_t> groupIndex;
+    std::vector<std::vector<ComRef>> localCrefs;
+    signals.clear();
+
+    for (int i = grouped ? 0 : size; i < (grouped ? size : n); ++i)
+    {
+      const int node = (pass % 2 == 0) ? SCC.connections[i].second : SCC.connections[i].first;
+      ComRef tail(graph.getNodes()[node].getName());
+      ComRef front = tail.pop_front();
+
+      Component* component = NULL;
+      auto it = syst.getComponents().find(front);
+      if (it != syst.getComponents().end() && it->second->getFMUInfo())
+        component = it->second;
+      else
+        front = ComRef();
+
+      size_t g;
+      auto group = groupIndex.find(front);
+      if (grouped && group != groupIndex.end())
+        g = group->second;
+      else
+      {
+        g = signals.size();
+        if (grouped)
+          groupIndex[front] = g;
+        signals.push_back(LoopSignals_t());
+        signals.back().component = component;
+        signals.back().index = -1;
+        localCrefs.push_back(std::vector<ComRef>());
+      }
+
+      signals[g].positions.push_back(grouped ? i : 0);
+      signals[g].crefs.push_back(graph.getNodes()[node].getName());
+      localCrefs[g].push_back(tail);
+    }
+
+    for (size_t g = 0; g < signals.size(); ++g)
+    {
+      if (!signals[g].component)
+        continue;
+      if (oms_status_ok != signals[g].component->prepareRealSignals(localCrefs[g], signals[g].index))
+        return oms_status_error;
+      signals[g].buffer.resize(signals[g].positions.size());
+      signals[g].crefs.clear();
+    }
+  }
+
+  return oms_status_ok;
+}
+
 /**
  * @brief Destroy the oms::KinsolSolver::KinsolSolver object
  *
@@ -319,7 +634,7 @@ oms::KinsolSolver* oms::KinsolSolver::NewKinsolSolver(const int algLoopNum, cons
   }
 
   /* Set user data given to KINSOL */
-  kinsolSolver->user_data = new KINSOL_USER_DATA{/*.syst=*/NULL, /*.graph=*/NULL, /*.algLoopNumber=*/algLoopNum, /*.iteration=*/0};
+  kinsolSolver->user_data = new KINSOL_USER_DATA{/*.syst=*/NULL, /*.graph=*/NULL, /*.algLoopNumber=*/algLoopNum, /*.iteration=*/0, /*.solver=*/kinsolSolver};
   flag = KINSetUserData(kinsolSolver->kinsolMemory, kinsolSolver->user_data);
   if (!checkFlag(flag, "KINSetUserData")) return NULL;
 
@@ -357,10 +672,8 @@ oms::KinsolSolver* oms::KinsolSolver::NewKinsolSolver(const int algLoopNum, cons
   if (!checkFlag(flag, "KINSetLinearSolver")) return NULL;
 
   /* Set Jacobian for linear solver */
-  if (useDirectionalDerivative && Flags::DirectionalDerivatives())
-    flag = KINSetJacFn(kinsolSolver->kinsolMemory, nlsKinsolJac); /* Use symbolic Jacobian */
-  else
-    flag = KINSetJacFn(kinsolSolver->kinsolMemory, NULL); /* Use KINSOLs internal difference quotient function for Jacobian approximation */
+  kinsolSolver->useDirectionalDerivative = useDirectionalDerivative && Flags::DirectionalDerivatives();
+  flag = KINSetJacFn(kinsolSolver->kinsolMemory, nlsKinsolJac); /* Use directional derivatives or colored finite differences */
   if (!checkFlag(flag, "KINSetJacFn")) return NULL;
 
   /* Set function-norm stopping tolerance */
@@ -408,41 +721,69 @@ oms_status_enu_t oms::KinsolSolver::kinsolSolve(System& syst, DirectedGraph& gra
   kinsolUserData->graph = &graph;
   kinsolUserData->iteration = 0;
   AlgLoop* algLoop = syst.getAlgLoop(kinsolUserData->algLoopNumber);
-  const scc_t SCC = algLoop->getSCC();
+  const scc_t& SCC = algLoop->getSCC();
 
   int flag;
   double fNormValue;
 
   logDebug("Solving system " + std::to_string(kinsolUserData->algLoopNumber));
 
-  if (SCC.connections.size() != size)
+  if (SCC.tearSize != size)
   {
     logError("The size of the loop changed! This shouldn't be possible...");
     throw("Serious problem encountered. Open a ticket!");
   }
 
-  /* Set initial guess */
-  double *initialGuess_data = NV_DATA_S(initialGuess);
-  for (int i=0; i < size; i++)
+  if (pattern.getColumnPointers().empty())
   {
-    int output = SCC.connections[i].first;
-    if (oms_status_ok != syst.getReal(graph.getNodes()[output].getName(), initialGuess_data[i]))
-    {
+    if (oms_status_ok != initializeLoopSignals(syst, graph, SCC))
+      return oms_status_error;
+    if (oms_status_ok != initializeJacobian(syst, graph, SCC))
       return oms_status_error;
-    }
   }
 
+  /* Set initial guess */
+  double *initialGuess_data = NV_DATA_S(initialGuess);
+  if (!algLoop->extrapolateSolution(syst.getTime(), initialGuess_data))
+    if (oms_status_ok != getLoopOutputs(syst, loopOutputs, initialGuess_data))
+      return oms_status_error;
+
   /* u and f scaling */
   // TODO: Add scaling that is not only constant ones
 
+  /* Start with the Jacobian of the previous solve (modified Newton) */
+  jacobianReused = jacobianCurrent;
+  if (jacobianReused)
+    N_VScale(1.0, initialGuess, fTmp);
+  flag = KINSetNoInitSetup(kinsolMemory, jacobianReused ? SUNTRUE : SUNFALSE);
+  if (!checkFlag(flag, "KINSetNoInitSetup")) return oms_status_error;
+
   /* Solve algebraic loop with KINSol() */
   flag = KINSol(kinsolMemory,   /* KINSol memory block */
                 initialGuess,   /* initial guess on input; solution vector */
                 KIN_NONE,       /* global strategy choice: Basic newton iteration */
                 uScale,         /* scaling vector, for the variable u */
                 fScale);        /* scaling vector for function values fval */
+
+  if (flag < 0 && jacobianReused)
+  {
+    logDebug("Solving system " + std::to_string(kinsolUserData->algLoopNumber) + " with the previous Jacobian failed; retry with a new Jacobian");
+    jacobianReused = false;
+    N_VScale(1.0, fTmp, initialGuess);
+    flag = KINSetNoInitSetup(kinsolMemory, SUNFALSE);
+    if (!checkFlag(flag, "KINSetNoInitSetup")) return oms_status_error;
+    flag = KINSol(kinsolMemory, initialGuess, KIN_NONE, uScale, fScale);
+  }
+  jacobianReused = false;
+  jacobianCurrent = false;
   if (!checkFlag(flag, "KINSol")) return oms_status_error;
 
+  /* Keep the Jacobian as long as it converges quickly */
+  long int nIterations = 0;
+  flag = KINGetNumNonlinSolvIters(kinsolMemory, &nIterations);
+  if (!checkFlag(flag, "KINGetNumNonlinSolvIters")) return oms_status_error;
+  jacobianCurrent = Flags::AlgLoopJacobianReuse() && nIterations <= 3;
+
   /* Check solution */
   flag = nlsKinsolResiduals(initialGuess, fTmp, user_data);
   fNormValue = N_VWL2Norm(fTmp, fTmp);
@@ -453,6 +794,7 @@ oms_status_enu_t oms::KinsolSolver::kinsolSolve(System& syst, DirectedGraph& gra
     return oms_status_warning;
   }
 
+  algLoop->storeSolution(syst.getTime(), initialGuess_data);
   logDebug("Solved system " + std::to_string(kinsolUserData->algLoopNumber) + " successfully");
   return oms_status_ok;
 }
@@ -462,8 +804,10 @@ oms_status_enu_t oms::KinsolSolver::kinsolSolve(System& syst, DirectedGraph& gra
  *
  * @param method             Specifies used solver for the loop. Can
  *                           be `oms_alg_solver_fixedpoint` for
- *                           fixed-point-iteration or
- *                           `oms_alg_solver_kinsol` for SUNDIALS
+ *                           fixed-point-iteration,
+ *                           `oms_alg_solver_anderson` for
+ *                           Anderson-accelerated fixed-point-iteration
+ *                           or `oms_alg_solver_kinsol` for SUNDIALS
  *                           KINSOL
  * @param relativeTolerance  Tolerance used for the algebraic solver.
  * @param scc                Strong Connected Compontents of the loop
@@ -474,6 +818,7 @@ oms::AlgLoop::AlgLoop(oms_alg_solver_enu_t method, double relativeTolerance, scc
   switch (method)
   {
     case oms_alg_solver_fixedpoint:
+    case oms_alg_solver_anderson:
     case oms_alg_solver_kinsol:
       algSolverMethod = method;
       break;
@@ -484,7 +829,7 @@ oms::AlgLoop::AlgLoop(oms_alg_solver_enu_t method, double relativeTolerance, scc
 
   if (method == oms_alg_solver_kinsol)
   {
-    kinsolData = KinsolSolver::NewKinsolSolver(systNumber, SCC.connections.size(), relativeTolerance, useDirectionalDerivative);
+    kinsolData = KinsolSolver::NewKinsolSolver(systNumber, SCC.tearSize, relativeTolerance, useDirectionalDerivative);
     if (kinsolData==NULL)
     {
       logError("NewKinsolSolver() failed. Aborting!");
@@ -497,7 +842,7 @@ oms::AlgLoop::AlgLoop(oms_alg_solver_enu_t method, double relativeTolerance, scc
  * @brief Solve algebraic loop
  *
  * Using solver method saved during AlgLoop creation.
- * Can use fixed-point-iteration and KINSOL.
+ * Can use fixed-point-iteration, Anderson acceleration and KINSOL.
  *
  * @param syst                Reference to System
  * @param graph               Reference to directed graph
@@ -512,6 +857,8 @@ oms_status_enu_t oms::AlgLoop::solveAlgLoop(System& syst, DirectedGraph& graph)
   {
   case oms_alg_solver_fixedpoint:
     return fixPointIteration(syst, graph);
+  case oms_alg_solver_anderson:
+    return andersonIteration(syst, graph);
   case oms_alg_solver_kinsol:
     return kinsolData->kinsolSolve(syst, graph);
   default:
@@ -529,18 +876,22 @@ oms_status_enu_t oms::AlgLoop::solveAlgLoop(System& syst, DirectedGraph& graph)
  */
 oms_status_enu_t oms::AlgLoop::fixPointIteration(System& syst, DirectedGraph& graph)
 {
-  const int size = SCC.connections.size();
+  const int size = SCC.tearSize;
   const int maxIterations = Flags::MaxLoopIteration();
   int it=0;
   double maxRes;
   double *res = new double[size]();
+  std::vector<double> outputs(size);
+
+  // start from previous solutions if available
+  bool initialGuess = extrapolateSolution(syst.getTime(), res);
 
   do
   {
     std::stringstream ss;
     it++;
     // get old values
-    for (int i=0; i<size; ++i)
+    for (int i=0; i<size && !initialGuess; ++i)
     {
       int output = SCC.connections[i].first;
       if (oms_status_ok != syst.getReal(graph.getNodes()[output].getName(), res[i]))
@@ -549,6 +900,7 @@ oms_status_enu_t oms::AlgLoop::fixPointIteration(System& syst, DirectedGraph& gr
         return oms_status_error;
       }
     }
+    initialGuess = false;
 
     // update inputs
     for (int i=0; i<size; ++i)
@@ -560,6 +912,11 @@ oms_status_enu_t oms::AlgLoop::fixPointIteration(System& syst, DirectedGraph& gr
         return oms_status_error;
       }
     }
+    if (oms_status_ok != evaluateTornConnections(syst, graph))
+    {
+      delete[] res;
+      return oms_status_error;
+    }
 
     if (Flags::DumpAlgLoops())
     {
@@ -585,6 +942,7 @@ oms_status_enu_t oms::AlgLoop::fixPointIteration(System& syst, DirectedGraph& gr
         return oms_status_error;
       }
       res[i] -= value;
+      outputs[i] = value;
 
       if (Flags::DumpAlgLoops())
         ss << "  " << graph.getNodes()[output].getName().c_str() << ": " << value << std::endl;
@@ -609,10 +967,278 @@ oms_status_enu_t oms::AlgLoop::fixPointIteration(System& syst, DirectedGraph& gr
   {
     return logError("max. number of iterations (" + std::to_string(maxIterations) + ") exceeded at time = " + std::to_string(syst.getTime()));
   }
+  storeSolution(syst.getTime(), outputs.data());
   logDebug("CompositeModel::solveAlgLoop: maxRes: " + std::to_string(maxRes) + ", iterations: " + std::to_string(it) + " at time = " + std::to_string(syst.getTime()));
   return oms_status_ok;
 }
 
+/**
+ * @brief Anderson-accelerated fixed-point-iteration to solve algebraic loop.
+ *
+ * The loop is written as fixed point u = g(u) of the tear variables, where
+ * g maps the loop inputs to the connected outputs. Each iterate combines
+ * the last g(u) with the differences of up to Flags::AndersonDepth()
+ * previous iterates, such that the linearized residual f = g(u) - u is
+ * minimized in the least-squares sense. A depth of 0 gives the plain
+ * fixed-point-iteration.
+ *
+ * @param syst
+ * @param graph
+ * @return oms_status_enu_t
+ */
+oms_status_enu_t oms::AlgLoop::andersonIteration(System& syst, DirectedGraph& graph)
+{
+  const int size = SCC.tearSize;
+  const int maxIterations = Flags::MaxLoopIteration();
+  const int depth = std::min(static_cast<int>(Flags::AndersonDepth()), size);
+  int it=0;
+  double maxRes;
+
+  std::vector<double> u(size), g(size), f(size), gPrev(size), fPrev(size);
+  std::vector<double> dG(depth*size), dF(depth*size); // differences of iterate l are dG[l*size..(l+1)*size-1]
+  std::vector<double> A(depth*depth), b(depth);
+  int nHistory = 0;
+  int next = 0;
+
+  // initial guess, from previous solutions if available
+  if (!extrapolateSolution(syst.getTime(), u.data()))
+  {
+    for (int i=0; i<size; ++i)
+    {
+      int output = SCC.connections[i].first;
+      if (oms_status_ok != syst.getReal(graph.getNodes()[output].getName(), u[i]))
+        return oms_status_error;
+    }
+  }
+
+  do
+  {
+    std::stringstream ss;
+    it++;
+
+    // update inputs
+    for (int i=0; i<size; ++i)
+    {
+      int input = SCC.connections[i].second;
+      if (oms_status_ok != syst.setReal(graph.getNodes()[input].getName(), u[i]))
+        return oms_status_error;
+    }
+    if (oms_status_ok != evaluateTornConnections(syst, graph))
+      return oms_status_error;
+
+    // evaluate g(u) and residuals
+    maxRes = 0.0;
+    for (int i=0; i<size; ++i)
+    {
+      int output = SCC.connections[i].first;
+      if (oms_status_ok != syst.getReal(graph.getNodes()[output].getName(), g[i]))
+        return oms_status_error;
+      f[i] = g[i] - u[i];
+      if (fabs(f[i]) > maxRes)
+        maxRes = fabs(f[i]);
+    }
+
+    if (Flags::DumpAlgLoops())
+    {
+      ss << "iteration " << std::to_string(it) << std::endl;
+      ss << "inputs:" << std::endl;
+      for (int i=0; i<size; ++i)
+        ss << "  " << graph.getNodes()[SCC.connections[i].second].getName().c_str() << ": " << u[i] << std::endl;
+      ss << "outputs:" << std::endl;
+      for (int i=0; i<size; ++i)
+        ss << "  " << graph.getNodes()[SCC.connections[i].first].getName().c_str() << ": " << g[i] << std::endl;
+      ss << "residuals:" << std::endl;
+      for (int i=0; i<size; ++i)
+        ss << "  res[" << i << "]: " << -f[i] << std::endl;
+      logInfo(ss.str());
+    }
+
+    if (maxRes <= relativeTolerance)
+      break;
+
+    // update the history
+    if (depth > 0 && it > 1)
+    {
+      for (int i=0; i<size; ++i)
+      {
+        dF[next*size + i] = f[i] - fPrev[i];
+        dG[next*size + i] = g[i] - gPrev[i];
+      }
+      next = (next + 1) % depth;
+      nHistory = std::min(nHistory + 1, depth);
+    }
+    fPrev = f;
+    gPrev = g;
+
+    // next iterate u = g - dG*gamma with gamma = argmin |f - dF*gamma|
+    u = g;
+    if (nHistory > 0)
+    {
+      // normal equations, slightly regularized
+      double trace = 0.0;
+      for (int k=0; k<nHistory; ++k)
+      {
+        b[k] = 0.0;
+        for (int i=0; i<size; ++i)
+          b[k] += dF[k*size + i] * f[i];
+        for (int l=0; l<nHistory; ++l)
+        {
+          A[k*nHistory + l] = 0.0;
+          for (int i=0; i<size; ++i)
+            A[k*nHistory + l] += dF[k*size + i] * dF[l*size + i];
+        }
+        trace += A[k*nHistory + k];
+      }
+      for (int k=0; k<nHistory; ++k)
+        A[k*nHistory + k] += 1e-12 * trace + 1e-300;
+
+      // Gaussian elimination with partial pivoting
+      bool singular = false;
+      for (int k=0; k<nHistory && !singular; ++k)
+      {
+        int pivot = k;
+        for (int r=k+1; r<nHistory; ++r)
+          if (fabs(A[r*nHistory + k]) > fabs(A[pivot*nHistory + k]))
+            pivot = r;
+        if (A[pivot*nHistory + k] == 0.0)
+        {
+          singular = true;
+          break;
+        }
+        if (pivot != k)
+        {
+          for (int l=0; l<nHistory; ++l)
+            std::swap(A[k*nHistory + l], A[pivot*nHistory + l]);
+          std::swap(b[k], b[pivot]);
+        }
+        for (int r=k+1; r<nHistory; ++r)
+        {
+          const double factor = A[r*nHistory + k] / A[k*nHistory + k];
+          for (int l=k; l<nHistory; ++l)
+            A[r*nHistory + l] -= factor * A[k*nHistory + l];
+          b[r] -= factor * b[k];
+        }
+      }
+
+      if (singular)
+      {
+        // restart the acceleration with a plain fixed-point step
+        nHistory = 0;
+        next = 0;
+      }
+      else
+      {
+        for (int k=nHistory-1; k>=0; --k)
+        {
+          for (int l=k+1; l<nHistory; ++l)
+            b[k] -= A[k*nHistory + l] * b[l];
+          b[k] /= A[k*nHistory + k];
+        }
+        for (int k=0; k<nHistory; ++k)
+          for (int i=0; i<size; ++i)
+            u[i] -= dG[k*size + i] * b[k];
+      }
+    }
+  } while(it < maxIterations);
+
+  if (maxRes > relativeTolerance)
+  {
+    return logError("max. number of iterations (" + std::to_string(maxIterations) + ") exceeded at time = " + std::to_string(syst.getTime()));
+  }
+  storeSolution(syst.getTime(), g.data());
+  logDebug("CompositeModel::solveAlgLoop: maxRes: " + std::to_string(maxRes) + ", iterations: " + std::to_string(it) + " at time = " + std::to_string(syst.getTime()));
+  return oms_status_ok;
+}
+
+/**
+ * @brief Evaluate the connections of a torn loop that aren't iteration variables.
+ *
+ * @param syst
+ * @param graph
+ * @return oms_status_enu_t
+ */
+oms_status_enu_t oms::AlgLoop::evaluateTornConnections(System& syst, DirectedGraph& graph)
+{
+  double value;
+  for (size_t i=SCC.tearSize; i<SCC.connections.size(); ++i)
+  {
+    if (oms_status_ok != syst.getReal(graph.getNodes()[SCC.connections[i].first].getName(), value))
+      return oms_status_error;
+    if (oms_status_ok != syst.setReal(graph.getNodes()[SCC.connections[i].second].getName(), value))
+      return oms_status_error;
+  }
+  return oms_status_ok;
+}
+
+/**
+ * @brief Initial guess for the loop from previous solutions.
+ *
+ * Extrapolates the last converged solutions with a polynomial of order
+ * Flags::AlgLoopExtrapolation() (or lower, if fewer solutions are known)
+ * to the given time.
+ *
+ * @param time     Time of the next solve
+ * @param u        Initial guess for the inputs of the loop
+ * @return true    if an initial guess was computed
+ */
+bool oms::AlgLoop::extrapolateSolution(double time, double* u) const
+{
+  const int size = SCC.tearSize;
+  const int n = static_cast<int>(solutionTimes.size());
+  if (n == 0 || Flags::AlgLoopExtrapolation() == 0 || time < solutionTimes.back())
+    return false;
+
+  if (time == solutionTimes.back())
+  {
+    std::copy(solutions.back().begin(), solutions.back().end(), u);
+    return true;
+  }
+
+  // Lagrange polynomial through the last min(order+1, n) solutions
+  const int m = std::min(static_cast<int>(Flags::AlgLoopExtrapolation()) + 1, n);
+  std::fill(u, u + size, 0.0);
+  for (int k = n - m; k < n; ++k)
+  {
+    double weight = 1.0;
+    for (int l = n - m; l < n; ++l)
+      if (l != k)
+        weight *= (time - solutionTimes[l]) / (solutionTimes[k] - solutionTimes[l]);
+    for (int i = 0; i < size; ++i)
+      u[i] += weight * solutions[k][i];
+  }
+  return true;
+}
+
+/**
+ * @brief Remember a converged solution of the loop.
+ *
+ * @param time     Time of the solution
+ * @param u        Inputs of the loop
+ */
+void oms::AlgLoop::storeSolution(double time, const double* u)
+{
+  const int size = SCC.tearSize;
+  const size_t maxSolutions = Flags::AlgLoopExtrapolation() + 1;
+  if (Flags::AlgLoopExtrapolation() == 0)
+    return;
+
+  // the history is invalid after going back in time, e.g. by a rollback
+  while (!solutionTimes.empty() && solutionTimes.back() >= time)
+  {
+    solutionTimes.pop_back();
+    solutions.pop_back();
+  }
+
+  while (solutionTimes.size() >= maxSolutions)
+  {
+    solutionTimes.erase(solutionTimes.begin());
+    solutions.erase(solutions.begin());
+  }
+
+  solutionTimes.push_back(time);
+  solutions.push_back(std::vector<double>(u, u + size));
+}
+
 /**
  * @brief Return solver method
  *
@@ -626,6 +1252,8 @@ std::string oms::AlgLoop::getAlgSolverName(void)
     return "None";
   case oms_alg_solver_fixedpoint:
     return "Fixed-Point-Iteration";
+  case oms_alg_solver_anderson:
+    return "Anderson-Accelerated-Fixed-Point-Iteration";
   case oms_alg_solver_kinsol:
     return "KINSOL";
   default:
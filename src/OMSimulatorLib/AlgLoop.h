@@ -36,6 +36,7 @@
 #include <vector>
 #include "OMSimulator/Types.h"
 #include "DirectedGraph.h"
+#include "SparsityPattern.h"
 
 #include <kinsol/kinsol.h>
 #include <nvector/nvector_serial.h>
@@ -45,12 +46,15 @@ namespace oms
 {
   class System;
   class DirectedGraph;
+  class Component;
+  class KinsolSolver;
 
   typedef struct KINSOL_USER_DATA {
     System*         syst;
     DirectedGraph*  graph;
     const int       algLoopNumber;
     unsigned int    iteration;
+    KinsolSolver*   solver;
   }KINSOL_USER_DATA;
 
   class KinsolSolver
@@ -75,12 +79,57 @@ namespace oms
     void* user_data;
     int size;
 
+    /* Jacobian data */
+    bool useDirectionalDerivative;
+    bool jacobianCurrent = false; ///< the factorized Jacobian of the last solve can be reused by the next one
+    bool jacobianReused = false;  ///< the current solve started with the Jacobian of the previous one
+    SparsityPattern pattern;  ///< structure of the loop Jacobian, columns are colored for compressed evaluation
+
+    /**
+     * @brief Directional derivatives of one component for one color of the loop Jacobian.
+     *
+     * All seeded columns of a color belong to different rows, so the
+     * Jacobian entries can be read back from a single call.
+     */
+    struct JacobianGroup_t
+    {
+      Component* component;
+      int index;                     ///< directional derivative prepared in the component
+      std::vector<double> seed;
+      std::vector<double> values;
+      std::vector<int> rows;         ///< row of the Jacobian entry of values[k]
+      std::vector<int> columns;      ///< column of the Jacobian entry of values[k]
+    };
+    std::vector<JacobianGroup_t> jacobianGroups;
+
+    /**
+     * @brief Loop signals of one FMU, set or read with a single call.
+     */
+    struct LoopSignals_t
+    {
+      Component* component;    ///< NULL for signals that are accessed by name through the system
+      int index;               ///< signals prepared in the component
+      std::vector<int> positions; ///< position of each signal in u or F(u)
+      std::vector<ComRef> crefs;  ///< names relative to the system, only used if component is NULL
+      std::vector<double> buffer;
+    };
+    std::vector<LoopSignals_t> loopInputs;
+    std::vector<LoopSignals_t> loopOutputs;
+    std::vector<LoopSignals_t> innerInputs;   ///< inputs of the connections of a torn loop that are evaluated in sequence
+    std::vector<LoopSignals_t> innerOutputs;  ///< outputs of the connections of a torn loop that are evaluated in sequence
+
     /* linear solver data */
     SUNLinearSolver linSol; /* Linear solver object used by KINSOL */
     N_Vector y;             /* Template for cloning vectors needed inside linear solver */
     SUNMatrix J;            /* (Non-)Sparse matrix template for cloning matrices needed within linear solver */
 
     /* member function */
+    oms_status_enu_t initializeJacobian(System& syst, DirectedGraph& graph, const scc_t& SCC);
+    oms_status_enu_t initializeLoopSignals(System& syst, DirectedGraph& graph, const scc_t& SCC);
+    static oms_status_enu_t setLoopSignals(System& syst, LoopSignals_t& group, const double* u);
+    static oms_status_enu_t getLoopSignals(System& syst, LoopSignals_t& group, double* y);
+    static oms_status_enu_t setLoopInputs(System& syst, std::vector<LoopSignals_t>& signals, const double* u);
+    static oms_status_enu_t getLoopOutputs(System& syst, std::vector<LoopSignals_t>& signals, double* y);
     static int nlsKinsolJac(N_Vector u, N_Vector fu, SUNMatrix J, void *user_data, N_Vector tmp1, N_Vector tmp2);
     static int nlsKinsolResiduals(N_Vector u, N_Vector fval, void *user_data);
     static void sundialsErrorHandlerFunction(int error_code, const char *module, const char *function, char *msg, void *user_data);
@@ -92,14 +141,19 @@ namespace oms
   public:
     AlgLoop(oms_alg_solver_enu_t method, double relativeTolerance, scc_t SCC, const int systNumber, const bool useDirectionalDerivative);
 
-    scc_t getSCC() {return SCC;}
+    const scc_t& getSCC() const {return SCC;}
     oms_status_enu_t solveAlgLoop(System& syst, DirectedGraph& graph);
     std::string getAlgSolverName();
     std::string dumpLoopVars(DirectedGraph& graph);
 
+    bool extrapolateSolution(double time, double* u) const;
+    void storeSolution(double time, const double* u);
+
   private:
     oms_alg_solver_enu_t algSolverMethod;
     oms_status_enu_t fixPointIteration(System& syst, DirectedGraph& graph);
+    oms_status_enu_t andersonIteration(System& syst, DirectedGraph& graph);
+    oms_status_enu_t evaluateTornConnections(System& syst, DirectedGraph& graph);
 
     KinsolSolver* kinsolData;
 
@@ -107,6 +161,10 @@ namespace oms
     const scc_t SCC;            ///< Strong connected components
     const int systNumber;
     double relativeTolerance;
+
+    /* Converged solutions of previous solves, oldest first */
+    std::vector<double> solutionTimes;
+    std::vector<std::vector<double>> solutions;
   };
 }
 
@@ -33,6 +33,7 @@
 
 #include "Flags.h"
 #include "Logging.h"
+#include "OMSFileSystem.h"
 #include "ResultWriter.h"
 
 #include <cstring>  // strerror
@@ -81,6 +82,34 @@ bool oms::CSVWriter::createFile(const std::string& filename, double startTime, d
   return true;
 }
 
+bool oms::CSVWriter::resumeFile(const std::string& filename, long position)
+{
+  if (pFile)
+    return false;
+
+  std::error_code ec;
+  filesystem::resize_file(filename, position, ec);
+  if (ec)
+  {
+    logError("CSVWriter::resumeFile: " + ec.message());
+    return false;
+  }
+
+  pFile = fopen(filename.c_str(), "a");
+  if (!pFile)
+  {
+    logError("CSVWriter::resumeFile: " + std::string(strerror(errno)));
+    return false;
+  }
+
+  return true;
+}
+
+long oms::CSVWriter::tellFile()
+{
+  return pFile ? ftell(pFile) : 0;
+}
+
 void oms::CSVWriter::closeFile()
 {
   if (!pFile)
@@ -0,0 +1,153 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+
+#include "Checkpoint.h"
+
+#include "Logging.h"
+#include "OMSFileSystem.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+static const char checkpointMagic[8] = {'O', 'M', 'S', 'C', 'K', 'P', 'T', '1'};
+
+oms::Checkpoint::Checkpoint()
+{
+}
+
+oms::Checkpoint::~Checkpoint()
+{
+}
+
+/**
+ * @brief Writes the checkpoint to a temporary file first and renames it
+ * afterwards, so that an interrupted write doesn't destroy the previous
+ * checkpoint.
+ */
+oms_status_enu_t oms::Checkpoint::save(const std::string& filename) const
+{
+  const std::string tempFilename = filename + ".tmp";
+
+  std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+  if (!file)
+    return logError("Failed to open checkpoint file \"" + tempFilename + "\" for writing");
+
+  const uint64_t size = data.size();
+  file.write(checkpointMagic, sizeof(checkpointMagic));
+  file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+  file.write(data.data(), data.size());
+  file.close();
+  if (!file)
+    return logError("Failed to write checkpoint file \"" + tempFilename + "\"");
+
+  std::error_code ec;
+  filesystem::rename(tempFilename, filename, ec);
+  if (ec)
+    return logError("Failed to rename \"" + tempFilename + "\" to \"" + filename + "\": " + ec.message());
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::Checkpoint::load(const std::string& filename)
+{
+  std::ifstream file(filename, std::ios::binary);
+  if (!file)
+    return logError("Failed to open checkpoint file \"" + filename + "\"");
+
+  char magic[sizeof(checkpointMagic)];
+  uint64_t size = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char*>(&size), sizeof(size));
+  if (!file || memcmp(magic, checkpointMagic, sizeof(magic)) != 0)
+    return logError("\"" + filename + "\" isn't a valid checkpoint file");
+
+  data.resize(size);
+  file.read(data.data(), size);
+  if (!file)
+    return logError("Checkpoint file \"" + filename + "\" is truncated");
+
+  position = 0;
+  return oms_status_ok;
+}
+
+void oms::Checkpoint::writeBytes(const void* bytes, size_t size)
+{
+  const char* first = static_cast<const char*>(bytes);
+  data.insert(data.end(), first, first + size);
+}
+
+/**
+ * @brief Writes the size followed by the bytes, e.g. a serialized FMU state.
+ */
+void oms::Checkpoint::writeBlock(const void* bytes, size_t size)
+{
+  writeValue<uint64_t>(size);
+  writeBytes(bytes, size);
+}
+
+void oms::Checkpoint::writeString(const std::string& value)
+{
+  writeBlock(value.data(), value.size());
+}
+
+bool oms::Checkpoint::readBytes(void* bytes, size_t size)
+{
+  if (size > data.size() - position)
+    return false;
+
+  memcpy(bytes, data.data() + position, size);
+  position += size;
+  return true;
+}
+
+bool oms::Checkpoint::readBlock(std::vector<char>& bytes)
+{
+  uint64_t size;
+  if (!readValue(size) || size > data.size() - position)
+    return false;
+
+  bytes.assign(data.data() + position, data.data() + position + size);
+  position += size;
+  return true;
+}
+
+bool oms::Checkpoint::readString(std::string& value)
+{
+  uint64_t size;
+  if (!readValue(size) || size > data.size() - position)
+    return false;
+
+  value.assign(data.data() + position, size);
+  position += size;
+  return true;
+}
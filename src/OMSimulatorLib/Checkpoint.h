@@ -0,0 +1,81 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+
+#ifndef _OMS_CHECKPOINT_H_
+#define _OMS_CHECKPOINT_H_
+
+#include "OMSimulator/Types.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace oms
+{
+  /**
+   * @brief Binary buffer of a model checkpoint, see Model::saveCheckpoint().
+   *
+   * The data is written and read back in the same order by the systems and
+   * components. The file format isn't portable between platforms, since
+   * values are stored in their native representation.
+   */
+  class Checkpoint
+  {
+  public:
+    Checkpoint();
+    ~Checkpoint();
+
+    oms_status_enu_t save(const std::string& filename) const;
+    oms_status_enu_t load(const std::string& filename);
+
+    void writeBytes(const void* bytes, size_t size);
+    void writeBlock(const void* bytes, size_t size);
+    void writeString(const std::string& value);
+    template<typename T> void writeValue(const T& value) {writeBytes(&value, sizeof(T));}
+
+    bool readBytes(void* bytes, size_t size);
+    bool readBlock(std::vector<char>& bytes);
+    bool readString(std::string& value);
+    template<typename T> bool readValue(T& value) {return readBytes(&value, sizeof(T));}
+
+  private:
+    // stop the compiler generating methods copying the object
+    Checkpoint(Checkpoint const& copy);            ///< not implemented
+    Checkpoint& operator=(Checkpoint const& copy); ///< not implemented
+
+  private:
+    std::vector<char> data;
+    size_t position = 0; ///< read position
+  };
+}
+
+#endif
@@ -34,6 +34,7 @@
 #include "Flags.h"
 #include "Model.h"
 #include "OMSFileSystem.h"
+#include "Scope.h"
 #include "System.h"
 
 #include <cstring>
@@ -146,6 +147,21 @@ oms::Model& oms::Component::getModel() const
   return parentSystem->getModel();
 }
 
+/**
+ * @brief Returns the component with the same name in the model that is being
+ * cloned, or NULL if the model isn't a clone that is currently imported.
+ */
+oms::Component* oms::Component::getCloneSource() const
+{
+  Model* source = getModel().getCloneSource();
+  if (!source)
+    return NULL;
+
+  ComRef tail(getFullCref());
+  tail.pop_front();
+  return source->getComponent(tail);
+}
+
 oms::Connector* oms::Component::getConnector(const ComRef& cref)
 {
   for (auto &connector : connectors)
@@ -183,3 +199,59 @@ oms_status_enu_t oms::Component::rename(const oms::ComRef& newCref)
   this->renameValues(oldCref, newCref); // rename values in ssv files (only for FMUs)
   return oms_status_ok;
 }
+
+/**
+ * @brief Copies the FMU to the resources of the model and unpacks it.
+ *
+ * Instances of the same FMU, i.e. with the same GUID, share the resource
+ * file of the first instance in the system.
+ */
+oms_status_enu_t oms::Component::unpackFMU(const std::string& guid, const std::string& fmuFile, const Component* source)
+{
+  // a clone uses the FMU that is already unpacked for its source component
+  if (source)
+  {
+    setTempDir(source->getTempDir());
+    return oms_status_ok;
+  }
+
+  filesystem::path temp_root(getModel().getTempDirectory());
+  filesystem::path relFMUPath(path);
+
+  /*
+   * check if instance of an fmu already exist by using guid of the fmu
+   * if instance exist use the existing instance path
+   * eg: tank1 => resources /0001_tank1.fmu
+   *     tank2 => resources /0001_tank1.fmu
+  */
+  auto it = parentSystem->fmuGuid.find(guid);
+  if (it == parentSystem->fmuGuid.end())
+    parentSystem->fmuGuid[guid] = relFMUPath;
+  else
+  {
+    // instance exists and update the FMU path to already existing instance
+    relFMUPath = it->second;
+    setPath(relFMUPath.generic_string());
+  }
+
+  // Copy the resource to the temp directory of the model? We don't want have
+  // to copy resources if importing an SSP file or snapshot.
+  filesystem::path absFMUPath = temp_root / relFMUPath;
+  if (parentSystem->copyResources() && !filesystem::exists(absFMUPath))
+    oms_copy_file(filesystem::path(fmuFile), absFMUPath);
+
+  // set temp directory
+  filesystem::path tempDir = temp_root / "temp" / relFMUPath.stem();
+  setTempDir(tempDir.string());
+
+  if (!filesystem::is_directory(tempDir))
+  {
+    if (!filesystem::create_directory(tempDir))
+      return logError("Creating temp directory for component \"" + std::string(cref) + "\" failed");
+  }
+
+  // unpack the fmu in temp directory
+  oms::Scope::miniunz(filesystem::path(fmuFile).generic_string().c_str(), tempDir.generic_string().c_str());
+
+  return oms_status_ok;
+}
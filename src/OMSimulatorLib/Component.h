@@ -32,6 +32,7 @@
 #ifndef _OMS_COMPONENT_H_
 #define _OMS_COMPONENT_H_
 
+#include "Checkpoint.h"
 #include "Clock.h"
 #include "ComRef.h"
 #include "Connector.h"
@@ -77,6 +78,7 @@ namespace oms
     virtual Variable* getVariable(const ComRef& cref) = 0;
 
     virtual bool getCanGetAndSetState() { return false; }
+    virtual bool getCanSerializeState() { return false; }
     virtual const FMUInfo* getFMUInfo() const { return nullptr; }
     virtual oms_status_enu_t deleteStartValue(const ComRef& cref) { return oms_status_ok; }
     virtual std::vector<Values> getValuesResources() { return{}; }
@@ -92,11 +94,24 @@ namespace oms
     virtual oms_status_enu_t getString(const ComRef& cref, std::string& value) { return logError_NotImplemented; }
     virtual oms_status_enu_t getRealOutputDerivative(const ComRef& cref, SignalDerivative& der) { return logError_NotImplemented; }
     virtual oms_status_enu_t getDirectionalDerivative(const ComRef& unknownCref, const ComRef& knownCref, double& value) { return logError_NotImplemented; }
+    /// resolves the value references of unknowns and knowns once; index identifies them in getDirectionalDerivative(index, seed, values)
+    virtual oms_status_enu_t prepareDirectionalDerivative(const std::vector<ComRef>& unknownCrefs, const std::vector<ComRef>& knownCrefs, int& index) { return logError_NotImplemented; }
+    virtual oms_status_enu_t getDirectionalDerivative(int index, const double* seed, double* values) { return logError_NotImplemented; }
+    /// resolves the value references of real signals once; index identifies them in getRealSignals() and setRealSignals()
+    virtual oms_status_enu_t prepareRealSignals(const std::vector<ComRef>& crefs, int& index) { return logError_NotImplemented; }
+    virtual oms_status_enu_t getRealSignals(int index, double* values) { return logError_NotImplemented; }
+    virtual oms_status_enu_t setRealSignals(int index, const double* values) { return logError_NotImplemented; }
     virtual oms_status_enu_t restoreState() { return logError_NotImplemented; }
     virtual oms_status_enu_t saveState() { return logError_NotImplemented; }
+    /// writes the complete internal state to a checkpoint, restored by deserializeState()
+    virtual oms_status_enu_t serializeState(Checkpoint& checkpoint) { return logError_NotImplemented; }
+    virtual oms_status_enu_t deserializeState(Checkpoint& checkpoint) { return logError_NotImplemented; }
     virtual oms_status_enu_t setBoolean(const ComRef& cref, bool value) { return logError_NotImplemented; }
     virtual oms_status_enu_t setInteger(const ComRef& cref, int value) { return logError_NotImplemented; }
     virtual oms_status_enu_t setReal(const ComRef& cref, double value) { return logError_NotImplemented; }
+    /// FMI 3.0 array variables, transferred as a whole
+    virtual oms_status_enu_t getRealArray(const ComRef& cref, double* values, size_t size) { return logError_NotImplemented; }
+    virtual oms_status_enu_t setRealArray(const ComRef& cref, const double* values, size_t size) { return logError_NotImplemented; }
     virtual oms_status_enu_t setString(const ComRef& cref, const std::string& value) { return logError_NotImplemented; }
     virtual oms_status_enu_t setUnit(const ComRef& cref, const std::string& value) { return logError_NotImplemented; }
     virtual oms_status_enu_t setRealInputDerivative(const ComRef& cref, const SignalDerivative& der) { return logError_NotImplemented; }
@@ -108,6 +123,24 @@ namespace oms
     virtual oms_status_enu_t deleteReferencesInSSD(const std::string& filename) {return logError_NotImplemented;}
     virtual oms_status_enu_t deleteResourcesInSSP(const std::string& filename) {return logError_NotImplemented;}
 
+    // model exchange, used by SystemSC
+    virtual size_t getNumberOfContinuousStates() const { return 0; }
+    virtual size_t getNumberOfEventIndicators() const { return 0; }
+    virtual oms_status_enu_t getContinuousStates(double* states) { return logError_NotImplemented; }
+    virtual oms_status_enu_t setContinuousStates(double* states) { return logError_NotImplemented; }
+    virtual oms_status_enu_t getDerivatives(double* derivatives) { return logError_NotImplemented; }
+    virtual oms_status_enu_t getNominalsOfContinuousStates(double* nominals) { return logError_NotImplemented; }
+    virtual oms_status_enu_t getEventindicators(double* eventindicators) { return logError_NotImplemented; }
+    /// directional derivative of all state derivatives with respect to the given continuous states
+    virtual oms_status_enu_t getStateDirectionalDerivative(const int* states, size_t nStates, const double* seed, double* values) { return logError_NotImplemented; }
+    virtual oms_status_enu_t completedIntegratorStep(fmi2Boolean& callEventUpdate, fmi2Boolean& terminateSimulation) { return logError_NotImplemented; }
+    virtual oms_status_enu_t enterEventMode() { return logError_NotImplemented; }
+    virtual oms_status_enu_t enterContinuousTimeMode() { return logError_NotImplemented; }
+    virtual oms_status_enu_t doEventIteration() { return logError_NotImplemented; }
+    virtual fmi2EventInfo* getEventInfo() { return nullptr; }
+    virtual void getStateDerivativeDependencies(size_t k, std::vector<unsigned int>& stateDependencies, std::vector<ComRef>& inputDependencies) const { }
+    virtual oms_status_enu_t getOutputDependencies(const ComRef& output, std::vector<unsigned int>& stateDependencies, std::vector<ComRef>& inputDependencies) const { return logError_NotImplemented; }
+
     const ComRef& getCref() const { return cref; }
     ComRef getFullCref() const;
     Element* getElement() { return &element; }
@@ -122,6 +155,7 @@ namespace oms
     oms_component_enu_t getType() const { return type; }
     System* getParentSystem() const { return parentSystem; }
     Model& getModel() const;
+    Component* getCloneSource() const;
     void setGeometry(const ssd::ElementGeometry& geometry) { element.setGeometry(&geometry); }
 
     const DirectedGraph& getInitialUnknownsGraph() { return initialUnknownsGraph; }
@@ -140,6 +174,9 @@ namespace oms
 
     virtual oms_status_enu_t renameValues(const ComRef& oldCref, const ComRef& newCref) { return oms_status_ok; }
 
+    /// shares the FMU file between instances with the same GUID and unpacks it to the temp directory of the component
+    oms_status_enu_t unpackFMU(const std::string& guid, const std::string& fmuFile, const Component* source = NULL);
+
   protected:
     DirectedGraph initialUnknownsGraph;
     DirectedGraph outputsGraph;
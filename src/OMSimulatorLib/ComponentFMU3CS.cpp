@@ -75,10 +75,7 @@ oms::Component* oms::ComponentFMU3CS::NewComponent(const oms::ComRef& cref, oms:
   }
   // replaceComponent string will be used to avoid name conflicts when replacing a fmu with oms_replaceSubModel(), the default is ""
 
-  filesystem::path temp_root(parentSystem->getModel().getTempDirectory());
-  filesystem::path temp_temp = temp_root / "temp";
   filesystem::path relFMUPath = parentSystem->copyResources() ? (filesystem::path("resources") / (parentSystem->getUniqueID() + "_" + replaceComponent + std::string(cref) + ".fmu")) : filesystem::path(fmuPath);
-  filesystem::path absFMUPath = temp_root / relFMUPath;
 
   ComponentFMU3CS* component = new ComponentFMU3CS(cref, parentSystem, relFMUPath.generic_string());
 
@@ -96,50 +93,21 @@ oms::Component* oms::ComponentFMU3CS::NewComponent(const oms::ComRef& cref, oms:
   else
     modelDescriptionPath = parentSystem->getModel().getTempDirectory() / filesystem::path(fmuPath);
 
-  component->values.parseModelDescriptionFmi3(modelDescriptionPath, guid_);
-
-  /*
-   * check if instance of an fmu already exist by using guid of the fmu
-   * if instance exist use the existing instance path
-   * eg: tank1 => resources /0001_tank1.fmu
-   *     tank2 => resources /0001_tank1.fmu
-  */
-  auto it = parentSystem->fmuGuid.find(guid_);
-  if (it == parentSystem->fmuGuid.end())
-    parentSystem->fmuGuid[guid_] = relFMUPath;
+  // a clone takes over the parsed modelDescription.xml and the unpacked fmu of its source component
+  const ComponentFMU3CS* source = dynamic_cast<const ComponentFMU3CS*>(component->getCloneSource());
+  if (source)
+    component->values.copyModelDescription(source->values);
   else
-  {
-    // instance exists and update the FMU path to already existing instance
-    relFMUPath = parentSystem->fmuGuid[guid_];
-    absFMUPath = temp_root / relFMUPath;
-    component->setPath(relFMUPath.generic_string());
-  }
-
-  // Copy the resource to the temp directory of the model? We don't want have
-  // to copy resources if importing an SSP file or snapshot.
-  if (parentSystem->copyResources() && !filesystem::exists(absFMUPath))
-    oms_copy_file(filesystem::path(fmuPath), absFMUPath);
+    component->values.parseModelDescriptionFmi3(modelDescriptionPath, guid_);
 
-  // set temp directory
-  filesystem::path tempDir = temp_temp / relFMUPath.stem();
-  component->setTempDir(tempDir.string());
-
-  bool dirExist = true;
-  if (!filesystem::is_directory(tempDir))
+  if (oms_status_ok != component->unpackFMU(guid_, modelDescriptionPath.string(), source))
   {
-    dirExist = false;
-    if (!filesystem::create_directory(tempDir))
-    {
-      logError("Creating temp directory for component \"" + std::string(cref) + "\" failed");
-      return NULL;
-    }
+    delete component;
+    return NULL;
   }
 
-  // unpack the fmu in temp directory
-  oms::Scope::miniunz(modelDescriptionPath.generic_string().c_str(), tempDir.generic_string().c_str());
-
   // load the unpacked fmu and parse modelDescription.xml
-  component->fmu = fmi4c_loadUnzippedFmu(cref.c_str(), tempDir.generic_string().c_str());
+  component->fmu = fmi4c_loadUnzippedFmu(cref.c_str(), filesystem::path(component->getTempDir()).generic_string().c_str());
   if (!component->fmu)
   {
     logError("Error parsing modelDescription.xml");
@@ -182,6 +150,11 @@ oms::Component* oms::ComponentFMU3CS::NewComponent(const oms::ComRef& cref, oms:
       return NULL;
     }
 
+    // mark derivatives
+    auto derivative = component->values.modelDescriptionDerivatives.find(v.getValueReferenceFMI3());
+    if (derivative != component->values.modelDescriptionDerivatives.end())
+      v.markAsDer(derivative->second);
+
     // extract continuous-time derivatives
     if (v.isContinuousTimeDer())
       component->derivatives.push_back(v.getIndex());
@@ -190,24 +163,42 @@ oms::Component* oms::ComponentFMU3CS::NewComponent(const oms::ComRef& cref, oms:
     component->exportVariables.push_back(true);
   }
 
-  // mark states and continuous-time states
+  // mark states and continuous-time states; derivatives refer to their state by value reference
+  std::unordered_map<fmi3ValueReference, unsigned int> variableIndices;
+  for (const auto& v : component->allVariables)
+    variableIndices[v.getValueReferenceFMI3()] = v.getIndex();
   for (unsigned int i = 0; i < fmi3_getNumberOfVariables(component->fmu); ++i)
   {
+    if (!component->allVariables[i].isDer())
+      continue;
+
+    auto state = variableIndices.find(static_cast<fmi3ValueReference>(component->allVariables[i].getStateIndex()));
+    if (state == variableIndices.end())
+    {
+      logError("FMU \"" + std::string(cref) + "\": unknown state of derivative " + std::string(component->allVariables[i].getCref()));
+      delete component;
+      return NULL;
+    }
+
     if (component->allVariables[i].isContinuousTimeDer())
-      component->allVariables[component->allVariables[i].getStateIndex()-1].markAsContinuousTimeState(i);
-    else if (component->allVariables[i].isDer())
-      component->allVariables[component->allVariables[i].getStateIndex()-1].markAsState(i);
+      component->allVariables[state->second].markAsContinuousTimeState(i);
+    else
+      component->allVariables[state->second].markAsState(i);
   }
 
   // create some special variable maps
   for (auto const& v : component->allVariables)
   {
+    // arrays with dimensions that depend on structural parameters can't be connected
+    if (0 == v.getArraySize())
+      continue;
+
     if (v.isInput())
       component->inputs.push_back(v.getIndex());
     else if (v.isOutput())
     {
       component->outputs.push_back(v.getIndex());
-      component->outputsGraph.addNode(Connector(oms_causality_output, v.getType(), v.getCref(), component->getFullCref()));
+      component->outputsGraph.addNode(v.makeConnector(component->getFullCref()));
     }
     else if (v.isParameter())
       component->parameters.push_back(v.getIndex());
@@ -215,7 +206,7 @@ oms::Component* oms::ComponentFMU3CS::NewComponent(const oms::ComRef& cref, oms:
       component->calculatedParameters.push_back(v.getIndex());
 
     if (v.isInitialUnknown())
-      component->initialUnknownsGraph.addNode(Connector(v.getCausality(), v.getType(), v.getCref(), component->getFullCref()));
+      component->initialUnknownsGraph.addNode(v.makeConnector(component->getFullCref()));
 
     component->exportVariables.push_back(v.isInput() || v.isOutput());
   }
@@ -238,6 +229,7 @@ oms::Component* oms::ComponentFMU3CS::NewComponent(const oms::ComRef& cref, oms:
     component->connectors.push_back(new Connector(oms_causality_calculatedParameter, component->allVariables[i].getType(), component->allVariables[i].getCref(), component->getFullCref()));
   component->connectors.push_back(NULL);
   component->element.setConnectors(&component->connectors[0]);
+  component->updateConnectorArraySizes();
 
   if (oms_status_ok != component->initializeDependencyGraph_initialUnknowns())
   {
@@ -346,6 +338,7 @@ oms::Component* oms::ComponentFMU3CS::NewComponent(const pugi::xml_node& node, o
 
   component->connectors.push_back(NULL);
   component->element.setConnectors(&component->connectors[0]);
+  component->updateConnectorArraySizes();
 
   return component;
 }
@@ -589,15 +582,14 @@ oms_status_enu_t oms::ComponentFMU3CS::initializeDependencyGraph_outputs()
   return oms_status_ok;
 }
 
-oms_status_enu_t oms::ComponentFMU3CS::instantiate()
+/**
+ * @brief Sets the start values of the SSV resources or inline values in the FMU.
+ *
+ * Called after instantiation and again after fmi reset, which restores the
+ * start values of the modelDescription.xml.
+ */
+void oms::ComponentFMU3CS::applyStartValues()
 {
-  // TODO investigate fmi3IntermediateUpdateCallback = NULL
-  if(!fmi3_instantiateCoSimulation(fmu, fmi3False, fmi3True, fmi3False, fmi3False, NULL, 0, fmu, omsfmi3logger, NULL))
-  {
-    logInfo("fmi3Instantiate() failed");
-    exit(1);
-  }
-
   // set start values from local resources
   if (values.hasResources())
   {
@@ -633,6 +625,19 @@ oms_status_enu_t oms::ComponentFMU3CS::instantiate()
   {
     setResourcesHelper1(values);
   }
+}
+
+oms_status_enu_t oms::ComponentFMU3CS::instantiate()
+{
+  // TODO investigate fmi3IntermediateUpdateCallback = NULL
+  eventModeUsed = Flags::EarlyReturn() && fmuInfo.getHasEventMode();
+  if(!fmi3_instantiateCoSimulation(fmu, fmi3False, fmi3True, eventModeUsed, eventModeUsed, NULL, 0, fmu, omsfmi3logger, NULL))
+  {
+    logInfo("fmi3Instantiate() failed");
+    exit(1);
+  }
+
+  applyStartValues();
   // enterInitialization
   time = getModel().getStartTime();
 
@@ -805,6 +810,10 @@ oms_status_enu_t oms::ComponentFMU3CS::initialize()
 
   if (fmi3OK != status) return logError_FMUCall("fmi3_exitInitializationMode", this);
 
+  // with event mode, the FMU is in event mode after the initialization
+  if (eventModeUsed && oms_status_ok != handleEvent())
+    return oms_status_error;
+
   //logInfo("FMI3 initialization successfull");
 
   return oms_status_ok;
@@ -828,12 +837,15 @@ oms_status_enu_t oms::ComponentFMU3CS::reset()
   if (fmi3OK != fmistatus)
     return logError_ResetFailed(getCref());
 
+  // the fmu is back at the start values of the modelDescription.xml
+  applyStartValues();
+
   // enterInitialization
   time = getModel().getStartTime();
   double relativeTolerance = 0.0;
   dynamic_cast<SystemWC*>(getParentSystem())->getTolerance(&relativeTolerance);
 
-  fmi3Status status_ = fmi3_enterInitializationMode(fmu, fmi3False, relativeTolerance, time, fmi3True, getModel().getStopTime());
+  fmistatus = fmi3_enterInitializationMode(fmu, fmi3False, relativeTolerance, time, fmi3True, getModel().getStopTime());
   if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_enterInitializationMode", this);
 
   return oms_status_ok;
@@ -842,30 +854,100 @@ oms_status_enu_t oms::ComponentFMU3CS::reset()
 oms_status_enu_t oms::ComponentFMU3CS::stepUntil(double stopTime)
 {
   CallClock callClock(clock);
-  System *topLevelSystem = getModel().getTopLevelSystem();
-
-  double hdef = (stopTime-time) / 1.0;
-  bool eventEncountered, terminateSimulation, earlyReturn;
-  double lastT;
 
   while (time < stopTime)
   {
-    fmi3Status status = fmi3_doStep(fmu,  time, hdef, fmi3True, &eventEncountered, &terminateSimulation, &earlyReturn, &lastT);
-    time += hdef;
+    oms_status_enu_t status = stepUntilEvent(stopTime);
+    if (oms_status_ok != status)
+      return status;
 
-    if (status == fmi3Discard)
-    {
-      getModel().setStopTime(time);
-      logInfo("fmi3_doStep discarded for FMU \"" + std::string(getFullCref()) + "\"");
+    // the FMU terminated the simulation at an event
+    if (time < stopTime && time >= getModel().getStopTime())
       return oms_status_ok;
-    }
-    else if (status != fmi3OK)
-      return logError_FMUCall("fmi3_doStep", this);
   }
   time = stopTime;
   return oms_status_ok;
 }
 
+/**
+ * @brief Performs a single fmi3DoStep towards stopTime.
+ *
+ * If the FMU uses event mode, it may return early at an internal event; the
+ * event is handled and the time of the FMU is the event time afterwards.
+ */
+oms_status_enu_t oms::ComponentFMU3CS::stepUntilEvent(double stopTime)
+{
+  CallClock callClock(clock);
+
+  double hdef = stopTime-time;
+  bool eventEncountered = false, terminateSimulation = false, earlyReturn = false;
+  double lastT = stopTime;
+
+  fmi3Status status = fmi3_doStep(fmu,  time, hdef, fmi3True, &eventEncountered, &terminateSimulation, &earlyReturn, &lastT);
+  if (status == fmi3Discard)
+  {
+    time = stopTime;
+    getModel().setStopTime(time);
+    logInfo("fmi3_doStep discarded for FMU \"" + std::string(getFullCref()) + "\"");
+    return oms_status_ok;
+  }
+  else if (status != fmi3OK)
+    return logError_FMUCall("fmi3_doStep", this);
+
+  time = (eventModeUsed && earlyReturn) ? lastT : stopTime;
+
+  if (terminateSimulation)
+  {
+    getModel().setStopTime(time);
+    logInfo("FMU \"" + std::string(getFullCref()) + "\" requested to terminate the simulation at time " + std::to_string(time));
+    return oms_status_ok;
+  }
+
+  if (eventModeUsed && eventEncountered)
+    return handleEvent();
+
+  return oms_status_ok;
+}
+
+/**
+ * @brief Enters event mode if needed, updates the discrete states and returns to step mode.
+ */
+oms_status_enu_t oms::ComponentFMU3CS::handleEvent()
+{
+  fmi3Status status;
+  if (getModel().validState(oms_modelState_simulation))
+  {
+    status = fmi3_enterEventMode(fmu);
+    if (fmi3OK != status) return logError_FMUCall("fmi3_enterEventMode", this);
+  }
+
+  fmi3Boolean discreteStatesNeedUpdate = fmi3True;
+  fmi3Boolean terminateSimulation = fmi3False;
+  fmi3Boolean nominalsChanged = fmi3False;
+  fmi3Boolean valuesChanged = fmi3False;
+  fmi3Boolean nextEventTimeDefined = fmi3False;
+  fmi3Float64 nextEventTime = 0.0;
+  for (unsigned int i = 0; discreteStatesNeedUpdate && !terminateSimulation; ++i)
+  {
+    if (i >= Flags::MaxEventIteration())
+      return logError("Maximum number of event iterations exceeded for FMU \"" + std::string(getFullCref()) + "\" at time " + std::to_string(time));
+
+    status = fmi3_updateDiscreteStates(fmu, &discreteStatesNeedUpdate, &terminateSimulation, &nominalsChanged, &valuesChanged, &nextEventTimeDefined, &nextEventTime);
+    if (fmi3OK != status) return logError_FMUCall("fmi3_updateDiscreteStates", this);
+  }
+
+  if (terminateSimulation)
+  {
+    getModel().setStopTime(time);
+    logInfo("FMU \"" + std::string(getFullCref()) + "\" requested to terminate the simulation at time " + std::to_string(time));
+  }
+
+  status = fmi3_enterStepMode(fmu);
+  if (fmi3OK != status) return logError_FMUCall("fmi3_enterStepMode", this);
+
+  return oms_status_ok;
+}
+
 oms_status_enu_t oms::ComponentFMU3CS::getBoolean(const fmi3ValueReference& vr, bool& value)
 {
   CallClock callClock(clock);
@@ -1241,6 +1323,93 @@ oms_status_enu_t oms::ComponentFMU3CS::getReal(const ComRef& cref, double& value
   return getReal(vr, value, allVariables[j].getNumericType());
 }
 
+oms_status_enu_t oms::ComponentFMU3CS::getRealArray(const Variable& var, double* values)
+{
+  const fmi3ValueReference vr = var.getValueReferenceFMI3();
+  const size_t size = var.getArraySize();
+
+  switch (var.getNumericType())
+  {
+    case oms_signal_numeric_type_FLOAT64:
+      if (fmi3OK != fmi3_getFloat64(fmu, &vr, 1, values, size))
+        return logError_FMUCall("fmi3_getFloat64", this);
+      break;
+    case oms_signal_numeric_type_FLOAT32:
+      floatBuffer.resize(size);
+      if (fmi3OK != fmi3_getFloat32(fmu, &vr, 1, floatBuffer.data(), size))
+        return logError_FMUCall("fmi3_getFloat32", this);
+      for (size_t i = 0; i < size; ++i)
+        values[i] = static_cast<double>(floatBuffer[i]);
+      break;
+    default:
+      return logError("UnSupported Numeric Type:");
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3CS::getRealArray(const ComRef& cref, double* values, size_t size)
+{
+  CallClock callClock(clock);
+
+  Variable* var = getVariable(cref);
+  if (!fmu || !var || !var->isTypeReal())
+    return logError_UnknownSignal(getFullCref() + cref);
+  if (var->getArraySize() != size)
+    return logError("Array " + std::string(getFullCref() + cref) + " has " + std::to_string(var->getArraySize()) + " elements, expected " + std::to_string(size));
+
+  return getRealArray(*var, values);
+}
+
+oms_status_enu_t oms::ComponentFMU3CS::setRealArray(const ComRef& cref, const double* values, size_t size)
+{
+  CallClock callClock(clock);
+
+  Variable* var = getVariable(cref);
+  if (!fmu || !var || !var->isTypeReal())
+    return logError_UnknownSignal(getFullCref() + cref);
+  if (var->getArraySize() != size)
+    return logError("Array " + std::string(getFullCref() + cref) + " has " + std::to_string(var->getArraySize()) + " elements, expected " + std::to_string(size));
+
+  const fmi3ValueReference vr = var->getValueReferenceFMI3();
+  switch (var->getNumericType())
+  {
+    case oms_signal_numeric_type_FLOAT64:
+      if (fmi3OK != fmi3_setFloat64(fmu, &vr, 1, values, size))
+        return logError_FMUCall("fmi3_setFloat64", this);
+      break;
+    case oms_signal_numeric_type_FLOAT32:
+      floatBuffer.resize(size);
+      for (size_t i = 0; i < size; ++i)
+        floatBuffer[i] = static_cast<float>(values[i]);
+      if (fmi3OK != fmi3_setFloat32(fmu, &vr, 1, floatBuffer.data(), size))
+        return logError_FMUCall("fmi3_setFloat32", this);
+      break;
+    default:
+      return logError("UnSupported Numeric Type:");
+  }
+
+  return oms_status_ok;
+}
+
+void oms::ComponentFMU3CS::updateConnectorArraySizes()
+{
+  for (auto& connector : connectors)
+  {
+    if (!connector)
+      continue;
+
+    for (const auto& v : allVariables)
+    {
+      if (v.getCref() == connector->getName())
+      {
+        connector->setArraySize(v.getArraySize());
+        break;
+      }
+    }
+  }
+}
+
 oms_status_enu_t oms::ComponentFMU3CS::getString(const fmi3ValueReference& vr, std::string& value)
 {
   CallClock callClock(clock);
@@ -1423,30 +1592,159 @@ oms_status_enu_t oms::ComponentFMU3CS::getDirectionalDerivative(const ComRef& un
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentFMU3CS::prepareDirectionalDerivative(const std::vector<ComRef>& unknownCrefs, const std::vector<ComRef>& knownCrefs, int& index)
+{
+  if (!getFMUInfo()->getProvidesDirectionalDerivative())
+    return logError("FMU \"" + std::string(getFullCref()) + "\" doesn't support directional derivatives (providesDirectionalDerivative = false in modelDescription.xml)");
+
+  DirectionalDerivative_t dd;
+  dd.vrUnknown.reserve(unknownCrefs.size());
+  for (const ComRef& cref : unknownCrefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    dd.vrUnknown.push_back(var->getValueReferenceFMI3());
+  }
+  dd.vrKnown.reserve(knownCrefs.size());
+  for (const ComRef& cref : knownCrefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    dd.vrKnown.push_back(var->getValueReferenceFMI3());
+  }
+
+  // reuse an identical entry, e.g. if an algebraic loop is set up again
+  for (size_t i = 0; i < directionalDerivatives.size(); ++i)
+  {
+    if (directionalDerivatives[i].vrUnknown == dd.vrUnknown && directionalDerivatives[i].vrKnown == dd.vrKnown)
+    {
+      index = static_cast<int>(i);
+      return oms_status_ok;
+    }
+  }
+
+  index = static_cast<int>(directionalDerivatives.size());
+  directionalDerivatives.push_back(dd);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3CS::getDirectionalDerivative(int index, const double* seed, double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(directionalDerivatives.size()))
+    return logError_InternalError;
+
+  const DirectionalDerivative_t& dd = directionalDerivatives[index];
+  if (fmi3OK != fmi3_getDirectionalDerivative(fmu, dd.vrUnknown.data(), dd.vrUnknown.size(), dd.vrKnown.data(), dd.vrKnown.size(), seed, dd.vrKnown.size(), values, dd.vrUnknown.size()))
+    return logError_FMUCall("fmi3_getDirectionalDerivative", this);
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3CS::prepareRealSignals(const std::vector<ComRef>& crefs, int& index)
+{
+  std::vector<unsigned int> indices;
+  indices.reserve(crefs.size());
+  for (const ComRef& cref : crefs)
+  {
+    int j = -1;
+    for (size_t i = 0; i < allVariables.size(); i++)
+    {
+      if (allVariables[i].getCref() == cref && allVariables[i].isTypeReal())
+      {
+        j = i;
+        break;
+      }
+    }
+    if (j < 0)
+      return logError_UnknownSignal(getFullCref() + cref);
+    if (allVariables[j].getNumericType() != oms_signal_numeric_type_FLOAT64 && allVariables[j].getNumericType() != oms_signal_numeric_type_FLOAT32)
+      return logError("Unsupported Numeric Type for var: \"" + std::string(cref.c_str()) + "\"");
+    indices.push_back(j);
+  }
+
+  for (size_t i = 0; i < realSignals.size(); ++i)
+  {
+    if (realSignals[i] == indices)
+    {
+      index = static_cast<int>(i);
+      return oms_status_ok;
+    }
+  }
+
+  index = static_cast<int>(realSignals.size());
+  realSignals.push_back(indices);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3CS::getRealSignals(int index, double* values)
+{
+  if (!fmu || index < 0 || index >= static_cast<int>(realSignals.size()))
+    return logError_InternalError;
+
+  const std::vector<unsigned int>& indices = realSignals[index];
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    const Variable& var = allVariables[indices[i]];
+    if (oms_status_ok != getReal(var.getValueReferenceFMI3(), values[i], var.getNumericType()))
+      return oms_status_error;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3CS::setRealSignals(int index, const double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(realSignals.size()))
+    return logError_InternalError;
+
+  const std::vector<unsigned int>& indices = realSignals[index];
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    const Variable& var = allVariables[indices[i]];
+    fmi3ValueReference vr = var.getValueReferenceFMI3();
+    if (oms_signal_numeric_type_FLOAT64 == var.getNumericType())
+    {
+      if (fmi3OK != fmi3_setFloat64(fmu, &vr, 1, &values[i], 1))
+        return oms_status_error;
+    }
+    else
+    {
+      float value_ = static_cast<float>(values[i]);
+      if (fmi3OK != fmi3_setFloat32(fmu, &vr, 1, &value_, 1))
+        return oms_status_error;
+    }
+  }
+
+  return oms_status_ok;
+}
+
 oms_status_enu_t oms::ComponentFMU3CS::getDirectionalDerivativeHeper(const int unknownIndex, const int knownIndex, const std::vector<int> &dependencyList, double &value)
 {
   fmi3ValueReference vr_unknown = allVariables[unknownIndex].getValueReferenceFMI3();
-  fmi3ValueReference *vr_known = (fmi3ValueReference *)calloc(dependencyList.size(), sizeof(fmi3ValueReference *));
-  fmi3Float64 *dvknown = (fmi3Float64 *)calloc(dependencyList.size(), sizeof(fmi3Float64 *));
+  vrKnownBuffer.resize(dependencyList.size());
+  seedBuffer.resize(dependencyList.size());
 
   for (int i = 0; i < dependencyList.size(); i++)
   {
-    vr_known[i] = allVariables[dependencyList[i] - 1].getValueReferenceFMI3();
+    vrKnownBuffer[i] = allVariables[dependencyList[i] - 1].getValueReferenceFMI3();
 
     // The knownIndex is < 0 if not specified. In this case, we
     // calculate the sum of the row, which means we set all seed
     // values to 1.0. Otherwise we just set the explicitly provided
     // element to 1.0.
     if (knownIndex < 0 || (dependencyList[i] == knownIndex + 1))
-      dvknown[i] = 1.0;
+      seedBuffer[i] = 1.0;
     else
-      dvknown[i] = 0.0;
+      seedBuffer[i] = 0.0;
   }
 
-  fmi3_getDirectionalDerivative(fmu, &vr_unknown, 1, vr_known, dependencyList.size(), dvknown, 1, &value, 1);
-
-  free(vr_known);
-  free(dvknown);
+  fmi3_getDirectionalDerivative(fmu, &vr_unknown, 1, vrKnownBuffer.data(), vrKnownBuffer.size(), seedBuffer.data(), seedBuffer.size(), &value, 1);
 
   return oms_status_ok;
 }
@@ -1907,6 +2205,7 @@ oms_status_enu_t oms::ComponentFMU3CS::updateOrDeleteStartValueInReplacedCompone
 oms_status_enu_t oms::ComponentFMU3CS::registerSignalsForResultFile(ResultWriter& resultFile)
 {
   resultFileMapping.clear();
+  resultFileArrays.clear();
 
   if (Flags::WallTime())
     clock_id = resultFile.addSignal(std::string(getFullCref() + ComRef("$wallTime")), "wall-clock time [s]", SignalType_REAL);
@@ -1926,7 +2225,9 @@ oms_status_enu_t oms::ComponentFMU3CS::registerSignalsForResultFile(ResultWriter
     else
       name = std::string(getFullCref() + var.getCref());
     const std::string& description = var.getDescription();
-    if (var.isParameter())
+    if (var.isParameter() && var.isArray())
+      logInfo("Array parameter " + name + " will not be stored in the result file");
+    else if (var.isParameter())
     {
       SignalValue_t value;
       if (var.isTypeReal())
@@ -1947,6 +2248,19 @@ oms_status_enu_t oms::ComponentFMU3CS::registerSignalsForResultFile(ResultWriter
       else
         logInfo("Parameter " + name + " will not be stored in the result file, because the signal type is not supported");
     }
+    else if (var.isArray())
+    {
+      // the elements are stored as a contiguous block of columns
+      if (var.isTypeReal() && var.getArraySize() > 0)
+      {
+        unsigned int ID = resultFile.addSignal(name + "[1]", description, SignalType_REAL);
+        for (size_t k = 2; k <= var.getArraySize(); ++k)
+          resultFile.addSignal(name + "[" + std::to_string(k) + "]", description, SignalType_REAL);
+        resultFileArrays[ID] = i;
+      }
+      else
+        logInfo("Array variable " + name + " will not be stored in the result file, because only real arrays are supported");
+    }
     else
     {
       if (var.isTypeReal())
@@ -2009,6 +2323,15 @@ oms_status_enu_t oms::ComponentFMU3CS::updateSignals(ResultWriter& resultWriter)
     }
   }
 
+  for (auto const &it : resultFileArrays)
+  {
+    const Variable& var = allVariables[it.second];
+    arrayBuffer.resize(var.getArraySize());
+    if (oms_status_ok != getRealArray(var, arrayBuffer.data()))
+      return logError("failed to fetch variable " + std::string(var.getCref()));
+    resultWriter.updateSignals(it.first, arrayBuffer.data(), arrayBuffer.size());
+  }
+
   return oms_status_ok;
 }
 
@@ -2080,6 +2403,48 @@ oms_status_enu_t oms::ComponentFMU3CS::restoreState()
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentFMU3CS::serializeState(Checkpoint& checkpoint)
+{
+  fmi3FMUState state = NULL;
+  fmi3Status fmistatus = fmi3_getFMUState(fmu, &state);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_getFMUState", this);
+
+  size_t size = 0;
+  std::vector<fmi3Byte> buffer;
+  fmistatus = fmi3_serializedFMUStateSize(fmu, state, &size);
+  if (fmi3OK == fmistatus)
+  {
+    buffer.resize(size);
+    fmistatus = fmi3_serializeFMUState(fmu, state, buffer.data(), size);
+  }
+  fmi3_freeFMUState(fmu, &state);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_serializeFMUState", this);
+
+  checkpoint.writeValue(time);
+  checkpoint.writeBlock(buffer.data(), buffer.size());
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3CS::deserializeState(Checkpoint& checkpoint)
+{
+  double stateTime;
+  std::vector<char> buffer;
+  if (!checkpoint.readValue(stateTime) || !checkpoint.readBlock(buffer))
+    return logError("Checkpoint doesn't match " + std::string(getFullCref()));
+
+  fmi3FMUState state = NULL;
+  fmi3Status fmistatus = fmi3_deserializeFMUState(fmu, (const fmi3Byte*)buffer.data(), buffer.size(), &state);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_deserializeFMUState", this);
+
+  fmistatus = fmi3_setFMUState(fmu, state);
+  fmi3_freeFMUState(fmu, &state);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_setFMUState", this);
+
+  time = stateTime;
+
+  return oms_status_ok;
+}
+
 void oms::ComponentFMU3CS::getFilteredSignals(std::vector<Connector>& filteredSignals) const
 {
   for (unsigned int i = 0; i < allVariables.size(); ++i)
@@ -92,16 +92,26 @@ namespace oms
     oms_status_enu_t setBoolean(const ComRef& cref, bool value);
     oms_status_enu_t setInteger(const ComRef& cref, int value);
     oms_status_enu_t setReal(const ComRef& cref, double value);
+    oms_status_enu_t getRealArray(const ComRef& cref, double* values, size_t size);
+    oms_status_enu_t setRealArray(const ComRef& cref, const double* values, size_t size);
     oms_status_enu_t setString(const ComRef& cref, const std::string& value);
     oms_status_enu_t setUnit(const ComRef& cref, const std::string& value);
 
     oms_status_enu_t getDirectionalDerivative(const ComRef& unknownCref, const ComRef& knownCref, double& value);
+    oms_status_enu_t prepareDirectionalDerivative(const std::vector<ComRef>& unknownCrefs, const std::vector<ComRef>& knownCrefs, int& index);
+    oms_status_enu_t getDirectionalDerivative(int index, const double* seed, double* values);
+    oms_status_enu_t prepareRealSignals(const std::vector<ComRef>& crefs, int& index);
+    oms_status_enu_t getRealSignals(int index, double* values);
+    oms_status_enu_t setRealSignals(int index, const double* values);
     oms_status_enu_t getDirectionalDerivativeHeper(const int unknownIndex, const int knownindex, const std::vector<int>& dependencyList, double& value);
 
     oms_status_enu_t deleteStartValue(const ComRef& cref);
     oms_status_enu_t updateOrDeleteStartValueInReplacedComponent(std::vector<std::string>& warningList);
 
     oms_status_enu_t setFmuTime(double time) {this->time = time; return oms_status_ok;}
+    double getFmuTime() const {return time;}
+    bool getEventModeUsed() const {return eventModeUsed;}
+    oms_status_enu_t stepUntilEvent(double stopTime);
     fmiHandle* getFMU() {return fmu;}
     std::vector<Variable> getAllVariables() {return allVariables;}
 
@@ -114,6 +124,9 @@ namespace oms
     oms_status_enu_t removeSignalsFromResults(const char* regex);
 
     bool getCanGetAndSetState() {return getFMUInfo()->getCanGetAndSetFMUstate();}
+    bool getCanSerializeState() {return getFMUInfo()->getCanSerializeFMUstate();}
+    oms_status_enu_t serializeState(Checkpoint& checkpoint);
+    oms_status_enu_t deserializeState(Checkpoint& checkpoint);
     oms_status_enu_t saveState();
     oms_status_enu_t freeState();
     oms_status_enu_t restoreState();
@@ -123,6 +136,7 @@ namespace oms
     oms_status_enu_t newResources(const std::string& ssvFilename, const std::string& ssmFilename, bool externalResources);
     oms_status_enu_t setResourcesHelper1(Values value);
     oms_status_enu_t setResourcesHelper2(Values value);
+    void applyStartValues();
     oms_status_enu_t setExportName(const std::string & exportName) { this->exportName = exportName; return oms_status_ok;};
     std::string getExportName() const { return this->exportName; }
     oms_status_enu_t deleteReferencesInSSD(const std::string& filename);
@@ -140,6 +154,11 @@ namespace oms
 
     void dumpInitialUnknowns();
 
+    oms_status_enu_t getRealArray(const Variable& var, double* values);
+    void updateConnectorArraySizes();
+
+    oms_status_enu_t handleEvent();
+
   private:
     fmi3LogMessageCallback omsfmi3logger;
     fmiHandle *fmu = NULL;
@@ -157,11 +176,28 @@ namespace oms
     Values values; ///< start values defined before instantiating the FMU and external inputs defined after initialization
 
     std::unordered_map<unsigned int /*result file var ID*/, unsigned int /*allVariables ID*/> resultFileMapping;
+    std::unordered_map<unsigned int /*result file ID of the first element*/, unsigned int /*allVariables ID*/> resultFileArrays;
+    std::vector<double> arrayBuffer; ///< scratch buffer for array variables in updateSignals
+    std::vector<float> floatBuffer;  ///< scratch buffer for Float32 array variables
 
     double time;
+    bool eventModeUsed = false; ///< the FMU uses event mode and may return early from fmi3DoStep, see --earlyReturn
     fmi3FMUState fmuState = NULL;
     double fmuStateTime;
 
+    /**
+     * @brief Value references of a directional derivative prepared with prepareDirectionalDerivative().
+     */
+    struct DirectionalDerivative_t
+    {
+      std::vector<fmi3ValueReference> vrUnknown;
+      std::vector<fmi3ValueReference> vrKnown;
+    };
+    std::vector<DirectionalDerivative_t> directionalDerivatives;
+    std::vector<std::vector<unsigned int>> realSignals; ///< allVariables indices of signals prepared with prepareRealSignals()
+    std::vector<fmi3ValueReference> vrKnownBuffer; ///< scratch buffer of getDirectionalDerivativeHeper
+    std::vector<fmi3Float64> seedBuffer;   ///< scratch buffer of getDirectionalDerivativeHeper
+
     oms::ComRef getValidCref(ComRef cref);
   };
 }
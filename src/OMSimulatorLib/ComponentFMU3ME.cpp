@@ -0,0 +1,2110 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ComponentFMU3ME.h"
+
+#include "Flags.h"
+#include "Logging.h"
+#include "Model.h"
+#include "OMSFileSystem.h"
+#include "ssd/Tags.h"
+#include "System.h"
+#include "SystemSC.h"
+#include "Scope.h"
+
+#include <fmi4c.h>
+#include <regex>
+#include <unordered_set>
+#include <cmath>
+#include <iostream>
+
+
+oms::ComponentFMU3ME::ComponentFMU3ME(const ComRef& cref, System* parentSystem, const std::string& fmuPath)
+  : oms::ComponentFMUMEBase(cref, oms_component_fmu3, parentSystem, fmuPath)
+{
+}
+
+oms::ComponentFMU3ME::~ComponentFMU3ME()
+{
+  if (oms_modelState_virgin != getModel().getModelState())
+    fmi3_freeInstance(fmu);
+
+  fmi4c_freeFmu(fmu);
+}
+
+oms::Component* oms::ComponentFMU3ME::NewComponent(const oms::ComRef& cref, oms::System* parentSystem, const std::string& fmuPath, std::string replaceComponent)
+{
+  if (!cref.isValidIdent())
+  {
+    logError_InvalidIdent(cref);
+    return NULL;
+  }
+
+  if (!parentSystem)
+  {
+    logError_InternalError;
+    return NULL;
+  }
+  // replaceComponent string will be used to avoid name conflicts when replacing a fmu with oms_replaceSubModel(), the default is ""
+
+  filesystem::path relFMUPath = parentSystem->copyResources() ? (filesystem::path("resources") / (parentSystem->getUniqueID() + "_" + replaceComponent + std::string(cref) + ".fmu")) : filesystem::path(fmuPath);
+
+  ComponentFMU3ME* component = new ComponentFMU3ME(cref, parentSystem, relFMUPath.generic_string());
+
+  /* parse the modeldescription.xml at top level to get the GUID to check whether instance already exist
+   * so we don't need to unpack the fmu, and also parse start values before instantiating fmu's
+  */
+  std::string guid_ = "";
+  filesystem::path modelDescriptionPath;
+  /*
+  * check for modeldescription path from file system or temp directory
+  * because when importingSnapshot the path will be resources/0001_tank1.fmu
+  */
+  if (parentSystem->copyResources())
+    modelDescriptionPath = fmuPath;
+  else
+    modelDescriptionPath = parentSystem->getModel().getTempDirectory() / filesystem::path(fmuPath);
+
+  // a clone takes over the parsed modelDescription.xml and the unpacked fmu of its source component
+  const ComponentFMU3ME* source = dynamic_cast<const ComponentFMU3ME*>(component->getCloneSource());
+  if (source)
+    component->values.copyModelDescription(source->values);
+  else
+    component->values.parseModelDescriptionFmi3(modelDescriptionPath, guid_);
+
+  if (oms_status_ok != component->unpackFMU(guid_, modelDescriptionPath.string(), source))
+  {
+    delete component;
+    return NULL;
+  }
+
+  // load the unpacked fmu and parse modelDescription.xml
+  component->fmu = fmi4c_loadUnzippedFmu(cref.c_str(), filesystem::path(component->getTempDir()).generic_string().c_str());
+  if (!component->fmu)
+  {
+    logError("Error parsing modelDescription.xml");
+    delete component;
+    return NULL;
+  }
+
+  fmiVersion_t version = fmi4c_getFmiVersion(component->fmu);
+  if (fmiVersion3 != version)
+  {
+    logError("Unsupported FMI version: " + version);
+    delete component;
+    return NULL;
+  }
+
+  if (!fmi3_supportsModelExchange(component->fmu))
+  {
+    logError("FMU \"" + std::string(cref) + "\" doesn't support model exchange mode.");
+    delete component;
+    return NULL;
+  }
+
+  // update FMU info
+  component->fmuInfo.update(oms_component_fmu3, component->fmu);
+  component->omsfmi3logger = oms::fmi3logger;
+
+  // create a list of all variables using fmi4c variable structure
+  const unsigned int nVariables = static_cast<unsigned int>(fmi3_getNumberOfVariables(component->fmu));
+  component->allVariables.reserve(nVariables);
+  component->exportVariables.reserve(nVariables);
+  for (unsigned int i = 0; i < nVariables; ++i)
+  {
+    oms::Variable v(component->fmu, i, oms_component_fmu3);
+    if (v.getIndex() != i)
+    {
+      logError("Index mismatch " + std::to_string(v.getIndex()) + " != " + std::to_string(i) + ".\nPlease report the problem to the dev team: https://github.com/OpenModelica/OMSimulator/issues/new?assignees=&labels=&template=bug_report.md");
+      delete component;
+      return NULL;
+    }
+
+    // mark derivatives
+    auto derivative = component->values.modelDescriptionDerivatives.find(v.getValueReferenceFMI3());
+    if (derivative != component->values.modelDescriptionDerivatives.end())
+      v.markAsDer(derivative->second);
+
+    component->allVariables.push_back(v);
+    component->exportVariables.push_back(true);
+  }
+
+  // the model structure and the derivative attribute of FMI 3.0 refer to variables by value reference
+  for (const auto& v : component->allVariables)
+    component->variableIndices[v.getValueReferenceFMI3()] = v.getIndex();
+
+  if (oms_status_ok != component->initializeStates() || oms_status_ok != component->initializeConnectors())
+  {
+    delete component;
+    return NULL;
+  }
+
+  return component;
+}
+
+oms::Component* oms::ComponentFMU3ME::NewComponent(const pugi::xml_node& node, oms::System* parentSystem, const std::string& sspVersion, const Snapshot& snapshot, std::string variantName)
+{
+  ComRef cref = ComRef(node.attribute("name").as_string());
+  std::string type = node.attribute("type").as_string();
+  std::string source = node.attribute("source").as_string();
+
+  if (type != "application/x-fmu-sharedlibrary" && !type.empty())
+  {
+    logError("Unexpected component type: " + type);
+    return NULL;
+  }
+
+  oms::ComponentFMU3ME* component = dynamic_cast<oms::ComponentFMU3ME*>(oms::ComponentFMU3ME::NewComponent(cref, parentSystem, source));
+  if (!component)
+    return NULL;
+
+  for (const auto& connector : component->connectors)
+    if (connector)
+      delete connector;
+  component->connectors.clear();
+  for(pugi::xml_node_iterator it = node.begin(); it != node.end(); ++it)
+  {
+    std::string name = it->name();
+    if(name == oms::ssp::Draft20180219::ssd::connectors)
+    {
+      // get the ssdNode to parse UnitDefinitions in "SystemStructure.ssd"
+      pugi::xml_node ssdNode = snapshot.getResourceNode(variantName);
+      component->values.importUnitDefinitions(ssdNode);
+      // import connectors
+      for(pugi::xml_node_iterator itConnectors = (*it).begin(); itConnectors != (*it).end(); ++itConnectors)
+      {
+        component->connectors.push_back(oms::Connector::NewConnector(*itConnectors, sspVersion, component->getFullCref()));
+        // set units to connector
+        if ((*itConnectors).child(oms::ssp::Version1_0::ssc::real_type))
+        {
+          std::string unitName = (*itConnectors).child(oms::ssp::Version1_0::ssc::real_type).attribute("unit").as_string();
+          if (!unitName.empty())
+            component->connectors.back()->connectorUnits[unitName] = component->values.modeldescriptionUnitDefinitions[unitName];
+        }
+        // set enumeration definitions
+        if ((*itConnectors).child(oms::ssp::Version1_0::ssc::enumeration_type))
+        {
+          std::string enumTypeName = (*itConnectors).child(oms::ssp::Version1_0::ssc::enumeration_type).attribute("name").as_string();
+          if (!enumTypeName.empty())
+            component->connectors.back()->enumerationName[component->connectors.back()->getName().c_str()] = enumTypeName;
+
+          // give priority to enum definitions in ssd over modeldescription.xml, it is possible the user might have manually change values in ssd file
+          component->values.importEnumerationDefinitions(ssdNode, enumTypeName);
+        }
+      }
+    }
+    else if(name == oms::ssp::Draft20180219::ssd::element_geometry)
+    {
+      oms::ssd::ElementGeometry geometry;
+      geometry.importFromSSD(*it);
+      component->setGeometry(geometry);
+    }
+    else if(name == oms::ssp::Version1_0::ssd::parameter_bindings)
+    {
+      // set parameter bindings associated with the component
+      Values resources;
+      std::string tempdir = parentSystem->getModel().getTempDirectory();
+      resources.importFromSnapshot(*it, sspVersion, snapshot, variantName);
+      component->values.parameterResources.push_back(resources);
+    }
+    else
+    {
+      logError_WrongSchema(name);
+      delete component;
+      return NULL;
+    }
+  }
+
+  component->connectors.push_back(NULL);
+  component->element.setConnectors(&component->connectors[0]);
+
+  return component;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::exportToSSD(pugi::xml_node& node, Snapshot& snapshot, std::string variantName) const
+{
+  node.append_attribute("name") = this->getCref().c_str();
+  node.append_attribute("type") = "application/x-fmu-sharedlibrary";
+  node.append_attribute("source") = getPath().c_str();
+
+  if (element.getGeometry())
+    element.getGeometry()->exportToSSD(node);
+
+  if (connectors.size() > 1)
+  {
+    pugi::xml_node node_connectors = node.append_child(oms::ssp::Draft20180219::ssd::connectors);
+    for (const auto& connector : connectors)
+      if (connector)
+        if (oms_status_ok != connector->exportToSSD(node_connectors))
+          return oms_status_error;
+  }
+
+  // export ParameterBindings at component level
+  values.exportParameterBindings(node, snapshot, variantName);
+
+  return oms_status_ok;
+}
+
+void oms::ComponentFMU3ME::getFilteredUnitDefinitionsToSSD(std::map<std::string, std::map<std::string, std::string>>& unitDefinitions)
+{
+  // get units from connectors
+  for (const auto &connector : connectors)
+  {
+    if (connector)
+    {
+      if (!connector->connectorUnits.empty())
+      {
+        for (auto &con : connector->connectorUnits)
+        {
+          auto unitvalue = unitDefinitions.find(con.first);
+          if (unitvalue == unitDefinitions.end())
+            unitDefinitions[con.first] = con.second;
+        }
+      }
+    }
+  }
+
+  return values.getFilteredUnitDefinitionsToSSD(unitDefinitions);
+}
+
+void oms::ComponentFMU3ME::getFilteredEnumerationDefinitionsToSSD(std::map<std::string, std::map<std::string, std::string>>& enumerationDefinitions)
+{
+  return values.getFilteredEnumerationDefinitionsToSSD(enumerationDefinitions);
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::exportToSSV(pugi::xml_node& ssvNode)
+{
+  return values.exportToSSV(ssvNode);
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::exportToSSVTemplate(pugi::xml_node& ssvNode, Snapshot& snapshot)
+{
+  values.exportToSSVTemplate(ssvNode, getCref());
+  values.exportUnitDefinitionsToSSVTemplate(snapshot, "template.ssv");
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::exportToSSMTemplate(pugi::xml_node& ssmNode)
+{
+  values.exportToSSMTemplate(ssmNode, getCref());
+  return oms_status_ok;
+}
+
+void oms::ComponentFMU3ME::dumpInitialUnknowns()
+{
+  std::string str = "";
+  int n=0;
+  for (auto &v : allVariables)
+  {
+    if (v.isInitialUnknown())
+    {
+      n++;
+      if (!str.empty())
+        str += ", ";
+      str += std::to_string(v.getIndex()+1) + ": " + std::string(v.getCref());
+    }
+  }
+  logInfo("[" + std::string(getCref()) + ": " + getPath() + "] The FMU contains " + std::to_string(n) + " initial unknowns: " + str);
+}
+
+int oms::ComponentFMU3ME::getModelStructureReference(unsigned int index) const
+{
+  return static_cast<int>(allVariables[index].getValueReferenceFMI3());
+}
+
+bool oms::ComponentFMU3ME::getVariableIndex(int reference, unsigned int& index) const
+{
+  auto variable = variableIndices.find(static_cast<fmi3ValueReference>(reference));
+  if (variable == variableIndices.end())
+    return false;
+
+  index = variable->second;
+  return true;
+}
+
+/**
+ * @brief Sets the start values of the SSV resources or inline values in the FMU.
+ *
+ * Called after instantiation and again after fmi reset, which restores the
+ * start values of the modelDescription.xml.
+ */
+void oms::ComponentFMU3ME::applyStartValues()
+{
+  // set start values from local resources
+  if (values.hasResources())
+  {
+    for (const auto &it : values.parameterResources)
+    {
+      for (const auto &res : it.allresources)
+      {
+        if (res.second.linkResources) // set values only if resources are linked in ssd
+          setResourcesHelper1(res.second);
+      }
+    }
+    /*
+      check for parameter entry at system level and override the start values if exist,
+      as system level parameter has highest priority, this is done after checking for
+      local resources because it is possible some parameters have local entry and other
+      parameters have top level system entry
+    */
+    if (getParentSystem() && getParentSystem()->getValues().hasResources())
+      setResourcesHelper2(getParentSystem()->getValues());
+  }
+  // set start values from root resources
+  else if (getParentSystem() && getParentSystem()->getValues().hasResources())
+  {
+    setResourcesHelper2(getParentSystem()->getValues());
+  }
+  // set start values from top level root resources
+  else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())
+  {
+    setResourcesHelper2(getParentSystem()->getParentSystem()->getValues());
+  }
+  // set start values from inline resources
+  else
+  {
+    setResourcesHelper1(values);
+  }
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::instantiate()
+{
+  if (!fmi3_instantiateModelExchange(fmu, fmi3False, fmi3True, fmu, omsfmi3logger))
+  {
+    logInfo("fmi3Instantiate() failed");
+    exit(1);
+  }
+
+  applyStartValues();
+  // enterInitialization
+  const double& startTime = getModel().getStartTime();
+  double relativeTolerance = 0.0;
+  dynamic_cast<SystemSC*>(getParentSystem())->getTolerance(&relativeTolerance);
+  fmi3Status status = fmi3_enterInitializationMode(fmu, fmi3True, relativeTolerance, startTime, fmi3False, 1.0);
+  if (fmi3OK != status) return logError_FMUCall("fmi3_enterInitializationMode", this);
+
+  status = fmi3_getNumberOfEventIndicators(fmu, &nEventIndicators);
+  if (fmi3OK != status) return logError_FMUCall("fmi3_getNumberOfEventIndicators", this);
+
+  eventInfo.newDiscreteStatesNeeded = fmi2False;
+  eventInfo.terminateSimulation = fmi2False;
+  eventInfo.nominalsOfContinuousStatesChanged = fmi2False;
+  eventInfo.valuesOfContinuousStatesChanged = fmi2True;
+  eventInfo.nextEventTimeDefined = fmi2False;
+  eventInfo.nextEventTime = -0.0;
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setResourcesHelper1(Values values)
+{
+  for (const auto &v : values.booleanStartValues)
+  {
+    oms::ComRef cref = getValidCref(v.first);
+    if (oms_status_ok != setBoolean(cref, v.second))
+      return logError("Failed to set start value for " + std::string(v.first));
+  }
+  for (const auto &v : values.integerStartValues)
+  {
+    oms::ComRef cref = getValidCref(v.first);
+    if (oms_status_ok != setInteger(cref, v.second))
+      return logError("Failed to set start value for " + std::string(v.first));
+  }
+  for (const auto &v : values.realStartValues)
+  {
+    oms::ComRef cref = getValidCref(v.first);
+    if (oms_status_ok != setReal(cref, v.second))
+      return logError("Failed to set start value for " + std::string(v.first));
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setResourcesHelper2(Values values)
+{
+  for (const auto &it : values.parameterResources)
+  {
+    for (const auto &res : it.allresources)
+    {
+      for (const auto &v : res.second.booleanStartValues)
+      {
+        if (res.second.linkResources) // set values only if resources are linked in ssd
+        {
+          oms::ComRef tail(v.first);
+          oms::ComRef head = tail.pop_front();
+          if (head == getCref())
+          {
+            if (oms_status_ok != setBoolean(tail, v.second))
+              return logError("Failed to set start value for " + std::string(v.first));
+          }
+        }
+      }
+      for (const auto &v : res.second.integerStartValues)
+      {
+        if (res.second.linkResources) // set values only if resources are linked in ssd
+        {
+          oms::ComRef tail(v.first);
+          oms::ComRef head = tail.pop_front();
+          if (head == getCref())
+          {
+            if (oms_status_ok != setInteger(tail, v.second))
+              return logError("Failed to set start value for " + std::string(v.first));
+          }
+        }
+      }
+      for (const auto &v : res.second.realStartValues)
+      {
+        if (res.second.linkResources) // set values only if resources are linked in ssd
+        {
+          oms::ComRef tail(v.first);
+          oms::ComRef head = tail.pop_front();
+          if (head == getCref())
+          {
+            if (oms_status_ok != setReal(tail, v.second))
+              return logError("Failed to set start value for " + std::string(v.first));
+          }
+        }
+      }
+    }
+  }
+
+  return oms_status_ok;
+}
+
+/*
+ * function which returns validCrefs
+ * (e.g) add.P => P
+ * (e.g) chassis.C.mChassis => C.mChassis
+ * inline parameters should be returned as default value (e.g.) P => P or C.mChassis => C.mChassis
+ */
+oms::ComRef oms::ComponentFMU3ME::getValidCref(ComRef cref)
+{
+  oms::ComRef tail(cref);
+  oms::ComRef head = tail.pop_front();
+
+  if (tail.isEmpty() || head != getCref()) // check for inline parameter crefs, (e.g.) P => P or C.mChassis => C.mChassis
+    tail = cref;
+  return tail;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::newResources(const std::string& ssvFilename, const std::string& ssmFilename, bool externalResources)
+{
+  Values resources;
+  if (externalResources) // check of external resources and override the start values with new references
+  {
+    Snapshot snapshot;
+    snapshot.importResourceFile(ssvFilename, getModel().getTempDirectory() + "/resources");
+
+    // import ssm file, if provided
+    if (!ssmFilename.empty())
+      snapshot.importResourceFile(ssmFilename, getModel().getTempDirectory() + "/resources");
+
+    if (oms_status_ok != resources.importFromSnapshot(snapshot, ssvFilename, ssmFilename))
+      return logError("referenceResources failed for \"" + std::string(getFullCref()) + ":" + ssvFilename + "\"");
+  }
+
+  if (!values.hasResources())
+  {
+    if(!ssmFilename.empty())
+      resources.ssmFile = "resources/" + ssmFilename;
+    // copy modeldescriptionVariableUnits to ssv resources which will be used to export units
+    resources.modelDescriptionVariableUnits = values.modelDescriptionVariableUnits;
+    // copy modeldescriptionVariableUnitDefinitions to ssv resources which will be used to export unit definitions
+    resources.modeldescriptionUnitDefinitions = values.modeldescriptionUnitDefinitions;
+    resources.allresources["resources/" + ssvFilename] = resources;
+    values.parameterResources.push_back(resources);
+  }
+  else
+  {
+    // generate empty ssv file, if more resources are added to same level
+    if(!ssmFilename.empty())
+      resources.ssmFile = "resources/" + ssmFilename;
+    // copy modeldescriptionVariableUnits to ssv resources which will be used to export units
+    resources.modelDescriptionVariableUnits = values.modelDescriptionVariableUnits;
+    // copy modeldescriptionVariableUnitDefinitions to ssv resources which will be used to export unit definitions
+    resources.modeldescriptionUnitDefinitions = values.modeldescriptionUnitDefinitions;
+    values.parameterResources[0].allresources["resources/" + ssvFilename] = resources;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::deleteReferencesInSSD(const std::string& filename)
+{
+  if (values.hasResources())
+    return values.deleteReferencesInSSD(filename);
+
+  return oms_status_error;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::deleteResourcesInSSP(const std::string& filename)
+{
+  if (values.hasResources())
+    return values.deleteResourcesInSSP(filename);
+
+  return oms_status_error;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::initialize()
+{
+  clock.reset();
+  CallClock callClock(clock);
+
+  // exitInitialization
+  fmi3Status fmistatus = fmi3_exitInitializationMode(fmu);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_exitInitializationMode", this);
+
+  // fmi3ExitInitializationMode leaves the FMU in event mode
+  if (oms_status_ok != doEventIteration())
+    return oms_status_error;
+
+  return enterContinuousTimeMode();
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::terminate()
+{
+  fmi3Status fmistatus = fmi3_terminate(fmu);
+  if (fmi3OK != fmistatus)
+    return logError_Termination(getCref());
+
+  fmi3_freeInstance(fmu);
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::reset()
+{
+  fmi3Status fmistatus = fmi3_reset(fmu);
+  if (fmi3OK != fmistatus)
+    return logError_ResetFailed(getCref());
+
+  // the fmu is back at the start values of the modelDescription.xml
+  applyStartValues();
+
+  // enterInitialization
+  const double& startTime = getModel().getStartTime();
+  double relativeTolerance = 0.0;
+  dynamic_cast<SystemSC*>(getParentSystem())->getTolerance(&relativeTolerance);
+  fmistatus = fmi3_enterInitializationMode(fmu, fmi3True, relativeTolerance, startTime, fmi3False, 1.0);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_enterInitializationMode", this);
+
+  eventInfo.newDiscreteStatesNeeded = fmi2False;
+  eventInfo.terminateSimulation = fmi2False;
+  eventInfo.nominalsOfContinuousStatesChanged = fmi2False;
+  eventInfo.valuesOfContinuousStatesChanged = fmi2True;
+  eventInfo.nextEventTimeDefined = fmi2False;
+  eventInfo.nextEventTime = -0.0;
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::doEventIteration()
+{
+  const int maxIterations = Flags::MaxEventIteration();
+  int iterations = 0;
+
+  CallClock callClock(clock);
+  fmi3Boolean discreteStatesNeedUpdate = fmi3True;
+  fmi3Boolean terminateSimulation = fmi3False;
+  fmi3Boolean nominalsChanged = fmi3False;
+  fmi3Boolean valuesChanged = fmi3False;
+  fmi3Boolean nextEventTimeDefined = fmi3False;
+  fmi3Float64 nextEventTime = 0.0;
+
+  // the event info is accumulated over all iterations, as for fmi2NewDiscreteStates
+  eventInfo.nominalsOfContinuousStatesChanged = fmi2False;
+  eventInfo.valuesOfContinuousStatesChanged = fmi2False;
+  while (discreteStatesNeedUpdate && !terminateSimulation)
+  {
+    fmi3Status fmistatus = fmi3_updateDiscreteStates(fmu, &discreteStatesNeedUpdate, &terminateSimulation, &nominalsChanged, &valuesChanged, &nextEventTimeDefined, &nextEventTime);
+    if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_updateDiscreteStates", this);
+
+    if (nominalsChanged)
+      eventInfo.nominalsOfContinuousStatesChanged = fmi2True;
+    if (valuesChanged)
+      eventInfo.valuesOfContinuousStatesChanged = fmi2True;
+
+    if (++iterations >= maxIterations)
+      return logError("Event iteration reached max number of iterations (" + std::to_string(maxIterations) + ") for FMU " + std::string(getCref()));
+  }
+
+  eventInfo.newDiscreteStatesNeeded = discreteStatesNeedUpdate ? fmi2True : fmi2False;
+  eventInfo.terminateSimulation = terminateSimulation ? fmi2True : fmi2False;
+  eventInfo.nextEventTimeDefined = nextEventTimeDefined ? fmi2True : fmi2False;
+  eventInfo.nextEventTime = nextEventTime;
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::enterEventMode()
+{
+  fmi3Status fmistatus = fmi3_enterEventMode(fmu);
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_enterEventMode", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::enterContinuousTimeMode()
+{
+  fmi3Status fmistatus = fmi3_enterContinuousTimeMode(fmu);
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_enterContinuousTimeMode", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::completedIntegratorStep(fmi2Boolean& callEventUpdate, fmi2Boolean& terminateSimulation)
+{
+  CallClock callClock(clock);
+  fmi3Boolean enterEventMode = fmi3False;
+  fmi3Boolean terminate = fmi3False;
+  fmi3Status fmistatus = fmi3_completedIntegratorStep(fmu, fmi3True, &enterEventMode, &terminate);
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_completedIntegratorStep", this);
+
+  callEventUpdate = enterEventMode ? fmi2True : fmi2False;
+  terminateSimulation = terminate ? fmi2True : fmi2False;
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setTime(double time)
+{
+  fmi3Status fmistatus = fmi3_setTime(fmu, time);
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_setTime", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getBoolean(const fmi3ValueReference& vr, bool& value)
+{
+  CallClock callClock(clock);
+
+  // bool value_;
+  if (fmi3OK != fmi3_getBoolean(fmu, &vr, 1, &value, 1))
+    return oms_status_error;
+
+  // value = value_ ? true : false;
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getBoolean(const ComRef& cref, bool& value)
+{
+  CallClock callClock(clock);
+
+  if (oms_modelState_virgin == getModel().getModelState())
+  {
+    // check for start values exist, priority over modeldescription.xml start values
+    if (values.hasResources())  // search in local resources
+    {
+      if (oms_status_ok == values.getBooleanResources(cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if (oms_status_ok == values.getBooleanFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else if (getParentSystem() && getParentSystem()->getValues().hasResources())  // search in root resources
+    {
+      if (oms_status_ok == getParentSystem()->getValues().getBooleanResources(getCref()+cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if(oms_status_ok == values.getBooleanFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())  // search in top level root resources
+    {
+      if (oms_status_ok == getParentSystem()->getParentSystem()->getValues().getBooleanResources(getCref()+cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if(oms_status_ok == values.getBooleanFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else // search inline
+    {
+      // check for start values exist, priority over modeldescription.xml start values
+      if (oms_status_ok == values.getBoolean(cref, value))
+      {
+        return oms_status_ok;
+      }
+      else
+      {
+        return values.getBooleanFromModeldescription(cref, value);
+      }
+    }
+  }
+
+  int j=-1;
+  for (size_t i = 0; i < allVariables.size(); i++)
+  {
+    if (allVariables[i].getCref() == cref && allVariables[i].isTypeBoolean())
+    {
+      j = i;
+      break;
+    }
+  }
+
+  if (!fmu || j < 0)
+    return logError_UnknownSignal(getFullCref() + cref);
+
+  fmi3ValueReference vr = allVariables[j].getValueReferenceFMI3();
+  return getBoolean(vr, value);
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getInteger(const fmi3ValueReference& vr, int& value, oms_signal_numeric_type_enu_t numericType)
+{
+  CallClock callClock(clock);
+
+   // Temporary variables for different types
+  int64_t value64;
+  int16_t value16;
+  int8_t value8;
+  uint64_t valueU64;
+  uint32_t valueU32;
+  uint16_t valueU16;
+  uint8_t valueU8;
+
+  switch (numericType)
+  {
+    case oms_signal_numeric_type_INT64:
+    {
+      if (fmi3OK != fmi3_getInt64(fmu, &vr, 1, &value64, 1))
+        return oms_status_error;
+      if (value64 < INT_MIN || value64 > INT_MAX)
+        return oms_status_error;  // Value out of range for int
+      value = static_cast<int>(value64);  // Cast to int
+      break;
+    }
+    case oms_signal_numeric_type_INT32:
+    {
+      if (fmi3OK != fmi3_getInt32(fmu, &vr, 1, &value, 1))
+        return oms_status_error;
+      break;
+    }
+    case oms_signal_numeric_type_INT16:
+    {
+      if (fmi3OK != fmi3_getInt16(fmu, &vr, 1, &value16, 1))
+        return oms_status_error;
+      value = static_cast<int>(value16);
+      break;
+    }
+    case oms_signal_numeric_type_INT8:
+    {
+      if (fmi3OK != fmi3_getInt8(fmu, &vr, 1, &value8, 1))
+        return oms_status_error;
+      value = static_cast<int>(value8);
+      break;
+    }
+    case oms_signal_numeric_type_UINT64:
+    {
+      if (fmi3OK != fmi3_getUInt64(fmu, &vr, 1, &valueU64, 1))
+        return oms_status_error;
+      value = static_cast<int>(valueU64);
+      break;
+    }
+    case oms_signal_numeric_type_UINT32:
+    {
+      if (fmi3OK != fmi3_getUInt32(fmu, &vr, 1, &valueU32, 1))
+        return oms_status_error;
+      value = static_cast<int>(valueU32);
+      break;
+    }
+    case oms_signal_numeric_type_UINT16:
+    {
+      if (fmi3OK != fmi3_getUInt16(fmu, &vr, 1, &valueU16, 1))
+        return oms_status_error;
+      value = static_cast<int>(valueU16);
+      break;
+    }
+    case oms_signal_numeric_type_UINT8:
+    {
+      if (fmi3OK != fmi3_getUInt8(fmu, &vr, 1, &valueU8, 1))
+        return oms_status_error;
+      value = static_cast<int>(valueU8);
+      break;
+    }
+    default :
+      return logError("Unsupported Numeric Type");
+  }
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getInteger(const ComRef& cref, int& value)
+{
+  CallClock callClock(clock);
+
+  if (oms_modelState_virgin == getModel().getModelState())
+  {
+    // check for start values exist, priority over modeldescription.xml start values
+    if (values.hasResources())  // search in local resources
+    {
+      if (oms_status_ok == values.getIntegerResources(cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if (oms_status_ok == values.getIntegerFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else if (getParentSystem() && getParentSystem()->getValues().hasResources())  // search in root resources
+    {
+      if (oms_status_ok == getParentSystem()->getValues().getIntegerResources(getCref()+cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if(oms_status_ok == values.getIntegerFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())  // search in top level root resources
+    {
+      if (oms_status_ok == getParentSystem()->getParentSystem()->getValues().getIntegerResources(getCref()+cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if(oms_status_ok == values.getIntegerFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else // search inline
+    {
+      // check for start values exist, priority over modeldescription.xml start values
+      if (oms_status_ok == values.getInteger(cref, value))
+      {
+        return oms_status_ok;
+      }
+      else
+      {
+        return values.getIntegerFromModeldescription(cref, value);
+      }
+    }
+  }
+
+  int j=-1;
+  for (size_t i = 0; i < allVariables.size(); i++)
+  {
+    if (allVariables[i].getCref() == cref && allVariables[i].isTypeInteger())
+    {
+      j = i;
+      break;
+    }
+  }
+
+  if (!fmu || j < 0)
+    return logError_UnknownSignal(getFullCref() + cref);
+
+  fmi3ValueReference vr = allVariables[j].getValueReferenceFMI3();
+  return getInteger(vr, value, allVariables[j].getNumericType());
+}
+
+oms::Variable* oms::ComponentFMU3ME::getVariable(const ComRef& cref)
+{
+  CallClock callClock(clock);
+  for (size_t i=0; i < allVariables.size(); i++)
+    if (allVariables[i].getCref() == cref)
+      return &allVariables[i];
+
+  logError_UnknownSignal(getFullCref() + cref);
+  return NULL;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getReal(const fmi3ValueReference& vr, double& value, oms_signal_numeric_type_enu_t numericType)
+{
+  CallClock callClock(clock);
+
+  switch (numericType)
+  {
+    case oms_signal_numeric_type_FLOAT64:
+    {
+      if (fmi3OK != fmi3_getFloat64(fmu, &vr, 1, &value, 1))
+        return oms_status_error;
+      break;
+    }
+    case oms_signal_numeric_type_FLOAT32:
+    {
+      float value_;
+      if (fmi3OK != fmi3_getFloat32(fmu, &vr, 1, &value_, 1))
+        return oms_status_error;
+      // Convert the float to double and assign to 'value'
+      value = static_cast<double>(value_);
+      break;
+    }
+    default:
+      return logError("UnSupported Numeric Type:");
+  }
+
+  if (std::isnan(value))
+    return logError("getReal returned NAN");
+  if (std::isinf(value))
+    return logError("getReal returned +/-inf");
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getReal(const ComRef& cref, double& value)
+{
+  CallClock callClock(clock);
+
+  if (oms_modelState_virgin == getModel().getModelState())
+  {
+    // check for start values exist, priority over modeldescription.xml start values
+    if (values.hasResources())  // search in local resources
+    {
+      if (oms_status_ok == values.getRealResources(cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if (oms_status_ok == values.getRealFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else if (getParentSystem() && getParentSystem()->getValues().hasResources())  // search in root resources
+    {
+      if (oms_status_ok == getParentSystem()->getValues().getRealResources(getCref()+cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if(oms_status_ok == values.getRealFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())  // search in top level root resources
+    {
+      if (oms_status_ok == getParentSystem()->getParentSystem()->getValues().getRealResources(getCref()+cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if(oms_status_ok == values.getRealFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else // search inline
+    {
+      // check for start values exist, priority over modeldescription.xml start values
+      if (oms_status_ok == values.getReal(cref, value))
+      {
+        return oms_status_ok;
+      }
+      else
+      {
+        return values.getRealFromModeldescription(cref, value);
+      }
+    }
+  }
+
+  int j=-1;
+  for (size_t i = 0; i < allVariables.size(); i++)
+  {
+    if (allVariables[i].getCref() == cref && allVariables[i].isTypeReal())
+    {
+      j = i;
+      break;
+    }
+  }
+
+  if (!fmu || j < 0)
+    return logError_UnknownSignal(getFullCref() + cref);
+
+  fmi3ValueReference vr = allVariables[j].getValueReferenceFMI3();
+  return getReal(vr, value, allVariables[j].getNumericType());
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getString(const fmi3ValueReference& vr, std::string& value)
+{
+  CallClock callClock(clock);
+  fmi3String str;
+
+  if (fmi3OK != fmi3_getString(fmu, &vr, 1, &str, 1))
+    return oms_status_error;
+
+  value = std::string(str);
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getString(const ComRef& cref, std::string& value)
+{
+  CallClock callClock(clock);
+
+  if (oms_modelState_virgin == getModel().getModelState())
+  {
+    // check for start values exist, priority over modeldescription.xml start values
+    if (values.hasResources())  // search in local resources
+    {
+      if (oms_status_ok == values.getStringResources(cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if (oms_status_ok == values.getStringFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else if (getParentSystem() && getParentSystem()->getValues().hasResources())  // search in root resources
+    {
+      if (oms_status_ok == getParentSystem()->getValues().getStringResources(getCref()+cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if(oms_status_ok == values.getStringFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())  // search in top level root resources
+    {
+      if (oms_status_ok == getParentSystem()->getParentSystem()->getValues().getStringResources(getCref()+cref, value, false, oms_modelState_virgin))
+      {
+        return oms_status_ok;
+      }
+      // search in modelDescription.xml
+      else if(oms_status_ok == values.getStringFromModeldescription(cref, value))
+      {
+        return oms_status_ok;
+      }
+
+      return logError("no start value set or available for signal: " + std::string(getFullCref() + cref));
+    }
+    else // search inline
+    {
+      // check for start values exist, priority over modeldescription.xml start values
+      if (oms_status_ok == values.getString(cref, value))
+      {
+        return oms_status_ok;
+      }
+      else
+      {
+        return values.getStringFromModeldescription(cref, value);
+      }
+    }
+  }
+
+  int j=-1;
+  for (size_t i = 0; i < allVariables.size(); i++)
+  {
+    if (allVariables[i].getCref() == cref && allVariables[i].isTypeString())
+    {
+      j = i;
+      break;
+    }
+  }
+
+  if (!fmu || j < 0)
+    return logError_UnknownSignal(getFullCref() + cref);
+
+  fmi3ValueReference vr = allVariables[j].getValueReferenceFMI3();
+  return getString(vr, value);
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getDirectionalDerivative(const ComRef& unknownCref, const ComRef& knownCref, double& value)
+{
+  if (!getModel().validState(oms_modelState_instantiated|oms_modelState_initialization|oms_modelState_simulation))
+    return logError_ModelInWrongState(getModel().getCref());
+
+  if (!getFMUInfo()->getProvidesDirectionalDerivative())
+    return logError("FMU \"" + std::string(getFullCref()) + "\" doesn't support directional derivatives (providesDirectionalDerivative = false in modelDescription.xml)");
+
+  int j = -1;
+  for (size_t i = 0; i < allVariables.size(); i++)
+  {
+    if (allVariables[i].getCref() == unknownCref && allVariables[i].isTypeReal())
+    {
+      j = i;
+      break;
+    }
+  }
+
+  // check for knownIndex, if provided
+  int knownIndex = -1;
+  if (!knownCref.isEmpty())
+  {
+    for (size_t i = 0; i < allVariables.size(); i++)
+    {
+      if (allVariables[i].getCref() == knownCref && allVariables[i].isTypeReal())
+      {
+        knownIndex = i;
+        break;
+      }
+    }
+  }
+
+  if (!fmu || j < 0)
+    return logError_UnknownSignal(getFullCref() + unknownCref);
+
+  // the model structure of FMI 3.0 refers to variables by value reference
+  const int vr = static_cast<int>(allVariables[j].getValueReferenceFMI3());
+
+  if (oms_modelState_instantiated == getModel().getModelState() || oms_modelState_initialization == getModel().getModelState())
+  {
+    // check index exist in ModelStructure inititalUnknowns
+    auto index = values.modelStructureInitialUnknowns.find(vr);
+    if (index == values.modelStructureInitialUnknowns.end())
+      return logError("Signal \"" + std::string(getFullCref() + unknownCref) + "\" could not be resolved to an <InitialUnknowns> index in <ModelStructure>");
+
+    //get dependencylist from <InitialUnknowns> in <ModelStructure>
+    if (oms_status_ok != getDirectionalDerivativeHeper(j, knownIndex, index->second, value))
+      return oms_status_error;
+  }
+
+  if (oms_modelState_simulation == getModel().getModelState())
+  {
+    if (!allVariables[j].isOutput() && !allVariables[j].isState() && !allVariables[j].isDer())
+      return logError("Signal \"" + std::string(getFullCref() + unknownCref) + "\" could not be resolved to an output or state or derivates after initalization");
+
+    // <Outputs>
+    if (allVariables[j].isOutput())
+    {
+      // check index exist in ModelStructure inititalUnknowns
+      auto index = values.modelStructureOutputs.find(vr);
+      if (index == values.modelStructureOutputs.end())
+        return logError("Signal \"" + std::string(getFullCref() + unknownCref) + "\" could not be resolved to an <Outputs> index in <ModelStructure>");
+
+      // get dependencylist from <Outputs> in <ModelStructure>
+      if (oms_status_ok != getDirectionalDerivativeHeper(j, knownIndex, index->second, value))
+        return oms_status_error;
+    }
+    // <Derivatives>
+    if (allVariables[j].isState() || allVariables[j].isDer())
+    {
+      // check index exist in ModelStructure inititalUnknowns
+      auto index = values.modelStructureDerivatives.find(vr);
+      if (index == values.modelStructureDerivatives.end())
+        return logError("Signal \"" + std::string(getFullCref() + unknownCref) + "\" could not be resolved to an <Derivatives> index in <ModelStructure>");
+
+      // get dependencylist from <Derivatives> in <ModelStructure>
+      if (oms_status_ok != getDirectionalDerivativeHeper(j, knownIndex, index->second, value))
+        return oms_status_error;
+    }
+  }
+
+  // fmi3ValueReference vr_unknown[1] = {5};
+  // fmi3ValueReference vr_known[4] = {0, 2, 3, 4};
+  // fmi2Real dvknown[4] = {1.0, 1.0, 1.0, 1.0};
+  // fmi2Real val;
+  // std::cout << "Get directional derivative_static_1: " << val << std::endl;
+  // fmi2_import_get_directional_derivative(fmu, vr_unknown, 1, vr_known, 4, dvknown, &val);
+  // std::cout << "\nGet directional derivative_static_2: " << val << std::endl;
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::prepareDirectionalDerivative(const std::vector<ComRef>& unknownCrefs, const std::vector<ComRef>& knownCrefs, int& index)
+{
+  if (!getFMUInfo()->getProvidesDirectionalDerivative())
+    return logError("FMU \"" + std::string(getFullCref()) + "\" doesn't support directional derivatives (providesDirectionalDerivative = false in modelDescription.xml)");
+
+  DirectionalDerivative_t dd;
+  dd.vrUnknown.reserve(unknownCrefs.size());
+  for (const ComRef& cref : unknownCrefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    dd.vrUnknown.push_back(var->getValueReferenceFMI3());
+  }
+  dd.vrKnown.reserve(knownCrefs.size());
+  for (const ComRef& cref : knownCrefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    dd.vrKnown.push_back(var->getValueReferenceFMI3());
+  }
+
+  // reuse an identical entry, e.g. if an algebraic loop is set up again
+  for (size_t i = 0; i < directionalDerivatives.size(); ++i)
+  {
+    if (directionalDerivatives[i].vrUnknown == dd.vrUnknown && directionalDerivatives[i].vrKnown == dd.vrKnown)
+    {
+      index = static_cast<int>(i);
+      return oms_status_ok;
+    }
+  }
+
+  index = static_cast<int>(directionalDerivatives.size());
+  directionalDerivatives.push_back(dd);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getDirectionalDerivative(int index, const double* seed, double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(directionalDerivatives.size()))
+    return logError_InternalError;
+
+  const DirectionalDerivative_t& dd = directionalDerivatives[index];
+  if (fmi3OK != fmi3_getDirectionalDerivative(fmu, dd.vrUnknown.data(), dd.vrUnknown.size(), dd.vrKnown.data(), dd.vrKnown.size(), seed, dd.vrKnown.size(), values, dd.vrUnknown.size()))
+    return logError_FMUCall("fmi3_getDirectionalDerivative", this);
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::prepareRealSignals(const std::vector<ComRef>& crefs, int& index)
+{
+  std::vector<unsigned int> indices;
+  indices.reserve(crefs.size());
+  for (const ComRef& cref : crefs)
+  {
+    int j = -1;
+    for (size_t i = 0; i < allVariables.size(); i++)
+    {
+      if (allVariables[i].getCref() == cref && allVariables[i].isTypeReal())
+      {
+        j = i;
+        break;
+      }
+    }
+    if (j < 0)
+      return logError_UnknownSignal(getFullCref() + cref);
+    if (allVariables[j].getNumericType() != oms_signal_numeric_type_FLOAT64 && allVariables[j].getNumericType() != oms_signal_numeric_type_FLOAT32)
+      return logError("Unsupported Numeric Type for var: \"" + std::string(cref.c_str()) + "\"");
+    indices.push_back(j);
+  }
+
+  for (size_t i = 0; i < realSignals.size(); ++i)
+  {
+    if (realSignals[i] == indices)
+    {
+      index = static_cast<int>(i);
+      return oms_status_ok;
+    }
+  }
+
+  index = static_cast<int>(realSignals.size());
+  realSignals.push_back(indices);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getRealSignals(int index, double* values)
+{
+  if (!fmu || index < 0 || index >= static_cast<int>(realSignals.size()))
+    return logError_InternalError;
+
+  const std::vector<unsigned int>& indices = realSignals[index];
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    const Variable& var = allVariables[indices[i]];
+    if (oms_status_ok != getReal(var.getValueReferenceFMI3(), values[i], var.getNumericType()))
+      return oms_status_error;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setRealSignals(int index, const double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(realSignals.size()))
+    return logError_InternalError;
+
+  const std::vector<unsigned int>& indices = realSignals[index];
+  for (size_t i = 0; i < indices.size(); ++i)
+  {
+    const Variable& var = allVariables[indices[i]];
+    fmi3ValueReference vr = var.getValueReferenceFMI3();
+    if (oms_signal_numeric_type_FLOAT64 == var.getNumericType())
+    {
+      if (fmi3OK != fmi3_setFloat64(fmu, &vr, 1, &values[i], 1))
+        return oms_status_error;
+    }
+    else
+    {
+      float value_ = static_cast<float>(values[i]);
+      if (fmi3OK != fmi3_setFloat32(fmu, &vr, 1, &value_, 1))
+        return oms_status_error;
+    }
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getDirectionalDerivativeHeper(const int unknownIndex, const int knownIndex, const std::vector<int> &dependencyList, double &value)
+{
+  fmi3ValueReference vr_unknown = allVariables[unknownIndex].getValueReferenceFMI3();
+  vrKnownBuffer.resize(dependencyList.size());
+  seedBuffer.resize(dependencyList.size());
+
+  // the dependencies are value references
+  for (size_t i = 0; i < dependencyList.size(); i++)
+  {
+    vrKnownBuffer[i] = static_cast<fmi3ValueReference>(dependencyList[i]);
+
+    // The knownIndex is < 0 if not specified. In this case, we
+    // calculate the sum of the row, which means we set all seed
+    // values to 1.0. Otherwise we just set the explicitly provided
+    // element to 1.0.
+    if (knownIndex < 0 || vrKnownBuffer[i] == allVariables[knownIndex].getValueReferenceFMI3())
+      seedBuffer[i] = 1.0;
+    else
+      seedBuffer[i] = 0.0;
+  }
+
+  fmi3Status fmistatus = fmi3_getDirectionalDerivative(fmu, &vr_unknown, 1, vrKnownBuffer.data(), vrKnownBuffer.size(), seedBuffer.data(), seedBuffer.size(), &value, 1);
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_getDirectionalDerivative", this);
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setBoolean(const ComRef& cref, bool value)
+{
+  CallClock callClock(clock);
+  int j=-1;
+  for (size_t i = 0; i < allVariables.size(); i++)
+  {
+    if (allVariables[i].getCref() == cref && allVariables[i].isTypeBoolean())
+    {
+      j = i;
+      break;
+    }
+  }
+
+  if (!fmu || j < 0)
+    return logError_UnknownSignal(getFullCref() + cref);
+
+  if (oms_modelState_virgin == getModel().getModelState())
+  {
+    values.updateModelDescriptionBooleanStartValue(cref, value);
+    // check for local resources available
+    if (values.hasResources())
+    {
+      return values.setBooleanResources(cref, value, getFullCref(), false, oms_modelState_virgin);
+    }
+    // check for resources in root
+    else if (getParentSystem() && getParentSystem()->getValues().hasResources())
+    {
+      return getParentSystem()->getValues().setBooleanResources(getCref()+cref, value, getParentSystem()->getFullCref(), false, oms_modelState_virgin);
+    }
+    // check for resources in top level root
+    else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())
+    {
+      return getParentSystem()->getParentSystem()->getValues().setBooleanResources(getCref()+cref, value, getParentSystem()->getParentSystem()->getFullCref(), false, oms_modelState_virgin);
+    }
+    else
+    {
+      //inline parameter settings
+      values.setBoolean(cref, value);
+    }
+  }
+  else
+  {
+    fmi3ValueReference vr = allVariables[j].getValueReferenceFMI3();
+    // int value_ = value ? 1 : 0;
+    if (fmi3OK != fmi3_setBoolean(fmu, &vr, 1, &value, 1))
+      return oms_status_error;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setInteger(const ComRef& cref, int value)
+{
+  CallClock callClock(clock);
+  int j=-1;
+  for (size_t i = 0; i < allVariables.size(); i++)
+  {
+    if (allVariables[i].getCref() == cref && allVariables[i].isTypeInteger())
+    {
+      j = i;
+      break;
+    }
+  }
+
+  if (!fmu || j < 0)
+    return logError_UnknownSignal(getFullCref() + cref);
+
+  if (oms_modelState_virgin == getModel().getModelState())
+  {
+    // update start values in top level Modeldescription.xml to be exported in ssv templates
+    values.updateModelDescriptionIntegerStartValue(cref, value);
+    // check for local resources available
+    if (values.hasResources())
+    {
+      return values.setIntegerResources(cref, value, getFullCref(), false, oms_modelState_virgin);
+    }
+    // check for resources in root
+    else if (getParentSystem() && getParentSystem()->getValues().hasResources())
+    {
+      return getParentSystem()->getValues().setIntegerResources(getCref()+cref, value, getParentSystem()->getFullCref(), false, oms_modelState_virgin);
+    }
+    // check for resources in top level root
+    else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())
+    {
+      return getParentSystem()->getParentSystem()->getValues().setIntegerResources(getCref()+cref, value, getParentSystem()->getParentSystem()->getFullCref(), false, oms_modelState_virgin);
+    }
+    else
+    {
+      //inline parameter settings
+      values.setInteger(cref, value);
+    }
+  }
+  else
+  {
+    fmi3ValueReference vr = allVariables[j].getValueReferenceFMI3();
+    int64_t value64;
+    int16_t value16;
+    int8_t value8;
+    uint64_t valueU64;
+    uint32_t valueU32;
+    uint16_t valueU16;
+    uint8_t valueU8;
+    switch (allVariables[j].getNumericType())
+    {
+      case oms_signal_numeric_type_INT64:
+      {
+        value64 = static_cast<int>(value); // Cast to int
+        if (fmi3OK != fmi3_setInt64(fmu, &vr, 1, &value64, 1))
+          return oms_status_error;
+        break;
+      }
+      case oms_signal_numeric_type_INT32:
+      {
+        if (fmi3OK != fmi3_setInt32(fmu, &vr, 1, &value, 1))
+          return oms_status_error;
+        break;
+      }
+      case oms_signal_numeric_type_INT16:
+      {
+        value16 = static_cast<int>(value);
+        if (fmi3OK != fmi3_setInt16(fmu, &vr, 1, &value16, 1))
+          return oms_status_error;
+        break;
+      }
+
+      case oms_signal_numeric_type_INT8:
+      {
+        value8 = static_cast<int>(value);
+        if (fmi3OK != fmi3_setInt8(fmu, &vr, 1, &value8, 1))
+          return oms_status_error;
+        break;
+      }
+      case oms_signal_numeric_type_UINT64:
+      {
+        valueU64 = static_cast<int>(value);
+        if (fmi3OK != fmi3_setUInt64(fmu, &vr, 1, &valueU64, 1))
+          return oms_status_error;
+        break;
+      }
+      case oms_signal_numeric_type_UINT32:
+      {
+        valueU32 = static_cast<int>(value);
+        if (fmi3OK != fmi3_setUInt32(fmu, &vr, 1, &valueU32, 1))
+          return oms_status_error;
+        break;
+      }
+      case oms_signal_numeric_type_UINT16:
+      {
+        valueU16 = static_cast<int>(value);
+        if (fmi3OK != fmi3_setUInt16(fmu, &vr, 1, &valueU16, 1))
+          return oms_status_error;
+        break;
+      }
+      case oms_signal_numeric_type_UINT8:
+      {
+        valueU8 = static_cast<int>(value);
+        if (fmi3OK != fmi3_setUInt8(fmu, &vr, 1, &valueU8, 1))
+          return oms_status_error;
+        break;
+      }
+      default:
+        return logError("Unsupported Numeric Type for var: \"" + std::string(cref.c_str()) + "\"");
+      }
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setReal(const ComRef& cref, double value)
+{
+  CallClock callClock(clock);
+  int j=-1;
+  for (size_t i = 0; i < allVariables.size(); i++)
+  {
+    if (allVariables[i].getCref() == cref && allVariables[i].isTypeReal())
+    {
+      j = i;
+      break;
+    }
+  }
+
+  if (!fmu || j < 0)
+    return logError_UnknownSignal(getFullCref() + cref);
+
+  if (getModel().validState(oms_modelState_virgin|oms_modelState_enterInstantiation|oms_modelState_instantiated))
+    if (allVariables[j].isCalculated() || allVariables[j].isIndependent())
+      return logWarning("It is not allowed to provide a start value if initial=\"calculated\" or causality=\"independent\".");
+
+  if (oms_modelState_virgin == getModel().getModelState())
+  {
+    // update start values in top level Modeldescription.xml to be exported in ssv templates
+    values.updateModelDescriptionRealStartValue(cref, value);
+    // check for local resources available
+    if (values.hasResources())
+    {
+      values.copyModelDescriptionUnitToResources(values);
+      return values.setRealResources(cref, value, getFullCref(), false, oms_modelState_virgin);
+    }
+    // check for resources in root
+    else if (getParentSystem() && getParentSystem()->getValues().hasResources())
+    {
+      getParentSystem()->getValues().copyModelDescriptionUnitToResources(values);
+      return getParentSystem()->getValues().setRealResources(getCref()+cref, value, getParentSystem()->getFullCref(), false, oms_modelState_virgin);
+    }
+    // check for resources in top level root
+    else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())
+    {
+      getParentSystem()->getParentSystem()->getValues().copyModelDescriptionUnitToResources(values);
+      return getParentSystem()->getParentSystem()->getValues().setRealResources(getCref()+cref, value, getParentSystem()->getParentSystem()->getFullCref(), false, oms_modelState_virgin);
+    }
+    else
+    {
+      //inline parameter settings
+      values.setReal(cref, value);
+    }
+  }
+  else
+  {
+    fmi3ValueReference vr = allVariables[j].getValueReferenceFMI3();
+    switch (allVariables[j].getNumericType())
+    {
+      case oms_signal_numeric_type_FLOAT64:
+      {
+        if (fmi3OK != fmi3_setFloat64(fmu, &vr, 1, &value, 1))
+          return oms_status_error;
+        break;
+      }
+      case oms_signal_numeric_type_FLOAT32:
+      {
+        float value_= static_cast<float>(value);
+        if (fmi3OK != fmi3_setFloat32(fmu, &vr, 1, &value_, 1))
+          return oms_status_error;
+        break;
+      }
+      default:
+        return logError("Unsupported Numeric Type for var: \"" + std::string(cref.c_str()) + "\"");
+    }
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setString(const ComRef& cref, const std::string& value)
+{
+  CallClock callClock(clock);
+  int j=-1;
+  for (size_t i = 0; i < allVariables.size(); i++)
+  {
+    if (allVariables[i].getCref() == cref && allVariables[i].isTypeString())
+    {
+      j = i;
+      break;
+    }
+  }
+
+  if (!fmu || j < 0)
+    return logError_UnknownSignal(getFullCref() + cref);
+
+  if (getModel().validState(oms_modelState_virgin|oms_modelState_enterInstantiation|oms_modelState_instantiated))
+    if (allVariables[j].isCalculated() || allVariables[j].isIndependent())
+      return logWarning("It is not allowed to provide a start value if initial=\"calculated\" or causality=\"independent\".");
+
+  if (oms_modelState_virgin == getModel().getModelState())
+  {
+    values.updateModelDescriptionStringStartValue(cref, value);
+    // check for local resources available
+    if (values.hasResources())
+    {
+      return values.setStringResources(cref, value, getFullCref(), false, oms_modelState_virgin);
+    }
+    // check for resources in root
+    else if (getParentSystem() && getParentSystem()->getValues().hasResources())
+    {
+      return getParentSystem()->getValues().setStringResources(getCref()+cref, value, getParentSystem()->getFullCref(), false, oms_modelState_virgin);
+    }
+    // check for resources in top level root
+    else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())
+    {
+      return getParentSystem()->getParentSystem()->getValues().setStringResources(getCref()+cref, value, getParentSystem()->getParentSystem()->getFullCref(), false, oms_modelState_virgin);
+    }
+    else
+    {
+      //inline parameter settings
+      values.setString(cref, value);
+    }
+  }
+  else
+  {
+    fmi3ValueReference vr = allVariables[j].getValueReferenceFMI3();
+    fmi3String value_ = value.c_str();
+    if (fmi3OK != fmi3_setString(fmu, &vr, 1, &value_, 1))
+      return oms_status_error;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setUnit(const ComRef &cref, const std::string &value)
+{
+  // set units to connectors
+  for (auto &connector : connectors)
+  {
+    if (connector)
+    {
+      if (connector->getName() == cref)
+      {
+        connector->connectorUnits.clear();
+        connector->connectorUnits[value] = {};
+      }
+    }
+  }
+
+  // set unit in top level modeldescription.xml
+  values.updateModelDescriptionVariableUnit(cref, value);
+
+  // check for local resources available
+  if (values.hasResources())
+  {
+    return values.setUnitResources(cref, value, getFullCref());
+  }
+  // check for resources in root
+  else if (getParentSystem() && getParentSystem()->getValues().hasResources())
+  {
+    return getParentSystem()->getValues().setUnitResources(getCref() + cref, value, getParentSystem()->getFullCref());
+  }
+  // check for resources in top level root
+  else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())
+  {
+    return getParentSystem()->getParentSystem()->getValues().setUnitResources(getCref() + cref, value, getParentSystem()->getParentSystem()->getFullCref());
+  }
+  else
+  {
+    // inline unit settings
+    values.setUnit(cref, value);
+  }
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::deleteStartValue(const ComRef& cref)
+{
+  // check for local resources
+  if (values.hasResources())
+  {
+    return values.deleteStartValueInResources(cref);
+  }
+  // check for resources in root
+  else if (getParentSystem() && getParentSystem()->getValues().hasResources())
+  {
+    return getParentSystem()->getValues().deleteStartValueInResources(getCref()+cref);
+  }
+  // check for resources in top level root
+  else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())
+  {
+    return getParentSystem()->getParentSystem()->getValues().deleteStartValueInResources(getCref()+cref);
+  }
+  else
+  {
+    return values.deleteStartValue(cref);
+  }
+
+  return oms_status_error;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setValuesResources(Values& values)
+{
+  // set all ssv and ssm resources from the old component to replacing component
+  this->values.parameterResources = values.parameterResources;
+  // set all user define values from the old component to replacing component as user defined values have higher priority
+  // over modeldescription.xml
+  this->values.realStartValues = values.realStartValues;
+  this->values.integerStartValues = values.integerValues;
+  this->values.booleanStartValues = values.booleanStartValues;
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::updateOrDeleteStartValueInReplacedComponent(std::vector<std::string>& warningList)
+{
+  // check for local resources available
+  if (values.hasResources())
+  {
+    return values.updateOrDeleteStartValueInReplacedComponent(values, this->getCref(), warningList);
+  }
+  // check for resources in root
+  else if (getParentSystem() && getParentSystem()->getValues().hasResources())
+  {
+    return getParentSystem()->getValues().updateOrDeleteStartValueInReplacedComponent(values, this->getCref(), warningList);
+  }
+  // check for resources in top level root
+  else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())
+  {
+    return getParentSystem()->getParentSystem()->getValues().updateOrDeleteStartValueInReplacedComponent(values, this->getCref(), warningList);
+  }
+  else
+  {
+    // inline parameter settings, no need to update the values
+    return oms_status_ok;
+  }
+
+  return oms_status_error;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::registerSignalsForResultFile(ResultWriter& resultFile)
+{
+  resultFileMapping.clear();
+
+  if (Flags::WallTime())
+    clock_id = resultFile.addSignal(std::string(getFullCref() + ComRef("$wallTime")), "wall-clock time [s]", SignalType_REAL);
+  else
+    clock_id = 0;
+
+  for (unsigned int i=0; i<allVariables.size(); ++i)
+  {
+    if (!exportVariables[i])
+      continue;
+
+    auto const &var = allVariables[i];
+    std::string name;
+    // check for exportName, to be used in result file to map the variable to the correct signal in ssp
+    if (!exportName.empty())
+      name = std::string(ComRef(exportName) + var.getCref());
+    else
+      name = std::string(getFullCref() + var.getCref());
+    const std::string& description = var.getDescription();
+    if (var.isParameter())
+    {
+      SignalValue_t value;
+      if (var.isTypeReal())
+      {
+        getReal(var.getCref(), value.realValue);
+        resultFile.addParameter(name, description, SignalType_REAL, value);
+      }
+      else if (var.isTypeInteger())
+      {
+        getInteger(var.getCref(), value.intValue);
+        resultFile.addParameter(name, description, SignalType_INT, value);
+      }
+      else if (var.isTypeBoolean())
+      {
+        getBoolean(var.getCref(), value.boolValue);
+        resultFile.addParameter(name, description, SignalType_BOOL, value);
+      }
+      else
+        logInfo("Parameter " + name + " will not be stored in the result file, because the signal type is not supported");
+    }
+    else
+    {
+      if (var.isTypeReal())
+      {
+        unsigned int ID = resultFile.addSignal(name, description, SignalType_REAL);
+        resultFileMapping[ID] = i;
+      }
+      else if (var.isTypeInteger())
+      {
+        unsigned int ID = resultFile.addSignal(name, description, SignalType_INT);
+        resultFileMapping[ID] = i;
+      }
+      else if (var.isTypeBoolean())
+      {
+        unsigned int ID = resultFile.addSignal(name, description, SignalType_BOOL);
+        resultFileMapping[ID] = i;
+      }
+      else
+        logInfo("Variable " + name + " will not be stored in the result file, because the signal type is not supported");
+    }
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::updateSignals(ResultWriter& resultWriter)
+{
+  CallClock callClock(clock);
+
+  if (clock_id)
+  {
+    SignalValue_t wallTime;
+    wallTime.realValue = clock.getElapsedWallTime();
+    resultWriter.updateSignal(clock_id, wallTime);
+  }
+
+  for (auto const &it : resultFileMapping)
+  {
+    unsigned int ID = it.first;
+    Variable& var = allVariables[it.second];
+    fmi3ValueReference vr = var.getValueReferenceFMI3();
+    SignalValue_t value;
+    if (var.isTypeReal())
+    {
+      if (oms_status_ok != getReal(vr, value.realValue, var.getNumericType()))
+        return logError("failed to fetch variable " + std::string(var.getCref()));
+      resultWriter.updateSignal(ID, value);
+    }
+    else if (var.isTypeInteger())
+    {
+      if (oms_status_ok != getInteger(vr, value.intValue, var.getNumericType()))
+        return logError("failed to fetch variable " + std::string(var.getCref()));
+      resultWriter.updateSignal(ID, value);
+    }
+    else if (var.isTypeBoolean())
+    {
+      if (oms_status_ok != getBoolean(vr, value.boolValue))
+        return logError("failed to fetch variable " + std::string(var.getCref()));
+      resultWriter.updateSignal(ID, value);
+    }
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getContinuousStates(double* states)
+{
+  CallClock callClock(clock);
+  fmi3Status fmistatus = fmi3_getContinuousStates(fmu, states, getNumberOfContinuousStates());
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_getContinuousStates", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::setContinuousStates(double* states)
+{
+  CallClock callClock(clock);
+  fmi3Status fmistatus = fmi3_setContinuousStates(fmu, states, getNumberOfContinuousStates());
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_setContinuousStates", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getDerivatives(double* derivatives)
+{
+  CallClock callClock(clock);
+  fmi3Status fmistatus = fmi3_getContinuousStateDerivatives(fmu, derivatives, getNumberOfContinuousStates());
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_getContinuousStateDerivatives", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getNominalsOfContinuousStates(double* nominals)
+{
+  CallClock callClock(clock);
+  fmi3Status fmistatus = fmi3_getNominalsOfContinuousStates(fmu, nominals, getNumberOfContinuousStates());
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_getNominalsOfContinuousStates", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getEventindicators(double* eventindicators)
+{
+  CallClock callClock(clock);
+  fmi3Status fmistatus = fmi3_getEventIndicators(fmu, eventindicators, nEventIndicators);
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_getEventIndicators", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::getStateDirectionalDerivative(const int* states, size_t nStates, const double* seed, double* values)
+{
+  CallClock callClock(clock);
+
+  if (vrStates.empty())
+  {
+    for (const auto& i : derivatives)
+    {
+      vrStates.push_back(static_cast<fmi3ValueReference>(allVariables[i].getStateIndex()));
+      vrDerivatives.push_back(allVariables[i].getValueReferenceFMI3());
+    }
+  }
+
+  vrKnownStates.resize(nStates);
+  for (size_t k = 0; k < nStates; ++k)
+    vrKnownStates[k] = vrStates[states[k]];
+
+  fmi3Status fmistatus = fmi3_getDirectionalDerivative(fmu, vrDerivatives.data(), vrDerivatives.size(), vrKnownStates.data(), nStates, seed, nStates, values, vrDerivatives.size());
+  if (fmi3OK != fmistatus)
+    return logError_FMUCall("fmi3_getDirectionalDerivative", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::addSignalsToResults(const char* regex)
+{
+  std::regex exp(regex);
+  for (unsigned int i=0; i<allVariables.size(); ++i)
+  {
+    if (exportVariables[i])
+      continue;
+
+    auto const &var = allVariables[i];
+    if(regex_match(std::string(getFullCref() + var.getCref()), exp))
+    {
+      //logInfo("added \"" + std::string(getFullCref() + var.getCref()) + "\" to results");
+      exportVariables[i] = true;
+    }
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::removeSignalsFromResults(const char* regex)
+{
+  std::regex exp(regex);
+  for (unsigned int i=0; i<allVariables.size(); ++i)
+  {
+    if (!exportVariables[i])
+      continue;
+
+    auto const &var = allVariables[i];
+    if(regex_match(std::string(getFullCref() + var.getCref()), exp))
+    {
+      //logInfo("removed \"" + std::string(getFullCref() + var.getCref()) + "\" from results");
+      exportVariables[i] = false;
+    }
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::serializeState(Checkpoint& checkpoint)
+{
+  fmi3FMUState state = NULL;
+  fmi3Status fmistatus = fmi3_getFMUState(fmu, &state);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_getFMUState", this);
+
+  size_t size = 0;
+  std::vector<fmi3Byte> buffer;
+  fmistatus = fmi3_serializedFMUStateSize(fmu, state, &size);
+  if (fmi3OK == fmistatus)
+  {
+    buffer.resize(size);
+    fmistatus = fmi3_serializeFMUState(fmu, state, buffer.data(), size);
+  }
+  fmi3_freeFMUState(fmu, &state);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_serializeFMUState", this);
+
+  checkpoint.writeValue(eventInfo);
+  checkpoint.writeBlock(buffer.data(), buffer.size());
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::deserializeState(Checkpoint& checkpoint)
+{
+  std::vector<char> buffer;
+  if (!checkpoint.readValue(eventInfo) || !checkpoint.readBlock(buffer))
+    return logError("Checkpoint doesn't match " + std::string(getFullCref()));
+
+  fmi3FMUState state = NULL;
+  fmi3Status fmistatus = fmi3_deserializeFMUState(fmu, (const fmi3Byte*)buffer.data(), buffer.size(), &state);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_deserializeFMUState", this);
+
+  fmistatus = fmi3_setFMUState(fmu, state);
+  fmi3_freeFMUState(fmu, &state);
+  if (fmi3OK != fmistatus) return logError_FMUCall("fmi3_setFMUState", this);
+
+  return oms_status_ok;
+}
+
+void oms::ComponentFMU3ME::getFilteredSignals(std::vector<Connector>& filteredSignals) const
+{
+  for (unsigned int i = 0; i < allVariables.size(); ++i)
+  {
+    if (exportVariables[i])
+      filteredSignals.push_back(allVariables[i].makeConnector(this->getFullCref()));
+  }
+}
+
+oms_status_enu_t oms::ComponentFMU3ME::renameValues(const ComRef& oldCref, const ComRef& newCref)
+{
+  // check for local resources
+  if (values.hasResources())
+  {
+    return values.renameInResources(oldCref, newCref);
+  }
+  // check for resources in root
+  else if (getParentSystem() && getParentSystem()->getValues().hasResources())
+  {
+    return getParentSystem()->getValues().renameInResources(oldCref, newCref);
+  }
+  // check for resources in top level root
+  else if (getParentSystem()->getParentSystem() && getParentSystem()->getParentSystem()->getValues().hasResources())
+  {
+    return getParentSystem()->getParentSystem()->getValues().renameInResources(oldCref, newCref);
+  }
+  else
+  {
+    return values.rename(oldCref, newCref);
+  }
+
+  return oms_status_error;
+}
@@ -0,0 +1,181 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef _OMS_COMPONENT_FMU_3_ME_H_
+#define _OMS_COMPONENT_FMU_3_ME_H_
+
+#include "ComponentFMUMEBase.h"
+#include "ComRef.h"
+#include "ResultWriter.h"
+#include "Snapshot.h"
+#include "Values.h"
+#include "Variable.h"
+
+#include <fmi4c.h>
+#include <map>
+#include <pugixml.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cmath>
+
+namespace oms
+{
+  class System;
+
+  class ComponentFMU3ME : public ComponentFMUMEBase
+  {
+  public:
+    ~ComponentFMU3ME();
+
+    static Component* NewComponent(const ComRef& cref, System* parentSystem, const std::string& fmuPath, std::string replaceComponent = "");
+    static Component* NewComponent(const pugi::xml_node& node, System* parentSystem, const std::string& sspVersion, const Snapshot& snapshot, std::string variantName);
+
+    oms_status_enu_t exportToSSD(pugi::xml_node& node, Snapshot& snapshot, std::string variantName) const;
+    oms_status_enu_t exportToSSV(pugi::xml_node& ssvNode);
+    void getFilteredUnitDefinitionsToSSD(std::map<std::string, std::map<std::string, std::string>>& unitDefinitions);
+    void getFilteredEnumerationDefinitionsToSSD(std::map<std::string, std::map<std::string, std::string>>& enumerationDefinitions);
+    oms_status_enu_t exportToSSVTemplate(pugi::xml_node& ssvNode, Snapshot& snapshot);
+    oms_status_enu_t exportToSSMTemplate(pugi::xml_node& ssmNode);
+    oms_status_enu_t instantiate();
+    oms_status_enu_t initialize();
+    oms_status_enu_t terminate();
+    oms_status_enu_t reset();
+
+    Variable* getVariable(const ComRef& cref);
+
+    Values& getValues() { return values; }
+    oms_status_enu_t setValuesResources(Values& values);
+
+    oms_status_enu_t getBoolean(const ComRef& cref, bool& value);
+    oms_status_enu_t getBoolean(const fmi3ValueReference& vr, bool& value);
+    oms_status_enu_t getInteger(const ComRef& cref, int& value);
+    oms_status_enu_t getInteger(const fmi3ValueReference& vr, int& value, oms_signal_numeric_type_enu_t numericType);
+    oms_status_enu_t getReal(const ComRef& cref, double& value);
+    oms_status_enu_t getReal(const fmi3ValueReference& vr, double& value, oms_signal_numeric_type_enu_t numericType);
+    oms_status_enu_t getString(const ComRef& cref, std::string& value);
+    oms_status_enu_t getString(const fmi3ValueReference& vr, std::string& value);
+    oms_status_enu_t setBoolean(const ComRef& cref, bool value);
+    oms_status_enu_t setInteger(const ComRef& cref, int value);
+    oms_status_enu_t setReal(const ComRef& cref, double value);
+    oms_status_enu_t setString(const ComRef& cref, const std::string& value);
+    oms_status_enu_t setUnit(const ComRef& cref, const std::string& value);
+    oms_status_enu_t setTime(double time);
+
+    oms_status_enu_t getDirectionalDerivative(const ComRef& unknownCref, const ComRef& knownCref, double& value);
+    oms_status_enu_t prepareDirectionalDerivative(const std::vector<ComRef>& unknownCrefs, const std::vector<ComRef>& knownCrefs, int& index);
+    oms_status_enu_t getDirectionalDerivative(int index, const double* seed, double* values);
+    oms_status_enu_t prepareRealSignals(const std::vector<ComRef>& crefs, int& index);
+    oms_status_enu_t getRealSignals(int index, double* values);
+    oms_status_enu_t setRealSignals(int index, const double* values);
+    oms_status_enu_t getDirectionalDerivativeHeper(const int unknownIndex, const int knownindex, const std::vector<int>& dependencyList, double& value);
+
+    oms_status_enu_t deleteStartValue(const ComRef& cref);
+    oms_status_enu_t updateOrDeleteStartValueInReplacedComponent(std::vector<std::string>& warningList);
+
+    oms_status_enu_t doEventIteration();
+    oms_status_enu_t enterEventMode();
+    oms_status_enu_t enterContinuousTimeMode();
+    oms_status_enu_t completedIntegratorStep(fmi2Boolean& callEventUpdate, fmi2Boolean& terminateSimulation);
+
+    oms_status_enu_t getContinuousStates(double* states);
+    oms_status_enu_t setContinuousStates(double* states);
+    oms_status_enu_t getDerivatives(double* derivatives);
+    oms_status_enu_t getNominalsOfContinuousStates(double* nominals);
+    oms_status_enu_t getEventindicators(double* eventindicators);
+    oms_status_enu_t getStateDirectionalDerivative(const int* states, size_t nStates, const double* seed, double* values);
+
+    std::vector<Variable> getAllVariables() {return allVariables;}
+
+    oms_status_enu_t registerSignalsForResultFile(ResultWriter& resultFile);
+    oms_status_enu_t updateSignals(ResultWriter& resultWriter);
+    oms_status_enu_t addSignalsToResults(const char* regex);
+    oms_status_enu_t removeSignalsFromResults(const char* regex);
+
+    bool getCanGetAndSetState() {return getFMUInfo()->getCanGetAndSetFMUstate();}
+    bool getCanSerializeState() {return getFMUInfo()->getCanSerializeFMUstate();}
+    oms_status_enu_t serializeState(Checkpoint& checkpoint);
+    oms_status_enu_t deserializeState(Checkpoint& checkpoint);
+
+    void getFilteredSignals(std::vector<Connector>& filteredSignals) const;
+
+    oms_status_enu_t newResources(const std::string& ssvFilename, const std::string& ssmFilename, bool externalResources);
+    oms_status_enu_t setResourcesHelper1(Values value);
+    oms_status_enu_t setResourcesHelper2(Values value);
+    void applyStartValues();
+    oms_status_enu_t setExportName(const std::string & exportName) { this->exportName = exportName; return oms_status_ok;};
+    std::string getExportName() const { return this->exportName; }
+    oms_status_enu_t deleteReferencesInSSD(const std::string& filename);
+    oms_status_enu_t deleteResourcesInSSP(const std::string& filename);
+    void copyModelDescriptionUnit(Values& value);
+
+  protected:
+    ComponentFMU3ME(const ComRef& cref, System* parentSystem, const std::string& fmuPath);
+
+    // stop the compiler generating methods copying the object
+    ComponentFMU3ME(ComponentFMU3ME const& copy);            ///< not implemented
+    ComponentFMU3ME& operator=(ComponentFMU3ME const& copy); ///< not implemented
+
+    oms_status_enu_t renameValues(const ComRef& oldCref, const ComRef& newCref);
+
+    void dumpInitialUnknowns();
+
+    int getModelStructureReference(unsigned int index) const;
+    bool getVariableIndex(int reference, unsigned int& index) const;
+
+  private:
+    fmi3LogMessageCallback omsfmi3logger;
+    std::string exportName; ///< export name for the component, used in the result file
+
+    std::unordered_map<unsigned int /*result file var ID*/, unsigned int /*allVariables ID*/> resultFileMapping;
+    std::unordered_map<fmi3ValueReference, unsigned int /*allVariables ID*/> variableIndices;
+
+    /**
+     * @brief Value references of a directional derivative prepared with prepareDirectionalDerivative().
+     */
+    struct DirectionalDerivative_t
+    {
+      std::vector<fmi3ValueReference> vrUnknown;
+      std::vector<fmi3ValueReference> vrKnown;
+    };
+    std::vector<DirectionalDerivative_t> directionalDerivatives;
+    std::vector<std::vector<unsigned int>> realSignals; ///< allVariables indices of signals prepared with prepareRealSignals()
+    std::vector<fmi3ValueReference> vrKnownBuffer; ///< scratch buffer of getDirectionalDerivativeHeper
+    std::vector<fmi3Float64> seedBuffer;   ///< scratch buffer of getDirectionalDerivativeHeper
+    std::vector<fmi3ValueReference> vrStates;      ///< value references of the continuous states, resolved on first use
+    std::vector<fmi3ValueReference> vrDerivatives; ///< value references of the state derivatives, resolved on first use
+    std::vector<fmi3ValueReference> vrKnownStates; ///< scratch buffer of getStateDirectionalDerivative
+
+    oms::ComRef getValidCref(ComRef cref);
+  };
+}
+
+#endif
@@ -76,10 +76,7 @@ oms::Component* oms::ComponentFMUCS::NewComponent(const oms::ComRef& cref, oms::
 
   // replaceComponent string will be used to avoid name conflicts when replacing a fmu with oms_replaceSubModel(), the default is ""
 
-  filesystem::path temp_root(parentSystem->getModel().getTempDirectory());
-  filesystem::path temp_temp = temp_root / "temp";
   filesystem::path relFMUPath = parentSystem->copyResources() ? (filesystem::path("resources") / (parentSystem->getUniqueID() + "_" + replaceComponent + std::string(cref) + ".fmu")) : filesystem::path(fmuPath);
-  filesystem::path absFMUPath = temp_root / relFMUPath;
 
   ComponentFMUCS* component = new ComponentFMUCS(cref, parentSystem, relFMUPath.generic_string());
 
@@ -97,50 +94,21 @@ oms::Component* oms::ComponentFMUCS::NewComponent(const oms::ComRef& cref, oms::
   else
     modelDescriptionPath = parentSystem->getModel().getTempDirectory() / filesystem::path(fmuPath);
 
-  component->values.parseModelDescription(modelDescriptionPath, guid_);
-
-  /*
-   * check if instance of an fmu already exist by using guid of the fmu
-   * if instance exist use the existing instance path
-   * eg: tank1 => resources /0001_tank1.fmu
-   *     tank2 => resources /0001_tank1.fmu
-  */
-  auto it = parentSystem->fmuGuid.find(guid_);
-  if (it == parentSystem->fmuGuid.end())
-    parentSystem->fmuGuid[guid_] = relFMUPath;
+  // a clone takes over the parsed modelDescription.xml and the unpacked fmu of its source component
+  const ComponentFMUCS* source = dynamic_cast<const ComponentFMUCS*>(component->getCloneSource());
+  if (source)
+    component->values.copyModelDescription(source->values);
   else
-  {
-    // instance exists and update the FMU path to already existing instance
-    relFMUPath = parentSystem->fmuGuid[guid_];
-    absFMUPath = temp_root / relFMUPath;
-    component->setPath(relFMUPath.generic_string());
-  }
-
-  // Copy the resource to the temp directory of the model? We don't want have
-  // to copy resources if importing an SSP file or snapshot.
-  if (parentSystem->copyResources() && !filesystem::exists(absFMUPath))
-    oms_copy_file(filesystem::path(fmuPath), absFMUPath);
+    component->values.parseModelDescription(modelDescriptionPath, guid_);
 
-  // set temp directory
-  filesystem::path tempDir = temp_temp / relFMUPath.stem();
-  component->setTempDir(tempDir.string());
-
-  bool dirExist = true;
-  if (!filesystem::is_directory(tempDir))
+  if (oms_status_ok != component->unpackFMU(guid_, modelDescriptionPath.string(), source))
   {
-    dirExist = false;
-    if (!filesystem::create_directory(tempDir))
-    {
-      logError("Creating temp directory for component \"" + std::string(cref) + "\" failed");
-      return NULL;
-    }
+    delete component;
+    return NULL;
   }
 
-  // unpack the fmu in temp directory
-  oms::Scope::miniunz(modelDescriptionPath.generic_string().c_str(), tempDir.generic_string().c_str());
-
   // load the unpacked fmu and parse modelDescription.xml
-  component->fmu = fmi4c_loadUnzippedFmu(cref.c_str(), tempDir.generic_string().c_str());
+  component->fmu = fmi4c_loadUnzippedFmu(cref.c_str(), filesystem::path(component->getTempDir()).generic_string().c_str());
   if (!component->fmu)
   {
     logError("Error parsing modelDescription.xml");
@@ -587,15 +555,14 @@ oms_status_enu_t oms::ComponentFMUCS::initializeDependencyGraph_outputs()
   return oms_status_ok;
 }
 
-oms_status_enu_t oms::ComponentFMUCS::instantiate()
+/**
+ * @brief Sets the start values of the SSV resources or inline values in the FMU.
+ *
+ * Called after instantiation and again after fmi reset, which restores the
+ * start values of the modelDescription.xml.
+ */
+void oms::ComponentFMUCS::applyStartValues()
 {
-  if (!fmi2_instantiate(fmu, fmi2CoSimulation, omsfmi2logger, calloc, free, NULL, NULL, fmi2True, fmi2True))
-  {
-    logInfo("fmi2Instantiate() failed");
-    exit(1);
-  }
-  //logInfo("instantiation successfull");
-
   // set start values from local resources
   if (values.hasResources())
   {
@@ -631,6 +598,18 @@ oms_status_enu_t oms::ComponentFMUCS::instantiate()
   {
     setResourcesHelper1(values);
   }
+}
+
+oms_status_enu_t oms::ComponentFMUCS::instantiate()
+{
+  if (!fmi2_instantiate(fmu, fmi2CoSimulation, omsfmi2logger, calloc, free, NULL, NULL, fmi2True, fmi2True))
+  {
+    logInfo("fmi2Instantiate() failed");
+    exit(1);
+  }
+  //logInfo("instantiation successfull");
+
+  applyStartValues();
 
   // enterInitialization
   time = getModel().getStartTime();
@@ -826,6 +805,9 @@ oms_status_enu_t oms::ComponentFMUCS::reset()
   if (fmi2OK != fmistatus)
     return logError_ResetFailed(getCref());
 
+  // the fmu is back at the start values of the modelDescription.xml
+  applyStartValues();
+
   // enterInitialization
   time = getModel().getStartTime();
   double relativeTolerance = 0.0;
@@ -1334,30 +1316,141 @@ oms_status_enu_t oms::ComponentFMUCS::getDirectionalDerivative(const ComRef& unk
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentFMUCS::prepareDirectionalDerivative(const std::vector<ComRef>& unknownCrefs, const std::vector<ComRef>& knownCrefs, int& index)
+{
+  if (!getFMUInfo()->getProvidesDirectionalDerivative())
+    return logError("FMU \"" + std::string(getFullCref()) + "\" doesn't support directional derivatives (providesDirectionalDerivative = false in modelDescription.xml)");
+
+  DirectionalDerivative_t dd;
+  dd.vrUnknown.reserve(unknownCrefs.size());
+  for (const ComRef& cref : unknownCrefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    dd.vrUnknown.push_back(var->getValueReference());
+  }
+  dd.vrKnown.reserve(knownCrefs.size());
+  for (const ComRef& cref : knownCrefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    dd.vrKnown.push_back(var->getValueReference());
+  }
+
+  // reuse an identical entry, e.g. if an algebraic loop is set up again
+  for (size_t i = 0; i < directionalDerivatives.size(); ++i)
+  {
+    if (directionalDerivatives[i].vrUnknown == dd.vrUnknown && directionalDerivatives[i].vrKnown == dd.vrKnown)
+    {
+      index = static_cast<int>(i);
+      return oms_status_ok;
+    }
+  }
+
+  index = static_cast<int>(directionalDerivatives.size());
+  directionalDerivatives.push_back(dd);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUCS::getDirectionalDerivative(int index, const double* seed, double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(directionalDerivatives.size()))
+    return logError_InternalError;
+
+  const DirectionalDerivative_t& dd = directionalDerivatives[index];
+  if (fmi2OK != fmi2_getDirectionalDerivative(fmu, dd.vrUnknown.data(), dd.vrUnknown.size(), dd.vrKnown.data(), dd.vrKnown.size(), seed, values))
+    return logError_FMUCall("fmi2_getDirectionalDerivative", this);
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUCS::prepareRealSignals(const std::vector<ComRef>& crefs, int& index)
+{
+  std::vector<fmi2ValueReference> vrs;
+  vrs.reserve(crefs.size());
+  for (const ComRef& cref : crefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    vrs.push_back(var->getValueReference());
+  }
+
+  for (size_t i = 0; i < realSignals.size(); ++i)
+  {
+    if (realSignals[i] == vrs)
+    {
+      index = static_cast<int>(i);
+      return oms_status_ok;
+    }
+  }
+
+  index = static_cast<int>(realSignals.size());
+  realSignals.push_back(vrs);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUCS::getRealSignals(int index, double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(realSignals.size()))
+    return logError_InternalError;
+
+  const std::vector<fmi2ValueReference>& vrs = realSignals[index];
+  if (fmi2OK != fmi2_getReal(fmu, vrs.data(), vrs.size(), values))
+    return oms_status_error;
+
+  for (size_t i = 0; i < vrs.size(); ++i)
+  {
+    if (std::isnan(values[i]))
+      return logError("getReal returned NAN");
+    if (std::isinf(values[i]))
+      return logError("getReal returned +/-inf");
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUCS::setRealSignals(int index, const double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(realSignals.size()))
+    return logError_InternalError;
+
+  const std::vector<fmi2ValueReference>& vrs = realSignals[index];
+  if (fmi2OK != fmi2_setReal(fmu, vrs.data(), vrs.size(), values))
+    return oms_status_error;
+
+  return oms_status_ok;
+}
+
 oms_status_enu_t oms::ComponentFMUCS::getDirectionalDerivativeHeper(const int unknownIndex, const int knownIndex, const std::vector<int> &dependencyList, double &value)
 {
   fmi2ValueReference vr_unknown = allVariables[unknownIndex].getValueReference();
-  fmi2ValueReference *vr_known = (fmi2ValueReference *)calloc(dependencyList.size(), sizeof(fmi2ValueReference *));
-  fmi2Real *dvknown = (fmi2Real *)calloc(dependencyList.size(), sizeof(fmi2Real *));
+  vrKnownBuffer.resize(dependencyList.size());
+  seedBuffer.resize(dependencyList.size());
 
   for (int i = 0; i < dependencyList.size(); i++)
   {
-    vr_known[i] = allVariables[dependencyList[i] - 1].getValueReference();
+    vrKnownBuffer[i] = allVariables[dependencyList[i] - 1].getValueReference();
 
     // The knownIndex is < 0 if not specified. In this case, we
     // calculate the sum of the row, which means we set all seed
     // values to 1.0. Otherwise we just set the explicitly provided
     // element to 1.0.
     if (knownIndex < 0 || (dependencyList[i] == knownIndex + 1))
-      dvknown[i] = 1.0;
+      seedBuffer[i] = 1.0;
     else
-      dvknown[i] = 0.0;
+      seedBuffer[i] = 0.0;
   }
 
-  fmi2_getDirectionalDerivative(fmu, &vr_unknown, 1, vr_known, dependencyList.size(), dvknown, &value);
-
-  free(vr_known);
-  free(dvknown);
+  fmi2_getDirectionalDerivative(fmu, &vr_unknown, 1, vrKnownBuffer.data(), vrKnownBuffer.size(), seedBuffer.data(), &value);
 
   return oms_status_ok;
 }
@@ -1908,6 +2001,48 @@ oms_status_enu_t oms::ComponentFMUCS::restoreState()
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentFMUCS::serializeState(Checkpoint& checkpoint)
+{
+  fmi2FMUstate state = NULL;
+  fmi2Status fmistatus = fmi2_getFMUstate(fmu, &state);
+  if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_getFMUstate", this);
+
+  size_t size = 0;
+  std::vector<fmi2Byte> buffer;
+  fmistatus = fmi2_serializedFMUstateSize(fmu, state, &size);
+  if (fmi2OK == fmistatus)
+  {
+    buffer.resize(size);
+    fmistatus = fmi2_serializeFMUstate(fmu, state, buffer.data(), size);
+  }
+  fmi2_freeFMUstate(fmu, &state);
+  if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_serializeFMUstate", this);
+
+  checkpoint.writeValue(time);
+  checkpoint.writeBlock(buffer.data(), buffer.size());
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUCS::deserializeState(Checkpoint& checkpoint)
+{
+  double stateTime;
+  std::vector<char> buffer;
+  if (!checkpoint.readValue(stateTime) || !checkpoint.readBlock(buffer))
+    return logError("Checkpoint doesn't match " + std::string(getFullCref()));
+
+  fmi2FMUstate state = NULL;
+  fmi2Status fmistatus = fmi2_deSerializeFMUstate(fmu, (const fmi2Byte*)buffer.data(), buffer.size(), &state);
+  if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_deSerializeFMUstate", this);
+
+  fmistatus = fmi2_setFMUstate(fmu, state);
+  fmi2_freeFMUstate(fmu, &state);
+  if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_setFMUstate", this);
+
+  time = stateTime;
+
+  return oms_status_ok;
+}
+
 void oms::ComponentFMUCS::getFilteredSignals(std::vector<Connector>& filteredSignals) const
 {
   for (unsigned int i = 0; i < allVariables.size(); ++i)
@@ -96,6 +96,11 @@ namespace oms
     oms_status_enu_t setUnit(const ComRef& cref, const std::string& value);
 
     oms_status_enu_t getDirectionalDerivative(const ComRef& unknownCref, const ComRef& knownCref, double& value);
+    oms_status_enu_t prepareDirectionalDerivative(const std::vector<ComRef>& unknownCrefs, const std::vector<ComRef>& knownCrefs, int& index);
+    oms_status_enu_t getDirectionalDerivative(int index, const double* seed, double* values);
+    oms_status_enu_t prepareRealSignals(const std::vector<ComRef>& crefs, int& index);
+    oms_status_enu_t getRealSignals(int index, double* values);
+    oms_status_enu_t setRealSignals(int index, const double* values);
     oms_status_enu_t getDirectionalDerivativeHeper(const int unknownIndex, const int knownindex, const std::vector<int>& dependencyList, double& value);
 
     oms_status_enu_t deleteStartValue(const ComRef& cref);
@@ -115,6 +120,9 @@ namespace oms
     oms_status_enu_t removeSignalsFromResults(const char* regex);
 
     bool getCanGetAndSetState() {return getFMUInfo()->getCanGetAndSetFMUstate();}
+    bool getCanSerializeState() {return getFMUInfo()->getCanSerializeFMUstate();}
+    oms_status_enu_t serializeState(Checkpoint& checkpoint);
+    oms_status_enu_t deserializeState(Checkpoint& checkpoint);
     oms_status_enu_t saveState();
     oms_status_enu_t freeState();
     oms_status_enu_t restoreState();
@@ -124,6 +132,7 @@ namespace oms
     oms_status_enu_t newResources(const std::string& ssvFilename, const std::string& ssmFilename, bool externalResources);
     oms_status_enu_t setResourcesHelper1(Values value);
     oms_status_enu_t setResourcesHelper2(Values value);
+    void applyStartValues();
 
     oms_status_enu_t deleteReferencesInSSD(const std::string& filename);
     oms_status_enu_t deleteResourcesInSSP(const std::string& filename);
@@ -162,6 +171,19 @@ namespace oms
     fmi2FMUstate fmuState = NULL;
     double fmuStateTime;
 
+    /**
+     * @brief Value references of a directional derivative prepared with prepareDirectionalDerivative().
+     */
+    struct DirectionalDerivative_t
+    {
+      std::vector<fmi2ValueReference> vrUnknown;
+      std::vector<fmi2ValueReference> vrKnown;
+    };
+    std::vector<DirectionalDerivative_t> directionalDerivatives;
+    std::vector<std::vector<fmi2ValueReference>> realSignals; ///< value references of signals prepared with prepareRealSignals()
+    std::vector<fmi2ValueReference> vrKnownBuffer; ///< scratch buffer of getDirectionalDerivativeHeper
+    std::vector<fmi2Real> seedBuffer;   ///< scratch buffer of getDirectionalDerivativeHeper
+
     oms::ComRef getValidCref(ComRef cref);
   };
 }
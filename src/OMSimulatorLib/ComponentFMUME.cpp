@@ -46,7 +46,7 @@
 #include <cmath>
 
 oms::ComponentFMUME::ComponentFMUME(const ComRef& cref, System* parentSystem, const std::string& fmuPath)
-  : oms::Component(cref, oms_component_fmu, parentSystem, fmuPath), fmuInfo(fmuPath)
+  : oms::ComponentFMUMEBase(cref, oms_component_fmu, parentSystem, fmuPath)
 {
 }
 
@@ -74,10 +74,7 @@ oms::Component* oms::ComponentFMUME::NewComponent(const oms::ComRef& cref, oms::
 
   // replaceComponent string will be used to avoid name conflicts when replacing a fmu with oms_replaceSubModel(), the default is ""
 
-  filesystem::path temp_root(parentSystem->getModel().getTempDirectory());
-  filesystem::path temp_temp = temp_root / "temp";
   filesystem::path relFMUPath = parentSystem->copyResources() ? (filesystem::path("resources") / (parentSystem->getUniqueID() + "_" + replaceComponent + std::string(cref) + ".fmu")) : filesystem::path(fmuPath);
-  filesystem::path absFMUPath = temp_root / relFMUPath;
 
   ComponentFMUME* component = new ComponentFMUME(cref, parentSystem, relFMUPath.generic_string());
 
@@ -95,50 +92,21 @@ oms::Component* oms::ComponentFMUME::NewComponent(const oms::ComRef& cref, oms::
   else
     modelDescriptionPath = parentSystem->getModel().getTempDirectory() / filesystem::path(fmuPath);
 
-  component->values.parseModelDescription(modelDescriptionPath, guid_);
-
-  /*
-   * check if instance of an fmu already exist by using guid of the fmu
-   * if instance exist use the existing instance path
-   * eg: tank1 => resources /0001_tank1.fmu
-   *     tank2 => resources /0001_tank1.fmu
-  */
-  auto it = parentSystem->fmuGuid.find(guid_);
-  if (it == parentSystem->fmuGuid.end())
-    parentSystem->fmuGuid[guid_] = relFMUPath;
+  // a clone takes over the parsed modelDescription.xml and the unpacked fmu of its source component
+  const ComponentFMUME* source = dynamic_cast<const ComponentFMUME*>(component->getCloneSource());
+  if (source)
+    component->values.copyModelDescription(source->values);
   else
-  {
-    // instance exists and update the FMU path to already existing instance
-    relFMUPath = parentSystem->fmuGuid[guid_];
-    absFMUPath = temp_root / relFMUPath;
-    component->setPath(relFMUPath.generic_string());
-  }
-
-  // Copy the resource to the temp directory of the model? We don't want have
-  // to copy resources if importing an SSP file or snapshot.
-  if (parentSystem->copyResources() && !filesystem::exists(absFMUPath))
-    oms_copy_file(filesystem::path(fmuPath), absFMUPath);
+    component->values.parseModelDescription(modelDescriptionPath, guid_);
 
-  // set temp directory
-  filesystem::path tempDir = temp_temp / relFMUPath.stem();
-  component->setTempDir(tempDir.string());
-
-  bool dirExist = true;
-  if (!filesystem::is_directory(tempDir))
+  if (oms_status_ok != component->unpackFMU(guid_, modelDescriptionPath.string(), source))
   {
-    dirExist = false;
-    if (!filesystem::create_directory(tempDir))
-    {
-      logError("Creating temp directory for component \"" + std::string(cref) + "\" failed");
-      return NULL;
-    }
+    delete component;
+    return NULL;
   }
 
-  // unpack the fmu in temp directory
-  oms::Scope::miniunz(modelDescriptionPath.generic_string().c_str(), tempDir.generic_string().c_str());
-
   // load the unpacked fmu and parse modelDescription.xml
-  component->fmu = fmi4c_loadUnzippedFmu(cref.c_str(), tempDir.generic_string().c_str());
+  component->fmu = fmi4c_loadUnzippedFmu(cref.c_str(), filesystem::path(component->getTempDir()).generic_string().c_str());
   if (!component->fmu)
   {
     logError("Error parsing modelDescription.xml");
@@ -168,9 +136,10 @@ oms::Component* oms::ComponentFMUME::NewComponent(const oms::ComRef& cref, oms::
   component->nEventIndicators = fmi2_getNumberOfEventIndicators(component->fmu);
 
   // create a list of all variables using fmi4c variable structure
-  component->allVariables.reserve(fmi2_getNumberOfVariables(component->fmu));
-  component->exportVariables.reserve(fmi2_getNumberOfVariables(component->fmu));
-  for (unsigned int i = 0; i < fmi2_getNumberOfVariables(component->fmu); ++i)
+  const unsigned int nVariables = static_cast<unsigned int>(fmi2_getNumberOfVariables(component->fmu));
+  component->allVariables.reserve(nVariables);
+  component->exportVariables.reserve(nVariables);
+  for (unsigned int i = 0; i < nVariables; ++i)
   {
     oms::Variable v(component->fmu, i, oms_component_fmu);
     if (v.getIndex() != i)
@@ -179,93 +148,16 @@ oms::Component* oms::ComponentFMUME::NewComponent(const oms::ComRef& cref, oms::
       delete component;
       return NULL;
     }
-    // extract continuous-time derivatives
-    if (v.isContinuousTimeDer())
-      component->derivatives.push_back(v.getIndex());
-
     component->allVariables.push_back(v);
     component->exportVariables.push_back(true);
   }
 
-  // mark states and continuous-time states
-  for (unsigned int i = 0; i < fmi2_getNumberOfVariables(component->fmu); ++i)
-  {
-    if (component->allVariables[i].isContinuousTimeDer())
-      component->allVariables[component->allVariables[i].getStateIndex()-1].markAsContinuousTimeState(i);
-    else if (component->allVariables[i].isDer())
-      component->allVariables[component->allVariables[i].getStateIndex()-1].markAsState(i);
-  }
-
-  // create some special variable maps
-  for (auto const& v : component->allVariables)
+  if (oms_status_ok != component->initializeStates() || oms_status_ok != component->initializeConnectors())
   {
-    if (v.isInput())
-      component->inputs.push_back(v.getIndex());
-    else if (v.isOutput())
-    {
-      component->outputs.push_back(v.getIndex());
-      component->outputsGraph.addNode(Connector(oms_causality_output, v.getType(), v.getCref(), component->getFullCref()));
-    }
-    else if (v.isParameter())
-      component->parameters.push_back(v.getIndex());
-    else if (v.isCalculatedParameter())
-      component->calculatedParameters.push_back(v.getIndex());
-
-    if (v.isInitialUnknown())
-      component->initialUnknownsGraph.addNode(Connector(v.getCausality(), v.getType(), v.getCref(), component->getFullCref()));
-
-    component->exportVariables.push_back(v.isInput() || v.isOutput());
-  }
-
-  // create connectors
-  while (component->connectors.size() > 0 && NULL == component->connectors.back())
-    component->connectors.pop_back();
-
-  int j = 1;
-  int size = 1 + component->inputs.size();
-  for (const auto& i : component->inputs)
-    component->connectors.push_back(new Connector(oms_causality_input, component->allVariables[i].getType(), component->allVariables[i].getCref(), component->getFullCref(), j++/(double)size));
-  j = 1;
-  size = 1 + component->outputs.size();
-  for (const auto& i : component->outputs)
-    component->connectors.push_back(new Connector(oms_causality_output, component->allVariables[i].getType(), component->allVariables[i].getCref(), component->getFullCref(), j++/(double)size));
-  for (const auto& i : component->parameters)
-    component->connectors.push_back(new Connector(oms_causality_parameter, component->allVariables[i].getType(), component->allVariables[i].getCref(), component->getFullCref()));
-  for (const auto& i : component->calculatedParameters)
-    component->connectors.push_back(new Connector(oms_causality_calculatedParameter, component->allVariables[i].getType(), component->allVariables[i].getCref(), component->getFullCref()));
-  component->connectors.push_back(NULL);
-  component->element.setConnectors(&component->connectors[0]);
-
-  if (oms_status_ok != component->initializeDependencyGraph_initialUnknowns())
-  {
-    logError(std::string(cref) + ": Couldn't initialize dependency graph for initial unknowns.");
-    delete component;
-    return NULL;
-  }
-  if (oms_status_ok != component->initializeDependencyGraph_outputs())
-  {
-    logError(std::string(cref) + ": Couldn't initialize dependency graph for simulation unknowns.");
     delete component;
     return NULL;
   }
 
-  // set units to connector
-  for (auto &connector : component->connectors)
-  {
-    if (connector)
-    {
-      oms::ComRef connectorCref = connector->getName();
-      std::string unitName = component->values.getUnitFromModeldescription(connectorCref);
-      if (!unitName.empty())
-        connector->connectorUnits[unitName] = component->values.modeldescriptionUnitDefinitions[unitName];
-
-      // get enumerationTypes
-      std::string enumType = component->values.getEnumerationTypeFromModeldescription(connectorCref);
-      if (!enumType.empty())
-        connector->enumerationName[connectorCref] = enumType;
-    }
-  }
-
   return component;
 }
 
@@ -434,157 +326,18 @@ void oms::ComponentFMUME::dumpInitialUnknowns()
   logInfo("[" + std::string(getCref()) + ": " + getPath() + "] The FMU contains " + std::to_string(n) + " initial unknowns: " + str);
 }
 
-oms_status_enu_t oms::ComponentFMUME::initializeDependencyGraph_initialUnknowns()
+int oms::ComponentFMUME::getModelStructureReference(unsigned int index) const
 {
-  if (initialUnknownsGraph.getEdges().connections.size() > 0)
-    return logError(std::string(getCref()) + ": " + getPath() + " is already initialized");
-
-  //dumpInitialUnknowns();
-
-  // Check if initial unknowns from modelDescription.xml are the same as in initialUnknownsGraph
-  size_t N_ModelStructure = values.modelStructureInitialUnknowns.size();
-  size_t N = initialUnknownsGraph.getNodes().size();
-
-  bool badInitialUnknowns = false;
-
-  std::unordered_set <unsigned int> setA_ModelStructure;
-  for (const auto &it : values.modelStructureInitialUnknowns)
-    setA_ModelStructure.insert(it.first-1);
-
-  std::string missing_unknowns = "";
-  for (auto &v : allVariables)
-  {
-    if (v.isInitialUnknown() && setA_ModelStructure.find(v.getIndex()) == setA_ModelStructure.end())
-    {
-      badInitialUnknowns = true;
-      missing_unknowns += "\n  * " + std::to_string(v.getIndex()+1) + ": " + std::string(v.getCref()) + " is missing";
-    }
-  }
-
-  for (const auto &it : values.modelStructureInitialUnknowns)
-  {
-    const Variable &var_oms = allVariables[it.first - 1];
-    fmi2VariableHandle *var = fmi2_getVariableByIndex(fmu, (it.first));
-    oms::ComRef name_fmilib = fmi2_getVariableName(var);
-    // std::cout << "\nDebug: " << var_oms.getCref().c_str() << "===>" << name_fmilib.c_str() << "===>" << var_oms.isInitialUnknown();
-    if (var_oms.getCref() != name_fmilib)
-    {
-      missing_unknowns += "\n  * " + std::to_string(it.first) + ": " + std::string(var_oms.getCref()) + " could not be found";
-      badInitialUnknowns = true;
-    }
-    else if (!var_oms.isInitialUnknown())
-    {
-      missing_unknowns += "\n  * " + std::to_string(it.first) + ": " + std::string(var_oms.getCref()) + " is wrongly listed";
-      badInitialUnknowns = true;
-    }
-  }
-
-
-  if (badInitialUnknowns && !Flags::IgnoreInitialUnknowns() && N_ModelStructure > 0)
-    logWarning("[" + std::string(getCref()) + ": " + getPath() + "] The FMU lists " + std::to_string(N_ModelStructure) + " initial unknowns and exposes " + std::to_string(N) + " initial unknowns." + missing_unknowns);
-
-  if (badInitialUnknowns)
-  {
-    if(!Flags::IgnoreInitialUnknowns() && N_ModelStructure > 0)
-      logInfo("[" + std::string(getCref()) + ": " + getPath() + "] The FMU contains bad initial unknowns. This might cause problems, e.g. wrong simulation results.");
-    else
-    {
-      if (N_ModelStructure > 0)
-        logWarning("[" + std::string(getCref()) + ": " + getPath() + "] The dependencies of the initial unknowns defined in the FMU are ignored because the flag --ignoreInitialUnknowns is active. Instead, all the initial unknowns will depend on all inputs.");
-      for (int i=0; i < N; i++)
-      {
-        logDebug(std::string(getCref()) + ": " + getPath() + " initial unknown " + std::string(initialUnknownsGraph.getNodes()[i]) + " depends on all inputs");
-        for (const auto& j : inputs)
-          initialUnknownsGraph.addEdge(allVariables[j].makeConnector(this->getFullCref()), initialUnknownsGraph.getNodes()[i]);
-      }
-      return oms_status_ok;
-    }
-  }
-
-  // get the initial unknowns dependencies
-  int i = 0;
-  for (const auto &it : values.modelStructureInitialUnknowns)
-  {
-    //std::cout << "\nInitialUnknowns dependencies: " << it.first << "===>" << it.second.size() << "==>" << values.modelStructureInitialUnknownsDependencyExist[it.first];
-    // no dependencies
-    if (it.second.empty() && values.modelStructureInitialUnknownsDependencyExist[it.first])
-      logDebug(std::string(getCref()) + ": " + getPath() + " initial unknown " + std::string(initialUnknownsGraph.getNodes()[i]) + " has no dependencies");
-
-    // dependency attribute not provided in modeldescription.xml, all output depends on all inputs
-    else if (it.second.empty() && !values.modelStructureInitialUnknownsDependencyExist[it.first])
-    {
-      logDebug(std::string(getCref()) + ": " + getPath() + " initial unknown " + std::string(initialUnknownsGraph.getNodes()[i]) + " depends on all inputs");
-      for (const auto& j : inputs)
-        initialUnknownsGraph.addEdge(allVariables[j].makeConnector(this->getFullCref()), initialUnknownsGraph.getNodes()[i]);
-    }
-    else
-    {
-      //dependency exist
-      for (const auto &index : it.second)
-      {
-        if (index < 1 || index > allVariables.size())
-        {
-          logWarning("Initial unknown " + std::string(initialUnknownsGraph.getNodes()[i]) + " has bad dependency on variable with index " + std::to_string(index) + " which couldn't be resolved");
-          return logError(std::string(getCref()) + ": Erroneous initial unknowns detected in modelDescription.xml\nUse flag --ignoreInitialUnknowns=true to ignore all initial unknowns, but this can cause inflated loop size.");
-        }
-        logDebug(std::string(getCref()) + ": " + getPath() + " initial unknown " + std::string(initialUnknownsGraph.getNodes()[i]) + " depends on " + std::string(allVariables[index - 1]));
-        initialUnknownsGraph.addEdge(allVariables[index - 1].makeConnector(this->getFullCref()), initialUnknownsGraph.getNodes()[i]);
-      }
-    }
-    i = i + 1;
-  }
-
-  return oms_status_ok;
+  return static_cast<int>(index) + 1;
 }
 
-oms_status_enu_t oms::ComponentFMUME::initializeDependencyGraph_outputs()
+bool oms::ComponentFMUME::getVariableIndex(int reference, unsigned int& index) const
 {
-  if (outputsGraph.getEdges().connections.size() > 0)
-  {
-    logError(std::string(getCref()) + ": " + getPath() + " is already initialized.");
-    return oms_status_error;
-  }
-
-  // if (!startIndex)
-  // {
-  //   logDebug(std::string(getCref()) + ": " + getPath() + " no dependencies");
-  //   return oms_status_ok;
-  // }
-
-  // get the output dependencies
-  int i = 0;
-  for (const auto &it : values.modelStructureOutputs)
-  {
-    Variable& output = allVariables[outputs[i]];
-    // no dependencies
-    if (it.second.empty() && values.modelStructureOutputDependencyExist[it.first])
-    {
-      logDebug(std::string(getCref()) + ": " + getPath() + " output " + std::string(output) + " has no dependencies");
-    }
-    // dependency attribute not provided in modeldescription.xml, all output depends on all inputs
-    else if (it.second.empty() && !values.modelStructureOutputDependencyExist[it.first])
-    {
-      logDebug(std::string(getCref()) + ": " + getPath() + " output " + std::string(output) + " depends on all");
-      for (const auto& j : inputs)
-        outputsGraph.addEdge(allVariables[j].makeConnector(this->getFullCref()), output.makeConnector(this->getFullCref()));
-    }
-    else
-    {
-      for (const auto &index : it.second)
-      {
-        if (index < 1 || index > allVariables.size())
-        {
-          logWarning("Output " + std::string(output) + " has bad dependency on variable with index " + std::to_string(index) + " which couldn't be resolved");
-          return logError(std::string(getCref()) + ": erroneous dependencies detected in modelDescription.xml");
-        }
-        logDebug(std::string(getCref()) + ": " + getPath() + " output " + std::string(output) + " depends on " + std::string(allVariables[index - 1]));
-        outputsGraph.addEdge(allVariables[index - 1].makeConnector(this->getFullCref()), output.makeConnector(this->getFullCref()));
-      }
-    }
-    i = i + 1;
-  }
+  if (reference < 1 || static_cast<size_t>(reference) > allVariables.size())
+    return false;
 
-  return oms_status_ok;
+  index = static_cast<unsigned int>(reference - 1);
+  return true;
 }
 
 // void oms::loggerFmi3(fmi2ComponentEnvironment componentEnvironment,
@@ -617,15 +370,14 @@ oms_status_enu_t oms::ComponentFMUME::initializeDependencyGraph_outputs()
 //     va_end(args);
 // }
 
-oms_status_enu_t oms::ComponentFMUME::instantiate()
+/**
+ * @brief Sets the start values of the SSV resources or inline values in the FMU.
+ *
+ * Called after instantiation and again after fmi reset, which restores the
+ * start values of the modelDescription.xml.
+ */
+void oms::ComponentFMUME::applyStartValues()
 {
-  if (!fmi2_instantiate(fmu, fmi2ModelExchange, omsfmi2logger, calloc, free, NULL, NULL, fmi2True, fmi2True))
-  {
-    logInfo("fmi2Instantiate() failed");
-    exit(1);
-  }
-  //logInfo("instantiation successfull");
-
   // set start values from local resources
   if (values.hasResources())
   {
@@ -661,6 +413,18 @@ oms_status_enu_t oms::ComponentFMUME::instantiate()
   {
     setResourcesHelper1(values);
   }
+}
+
+oms_status_enu_t oms::ComponentFMUME::instantiate()
+{
+  if (!fmi2_instantiate(fmu, fmi2ModelExchange, omsfmi2logger, calloc, free, NULL, NULL, fmi2True, fmi2True))
+  {
+    logInfo("fmi2Instantiate() failed");
+    exit(1);
+  }
+  //logInfo("instantiation successfull");
+
+  applyStartValues();
 
   // enterInitialization
   const double& startTime = getModel().getStartTime();
@@ -793,6 +557,31 @@ oms_status_enu_t oms::ComponentFMUME::doEventIteration()
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentFMUME::enterEventMode()
+{
+  fmi2Status fmistatus = fmi2_enterEventMode(fmu);
+  if (fmi2OK != fmistatus)
+    return logError_FMUCall("fmi2_enterEventMode", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUME::enterContinuousTimeMode()
+{
+  fmi2Status fmistatus = fmi2_enterContinuousTimeMode(fmu);
+  if (fmi2OK != fmistatus)
+    return logError_FMUCall("fmi2_enterContinuousTimeMode", this);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUME::completedIntegratorStep(fmi2Boolean& callEventUpdate, fmi2Boolean& terminateSimulation)
+{
+  CallClock callClock(clock);
+  fmi2Status fmistatus = fmi2_completedIntegratorStep(fmu, fmi2True, &callEventUpdate, &terminateSimulation);
+  if (fmi2OK != fmistatus)
+    return logError_FMUCall("fmi2_completedIntegratorStep", this);
+  return oms_status_ok;
+}
+
 oms_status_enu_t oms::ComponentFMUME::newResources(const std::string& ssvFilename, const std::string& ssmFilename, bool externalResources)
 {
   Values resources;
@@ -887,6 +676,9 @@ oms_status_enu_t oms::ComponentFMUME::reset()
   if (fmi2OK != fmistatus)
     return logError_ResetFailed(getCref());
 
+  // the fmu is back at the start values of the modelDescription.xml
+  applyStartValues();
+
   // enterInitialization
   const double& startTime = getModel().getStartTime();
   double relativeTolerance = 0.0;
@@ -1377,30 +1169,141 @@ oms_status_enu_t oms::ComponentFMUME::getDirectionalDerivative(const ComRef& unk
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentFMUME::prepareDirectionalDerivative(const std::vector<ComRef>& unknownCrefs, const std::vector<ComRef>& knownCrefs, int& index)
+{
+  if (!getFMUInfo()->getProvidesDirectionalDerivative())
+    return logError("FMU \"" + std::string(getFullCref()) + "\" doesn't support directional derivatives (providesDirectionalDerivative = false in modelDescription.xml)");
+
+  DirectionalDerivative_t dd;
+  dd.vrUnknown.reserve(unknownCrefs.size());
+  for (const ComRef& cref : unknownCrefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    dd.vrUnknown.push_back(var->getValueReference());
+  }
+  dd.vrKnown.reserve(knownCrefs.size());
+  for (const ComRef& cref : knownCrefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    dd.vrKnown.push_back(var->getValueReference());
+  }
+
+  // reuse an identical entry, e.g. if an algebraic loop is set up again
+  for (size_t i = 0; i < directionalDerivatives.size(); ++i)
+  {
+    if (directionalDerivatives[i].vrUnknown == dd.vrUnknown && directionalDerivatives[i].vrKnown == dd.vrKnown)
+    {
+      index = static_cast<int>(i);
+      return oms_status_ok;
+    }
+  }
+
+  index = static_cast<int>(directionalDerivatives.size());
+  directionalDerivatives.push_back(dd);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUME::getDirectionalDerivative(int index, const double* seed, double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(directionalDerivatives.size()))
+    return logError_InternalError;
+
+  const DirectionalDerivative_t& dd = directionalDerivatives[index];
+  if (fmi2OK != fmi2_getDirectionalDerivative(fmu, dd.vrUnknown.data(), dd.vrUnknown.size(), dd.vrKnown.data(), dd.vrKnown.size(), seed, values))
+    return logError_FMUCall("fmi2_getDirectionalDerivative", this);
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUME::prepareRealSignals(const std::vector<ComRef>& crefs, int& index)
+{
+  std::vector<fmi2ValueReference> vrs;
+  vrs.reserve(crefs.size());
+  for (const ComRef& cref : crefs)
+  {
+    Variable* var = getVariable(cref);
+    if (!var || !var->isTypeReal())
+      return logError_UnknownSignal(getFullCref() + cref);
+    vrs.push_back(var->getValueReference());
+  }
+
+  for (size_t i = 0; i < realSignals.size(); ++i)
+  {
+    if (realSignals[i] == vrs)
+    {
+      index = static_cast<int>(i);
+      return oms_status_ok;
+    }
+  }
+
+  index = static_cast<int>(realSignals.size());
+  realSignals.push_back(vrs);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUME::getRealSignals(int index, double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(realSignals.size()))
+    return logError_InternalError;
+
+  const std::vector<fmi2ValueReference>& vrs = realSignals[index];
+  if (fmi2OK != fmi2_getReal(fmu, vrs.data(), vrs.size(), values))
+    return oms_status_error;
+
+  for (size_t i = 0; i < vrs.size(); ++i)
+  {
+    if (std::isnan(values[i]))
+      return logError("getReal returned NAN");
+    if (std::isinf(values[i]))
+      return logError("getReal returned +/-inf");
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUME::setRealSignals(int index, const double* values)
+{
+  CallClock callClock(clock);
+
+  if (!fmu || index < 0 || index >= static_cast<int>(realSignals.size()))
+    return logError_InternalError;
+
+  const std::vector<fmi2ValueReference>& vrs = realSignals[index];
+  if (fmi2OK != fmi2_setReal(fmu, vrs.data(), vrs.size(), values))
+    return oms_status_error;
+
+  return oms_status_ok;
+}
+
 oms_status_enu_t oms::ComponentFMUME::getDirectionalDerivativeHeper(const int unknownIndex, const int knownIndex, const std::vector<int> &dependencyList, double &value)
 {
   fmi2ValueReference vr_unknown = allVariables[unknownIndex].getValueReference();
-  fmi2ValueReference *vr_known = (fmi2ValueReference *)calloc(dependencyList.size(), sizeof(fmi2ValueReference *));
-  fmi2Real *dvknown = (fmi2Real *)calloc(dependencyList.size(), sizeof(fmi2Real *));
+  vrKnownBuffer.resize(dependencyList.size());
+  seedBuffer.resize(dependencyList.size());
 
   for (int i = 0; i < dependencyList.size(); i++)
   {
-    vr_known[i] = allVariables[dependencyList[i] - 1].getValueReference();
+    vrKnownBuffer[i] = allVariables[dependencyList[i] - 1].getValueReference();
 
     // The knownIndex is < 0 if not specified. In this case, we
     // calculate the sum of the row, which means we set all seed
     // values to 1.0. Otherwise we just set the explicitly provided
     // element to 1.0.
     if (knownIndex < 0 || (dependencyList[i] == knownIndex + 1))
-      dvknown[i] = 1.0;
+      seedBuffer[i] = 1.0;
     else
-      dvknown[i] = 0.0;
+      seedBuffer[i] = 0.0;
   }
 
-  fmi2_getDirectionalDerivative(fmu, &vr_unknown, 1, vr_known, dependencyList.size(), dvknown, &value);
-
-  free(vr_known);
-  free(dvknown);
+  fmi2_getDirectionalDerivative(fmu, &vr_unknown, 1, vrKnownBuffer.data(), vrKnownBuffer.size(), seedBuffer.data(), &value);
 
   return oms_status_ok;
 }
@@ -1630,6 +1533,16 @@ oms_status_enu_t oms::ComponentFMUME::setReal(const ComRef& cref, double value)
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentFMUME::setReal(const fmi2ValueReference& vr, double value)
+{
+  CallClock callClock(clock);
+
+  if (fmi2OK != fmi2_setReal(fmu, &vr, 1, &value))
+    return oms_status_error;
+
+  return oms_status_ok;
+}
+
 oms_status_enu_t oms::ComponentFMUME::setString(const ComRef& cref, const std::string& value)
 {
   CallClock callClock(clock);
@@ -1881,6 +1794,29 @@ oms_status_enu_t oms::ComponentFMUME::getEventindicators(double* eventindicators
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentFMUME::getStateDirectionalDerivative(const int* states, size_t nStates, const double* seed, double* values)
+{
+  CallClock callClock(clock);
+
+  if (vrStates.empty())
+  {
+    for (const auto& i : derivatives)
+    {
+      vrStates.push_back(allVariables[allVariables[i].getStateIndex()-1].getValueReference());
+      vrDerivatives.push_back(allVariables[i].getValueReference());
+    }
+  }
+
+  vrKnownStates.resize(nStates);
+  for (size_t k = 0; k < nStates; ++k)
+    vrKnownStates[k] = vrStates[states[k]];
+
+  fmi2Status fmistatus = fmi2_getDirectionalDerivative(fmu, vrDerivatives.data(), vrDerivatives.size(), vrKnownStates.data(), nStates, seed, values);
+  if (fmi2OK != fmistatus)
+    return logError_FMUCall("fmi2_getDirectionalDerivative", this);
+  return oms_status_ok;
+}
+
 oms_status_enu_t oms::ComponentFMUME::addSignalsToResults(const char* regex)
 {
   std::regex exp(regex);
@@ -1919,6 +1855,45 @@ oms_status_enu_t oms::ComponentFMUME::removeSignalsFromResults(const char* regex
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentFMUME::serializeState(Checkpoint& checkpoint)
+{
+  fmi2FMUstate state = NULL;
+  fmi2Status fmistatus = fmi2_getFMUstate(fmu, &state);
+  if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_getFMUstate", this);
+
+  size_t size = 0;
+  std::vector<fmi2Byte> buffer;
+  fmistatus = fmi2_serializedFMUstateSize(fmu, state, &size);
+  if (fmi2OK == fmistatus)
+  {
+    buffer.resize(size);
+    fmistatus = fmi2_serializeFMUstate(fmu, state, buffer.data(), size);
+  }
+  fmi2_freeFMUstate(fmu, &state);
+  if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_serializeFMUstate", this);
+
+  checkpoint.writeValue(eventInfo);
+  checkpoint.writeBlock(buffer.data(), buffer.size());
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUME::deserializeState(Checkpoint& checkpoint)
+{
+  std::vector<char> buffer;
+  if (!checkpoint.readValue(eventInfo) || !checkpoint.readBlock(buffer))
+    return logError("Checkpoint doesn't match " + std::string(getFullCref()));
+
+  fmi2FMUstate state = NULL;
+  fmi2Status fmistatus = fmi2_deSerializeFMUstate(fmu, (const fmi2Byte*)buffer.data(), buffer.size(), &state);
+  if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_deSerializeFMUstate", this);
+
+  fmistatus = fmi2_setFMUstate(fmu, state);
+  fmi2_freeFMUstate(fmu, &state);
+  if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_setFMUstate", this);
+
+  return oms_status_ok;
+}
+
 void oms::ComponentFMUME::getFilteredSignals(std::vector<Connector>& filteredSignals) const
 {
   for (unsigned int i = 0; i < allVariables.size(); ++i)
@@ -32,7 +32,7 @@
 #ifndef _OMS_COMPONENT_FMU_ME_H_
 #define _OMS_COMPONENT_FMU_ME_H_
 
-#include "Component.h"
+#include "ComponentFMUMEBase.h"
 #include "ComRef.h"
 #include "ResultWriter.h"
 #include "Snapshot.h"
@@ -49,14 +49,13 @@
 
 namespace oms
 {
-  class ComponentFMUME : public Component
+  class ComponentFMUME : public ComponentFMUMEBase
   {
   public:
     ~ComponentFMUME();
 
     static Component* NewComponent(const oms::ComRef& cref, System* parentSystem, const std::string& fmuPath, std::string replaceComponent = "");
     static Component* NewComponent(const pugi::xml_node& node, System* parentSystem,  const std::string& sspVersion, const Snapshot& snapshot, std::string variantName);
-    const FMUInfo* getFMUInfo() const {return &(this->fmuInfo);}
 
     oms_status_enu_t exportToSSD(pugi::xml_node& node, Snapshot& snapshot, std::string variantName) const;
     oms_status_enu_t exportToSSV(pugi::xml_node& ssvNode);
@@ -69,9 +68,6 @@ namespace oms
     oms_status_enu_t terminate();
     oms_status_enu_t reset();
 
-    oms_status_enu_t initializeDependencyGraph_initialUnknowns();
-    oms_status_enu_t initializeDependencyGraph_outputs();
-
     Variable* getVariable(const ComRef& cref);
 
     Values& getValues() { return values; }
@@ -88,11 +84,17 @@ namespace oms
     oms_status_enu_t setBoolean(const ComRef& cref, bool value);
     oms_status_enu_t setInteger(const ComRef& cref, int value);
     oms_status_enu_t setReal(const ComRef& cref, double value);
+    oms_status_enu_t setReal(const fmi2ValueReference& vr, double value);
     oms_status_enu_t setString(const ComRef& cref, const std::string& value);
     oms_status_enu_t setUnit(const ComRef& cref, const std::string& value);
     oms_status_enu_t setTime(double time);
 
     oms_status_enu_t getDirectionalDerivative(const ComRef& unknownCref, const ComRef& knownCref, double& value);
+    oms_status_enu_t prepareDirectionalDerivative(const std::vector<ComRef>& unknownCrefs, const std::vector<ComRef>& knownCrefs, int& index);
+    oms_status_enu_t getDirectionalDerivative(int index, const double* seed, double* values);
+    oms_status_enu_t prepareRealSignals(const std::vector<ComRef>& crefs, int& index);
+    oms_status_enu_t getRealSignals(int index, double* values);
+    oms_status_enu_t setRealSignals(int index, const double* values);
     oms_status_enu_t getDirectionalDerivativeHeper(const int unknownIndex, const int knownIndex, const std::vector<int>& dependencyList, double& value);
 
     oms_status_enu_t deleteStartValue(const ComRef& cref);
@@ -104,25 +106,30 @@ namespace oms
     oms_status_enu_t removeSignalsFromResults(const char* regex);
 
     oms_status_enu_t doEventIteration();
+    oms_status_enu_t enterEventMode();
+    oms_status_enu_t enterContinuousTimeMode();
+    oms_status_enu_t completedIntegratorStep(fmi2Boolean& callEventUpdate, fmi2Boolean& terminateSimulation);
 
-    size_t getNumberOfContinuousStates() const {return derivatives.size();}
-    size_t getNumberOfEventIndicators() const {return nEventIndicators;}
     oms_status_enu_t getContinuousStates(double* states);
     oms_status_enu_t setContinuousStates(double* states);
     oms_status_enu_t getDerivatives(double* derivatives);
     oms_status_enu_t getNominalsOfContinuousStates(double* nominals);
     oms_status_enu_t getEventindicators(double* eventindicators);
 
-    fmiHandle* getFMU() {return fmu;}
-    fmi2EventInfo* getEventInfo() {return &eventInfo;}
+    oms_status_enu_t getStateDirectionalDerivative(const int* states, size_t nStates, const double* seed, double* values);
+
 
     bool getCanGetAndSetState() {return getFMUInfo()->getCanGetAndSetFMUstate();}
+    bool getCanSerializeState() {return getFMUInfo()->getCanSerializeFMUstate();}
+    oms_status_enu_t serializeState(Checkpoint& checkpoint);
+    oms_status_enu_t deserializeState(Checkpoint& checkpoint);
 
     void getFilteredSignals(std::vector<Connector>& filteredSignals) const;
 
     oms_status_enu_t newResources(const std::string& ssvFilename, const std::string& ssmFilename, bool externalResources);
     oms_status_enu_t setResourcesHelper1(Values value);
     oms_status_enu_t setResourcesHelper2(Values value);
+    void applyStartValues();
     oms_status_enu_t setExportName(const std::string & exportName) { this->exportName = exportName; return oms_status_ok;};
     std::string getExportName() const { return this->exportName; }
     oms_status_enu_t deleteReferencesInSSD(const std::string& filename);
@@ -139,28 +146,31 @@ namespace oms
 
     void dumpInitialUnknowns();
 
+    int getModelStructureReference(unsigned int index) const;
+    bool getVariableIndex(int reference, unsigned int& index) const;
+
   private:
     fmi2CallbackLogger omsfmi2logger;
-    fmiHandle *fmu = NULL;
-
-    fmi2EventInfo eventInfo;
-    size_t nEventIndicators;
-
-    FMUInfo fmuInfo;
-
-    std::vector<Variable> allVariables;
-    std::vector<unsigned int> calculatedParameters;
-    std::vector<unsigned int> derivatives;
-    std::vector<unsigned int> inputs;
-    std::vector<unsigned int> outputs;
-    std::vector<unsigned int> parameters;
-    std::vector<bool> exportVariables;
     std::string exportName; ///< export name of the FMU, used for the result file
 
-    Values values; ///< start values defined before instantiating the FMU and external inputs defined after initialization
-
     std::unordered_map<unsigned int /*result file var ID*/, unsigned int /*allVariables ID*/> resultFileMapping;
 
+    /**
+     * @brief Value references of a directional derivative prepared with prepareDirectionalDerivative().
+     */
+    struct DirectionalDerivative_t
+    {
+      std::vector<fmi2ValueReference> vrUnknown;
+      std::vector<fmi2ValueReference> vrKnown;
+    };
+    std::vector<DirectionalDerivative_t> directionalDerivatives;
+    std::vector<std::vector<fmi2ValueReference>> realSignals; ///< value references of signals prepared with prepareRealSignals()
+    std::vector<fmi2ValueReference> vrKnownBuffer; ///< scratch buffer of getDirectionalDerivativeHeper
+    std::vector<fmi2Real> seedBuffer;   ///< scratch buffer of getDirectionalDerivativeHeper
+    std::vector<fmi2ValueReference> vrStates;      ///< value references of the continuous states, resolved on first use
+    std::vector<fmi2ValueReference> vrDerivatives; ///< value references of the state derivatives, resolved on first use
+    std::vector<fmi2ValueReference> vrKnownStates; ///< scratch buffer of getStateDirectionalDerivative
+
     oms::ComRef getValidCref(ComRef cref);
   };
 }
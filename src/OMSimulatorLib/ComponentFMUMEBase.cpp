@@ -0,0 +1,341 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "ComponentFMUMEBase.h"
+
+#include "Flags.h"
+#include "Logging.h"
+
+#include <unordered_set>
+
+oms::ComponentFMUMEBase::ComponentFMUMEBase(const ComRef& cref, oms_component_enu_t type, System* parentSystem, const std::string& fmuPath)
+  : oms::Component(cref, type, parentSystem, fmuPath), fmuInfo(fmuPath)
+{
+}
+
+/**
+ * @brief Marks the states of all derivatives and numbers the continuous-time
+ * states in the order of their derivatives.
+ */
+oms_status_enu_t oms::ComponentFMUMEBase::initializeStates()
+{
+  for (unsigned int i = 0; i < allVariables.size(); ++i)
+  {
+    if (!allVariables[i].isDer())
+      continue;
+
+    unsigned int state;
+    if (!getVariableIndex(static_cast<int>(allVariables[i].getStateIndex()), state))
+      return logError("FMU \"" + std::string(getCref()) + "\": unknown state of derivative " + std::string(allVariables[i].getCref()));
+
+    if (allVariables[i].isContinuousTimeDer())
+    {
+      allVariables[state].markAsContinuousTimeState(i);
+      stateIndices[state] = static_cast<unsigned int>(derivatives.size());
+      derivatives.push_back(i);
+    }
+    else
+      allVariables[state].markAsState(i);
+  }
+
+  return oms_status_ok;
+}
+
+/**
+ * @brief Creates the variable maps, connectors and dependency graphs of the
+ * FMU from allVariables.
+ */
+oms_status_enu_t oms::ComponentFMUMEBase::initializeConnectors()
+{
+  // create some special variable maps
+  for (auto const& v : allVariables)
+  {
+    if (v.isInput())
+      inputs.push_back(v.getIndex());
+    else if (v.isOutput())
+    {
+      outputs.push_back(v.getIndex());
+      outputsGraph.addNode(Connector(oms_causality_output, v.getType(), v.getCref(), getFullCref()));
+    }
+    else if (v.isParameter())
+      parameters.push_back(v.getIndex());
+    else if (v.isCalculatedParameter())
+      calculatedParameters.push_back(v.getIndex());
+
+    if (v.isInitialUnknown())
+      initialUnknownsGraph.addNode(Connector(v.getCausality(), v.getType(), v.getCref(), getFullCref()));
+
+    exportVariables.push_back(v.isInput() || v.isOutput());
+  }
+
+  // create connectors
+  while (connectors.size() > 0 && NULL == connectors.back())
+    connectors.pop_back();
+
+  int j = 1;
+  int size = 1 + inputs.size();
+  for (const auto& i : inputs)
+    connectors.push_back(new Connector(oms_causality_input, allVariables[i].getType(), allVariables[i].getCref(), getFullCref(), j++/(double)size));
+  j = 1;
+  size = 1 + outputs.size();
+  for (const auto& i : outputs)
+    connectors.push_back(new Connector(oms_causality_output, allVariables[i].getType(), allVariables[i].getCref(), getFullCref(), j++/(double)size));
+  for (const auto& i : parameters)
+    connectors.push_back(new Connector(oms_causality_parameter, allVariables[i].getType(), allVariables[i].getCref(), getFullCref()));
+  for (const auto& i : calculatedParameters)
+    connectors.push_back(new Connector(oms_causality_calculatedParameter, allVariables[i].getType(), allVariables[i].getCref(), getFullCref()));
+  connectors.push_back(NULL);
+  element.setConnectors(&connectors[0]);
+
+  if (oms_status_ok != initializeDependencyGraph_initialUnknowns())
+    return logError(std::string(getCref()) + ": Couldn't initialize dependency graph for initial unknowns.");
+  if (oms_status_ok != initializeDependencyGraph_outputs())
+    return logError(std::string(getCref()) + ": Couldn't initialize dependency graph for simulation unknowns.");
+
+  // set units to connector
+  for (auto &connector : connectors)
+  {
+    if (connector)
+    {
+      oms::ComRef connectorCref = connector->getName();
+      std::string unitName = values.getUnitFromModeldescription(connectorCref);
+      if (!unitName.empty())
+        connector->connectorUnits[unitName] = values.modeldescriptionUnitDefinitions[unitName];
+
+      // get enumerationTypes
+      std::string enumType = values.getEnumerationTypeFromModeldescription(connectorCref);
+      if (!enumType.empty())
+        connector->enumerationName[connectorCref] = enumType;
+    }
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUMEBase::initializeDependencyGraph_initialUnknowns()
+{
+  if (initialUnknownsGraph.getEdges().connections.size() > 0)
+    return logError(std::string(getCref()) + ": " + getPath() + " is already initialized");
+
+  // Check if initial unknowns from modelDescription.xml are the same as in initialUnknownsGraph
+  size_t N_ModelStructure = values.modelStructureInitialUnknowns.size();
+  size_t N = initialUnknownsGraph.getNodes().size();
+
+  bool badInitialUnknowns = false;
+
+  std::unordered_set<unsigned int> setA_ModelStructure;
+  for (const auto &it : values.modelStructureInitialUnknowns)
+  {
+    unsigned int index;
+    if (getVariableIndex(it.first, index))
+      setA_ModelStructure.insert(index);
+  }
+
+  std::string missing_unknowns = "";
+  for (auto &v : allVariables)
+  {
+    if (v.isInitialUnknown() && setA_ModelStructure.find(v.getIndex()) == setA_ModelStructure.end())
+    {
+      badInitialUnknowns = true;
+      missing_unknowns += "\n  * " + std::to_string(getModelStructureReference(v.getIndex())) + ": " + std::string(v.getCref()) + " is missing";
+    }
+  }
+
+  for (const auto &it : values.modelStructureInitialUnknowns)
+  {
+    unsigned int index;
+    if (!getVariableIndex(it.first, index))
+    {
+      missing_unknowns += "\n  * " + std::to_string(it.first) + ": could not be found";
+      badInitialUnknowns = true;
+    }
+    else if (!allVariables[index].isInitialUnknown())
+    {
+      missing_unknowns += "\n  * " + std::to_string(it.first) + ": " + std::string(allVariables[index].getCref()) + " is wrongly listed";
+      badInitialUnknowns = true;
+    }
+  }
+
+  if (badInitialUnknowns && !Flags::IgnoreInitialUnknowns() && N_ModelStructure > 0)
+    logWarning("[" + std::string(getCref()) + ": " + getPath() + "] The FMU lists " + std::to_string(N_ModelStructure) + " initial unknowns and exposes " + std::to_string(N) + " initial unknowns." + missing_unknowns);
+
+  if (badInitialUnknowns)
+  {
+    if(!Flags::IgnoreInitialUnknowns() && N_ModelStructure > 0)
+      logInfo("[" + std::string(getCref()) + ": " + getPath() + "] The FMU contains bad initial unknowns. This might cause problems, e.g. wrong simulation results.");
+    else
+    {
+      if (N_ModelStructure > 0)
+        logWarning("[" + std::string(getCref()) + ": " + getPath() + "] The dependencies of the initial unknowns defined in the FMU are ignored because the flag --ignoreInitialUnknowns is active. Instead, all the initial unknowns will depend on all inputs.");
+      for (size_t i = 0; i < N; i++)
+      {
+        logDebug(std::string(getCref()) + ": " + getPath() + " initial unknown " + std::string(initialUnknownsGraph.getNodes()[i]) + " depends on all inputs");
+        for (const auto& j : inputs)
+          initialUnknownsGraph.addEdge(allVariables[j].makeConnector(this->getFullCref()), initialUnknownsGraph.getNodes()[i]);
+      }
+      return oms_status_ok;
+    }
+  }
+
+  // get the initial unknowns dependencies
+  for (const auto &it : values.modelStructureInitialUnknowns)
+  {
+    unsigned int unknownIndex;
+    if (!getVariableIndex(it.first, unknownIndex))
+      continue;
+    const Connector unknown = allVariables[unknownIndex].makeConnector(this->getFullCref());
+
+    // no dependencies
+    if (it.second.empty() && values.modelStructureInitialUnknownsDependencyExist[it.first])
+      logDebug(std::string(getCref()) + ": " + getPath() + " initial unknown " + std::string(unknown) + " has no dependencies");
+
+    // dependency attribute not provided in modeldescription.xml, all output depends on all inputs
+    else if (it.second.empty() && !values.modelStructureInitialUnknownsDependencyExist[it.first])
+    {
+      logDebug(std::string(getCref()) + ": " + getPath() + " initial unknown " + std::string(unknown) + " depends on all inputs");
+      for (const auto& j : inputs)
+        initialUnknownsGraph.addEdge(allVariables[j].makeConnector(this->getFullCref()), unknown);
+    }
+    else
+    {
+      //dependency exist
+      for (const auto &reference : it.second)
+      {
+        unsigned int index;
+        if (!getVariableIndex(reference, index))
+        {
+          logWarning("Initial unknown " + std::string(unknown) + " has bad dependency on variable with index " + std::to_string(reference) + " which couldn't be resolved");
+          return logError(std::string(getCref()) + ": Erroneous initial unknowns detected in modelDescription.xml\nUse flag --ignoreInitialUnknowns=true to ignore all initial unknowns, but this can cause inflated loop size.");
+        }
+        logDebug(std::string(getCref()) + ": " + getPath() + " initial unknown " + std::string(unknown) + " depends on " + std::string(allVariables[index]));
+        initialUnknownsGraph.addEdge(allVariables[index].makeConnector(this->getFullCref()), unknown);
+      }
+    }
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentFMUMEBase::initializeDependencyGraph_outputs()
+{
+  if (outputsGraph.getEdges().connections.size() > 0)
+  {
+    logError(std::string(getCref()) + ": " + getPath() + " is already initialized.");
+    return oms_status_error;
+  }
+
+  // get the output dependencies
+  for (const auto &it : values.modelStructureOutputs)
+  {
+    unsigned int outputIndex;
+    if (!getVariableIndex(it.first, outputIndex))
+      return logError(std::string(getCref()) + ": output " + std::to_string(it.first) + " of the model structure couldn't be resolved");
+    Variable& output = allVariables[outputIndex];
+
+    // no dependencies
+    if (it.second.empty() && values.modelStructureOutputDependencyExist[it.first])
+    {
+      logDebug(std::string(getCref()) + ": " + getPath() + " output " + std::string(output) + " has no dependencies");
+    }
+    // dependency attribute not provided in modeldescription.xml, all output depends on all inputs
+    else if (it.second.empty() && !values.modelStructureOutputDependencyExist[it.first])
+    {
+      logDebug(std::string(getCref()) + ": " + getPath() + " output " + std::string(output) + " depends on all");
+      for (const auto& j : inputs)
+        outputsGraph.addEdge(allVariables[j].makeConnector(this->getFullCref()), output.makeConnector(this->getFullCref()));
+    }
+    else
+    {
+      for (const auto &reference : it.second)
+      {
+        unsigned int index;
+        if (!getVariableIndex(reference, index))
+        {
+          logWarning("Output " + std::string(output) + " has bad dependency on variable with index " + std::to_string(reference) + " which couldn't be resolved");
+          return logError(std::string(getCref()) + ": erroneous dependencies detected in modelDescription.xml");
+        }
+        logDebug(std::string(getCref()) + ": " + getPath() + " output " + std::string(output) + " depends on " + std::string(allVariables[index]));
+        outputsGraph.addEdge(allVariables[index].makeConnector(this->getFullCref()), output.makeConnector(this->getFullCref()));
+      }
+    }
+  }
+
+  return oms_status_ok;
+}
+
+void oms::ComponentFMUMEBase::getDependencies(const std::map<int, std::vector<int>>& modelStructure, const std::map<int, bool>& dependencyExist, unsigned int index, std::vector<unsigned int>& stateDependencies, std::vector<ComRef>& inputDependencies) const
+{
+  const int reference = getModelStructureReference(index);
+  auto it = modelStructure.find(reference);
+  auto exist = dependencyExist.find(reference);
+
+  // dependency attribute not provided in modeldescription.xml, depends on all
+  if (it == modelStructure.end() || (it->second.empty() && (exist == dependencyExist.end() || !exist->second)))
+  {
+    for (unsigned int k = 0; k < derivatives.size(); ++k)
+      stateDependencies.push_back(k);
+    for (const auto& i : inputs)
+      inputDependencies.push_back(allVariables[i].getCref());
+    return;
+  }
+
+  for (const auto& dependency : it->second)
+  {
+    unsigned int variable;
+    if (!getVariableIndex(dependency, variable))
+      continue;
+
+    auto state = stateIndices.find(variable);
+    if (state != stateIndices.end())
+      stateDependencies.push_back(state->second);
+    else if (allVariables[variable].isInput())
+      inputDependencies.push_back(allVariables[variable].getCref());
+  }
+}
+
+void oms::ComponentFMUMEBase::getStateDerivativeDependencies(size_t k, std::vector<unsigned int>& stateDependencies, std::vector<ComRef>& inputDependencies) const
+{
+  getDependencies(values.modelStructureDerivatives, values.modelStructureDerivativesDependencyExist, derivatives[k], stateDependencies, inputDependencies);
+}
+
+oms_status_enu_t oms::ComponentFMUMEBase::getOutputDependencies(const ComRef& output, std::vector<unsigned int>& stateDependencies, std::vector<ComRef>& inputDependencies) const
+{
+  for (const auto& i : outputs)
+  {
+    if (allVariables[i].getCref() == output)
+    {
+      getDependencies(values.modelStructureOutputs, values.modelStructureOutputDependencyExist, i, stateDependencies, inputDependencies);
+      return oms_status_ok;
+    }
+  }
+
+  return logError_UnknownSignal(getFullCref() + output);
+}
@@ -0,0 +1,113 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef _OMS_COMPONENT_FMU_ME_BASE_H_
+#define _OMS_COMPONENT_FMU_ME_BASE_H_
+
+#include "Component.h"
+#include "ComRef.h"
+#include "FMUInfo.h"
+#include "Values.h"
+#include "Variable.h"
+
+#include <fmi4c.h>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace oms
+{
+  class System;
+
+  /**
+   * @brief Model exchange FMU, common to FMI 2.0 and FMI 3.0.
+   *
+   * Holds the variables, continuous states, event indicators and dependencies
+   * of the FMU. The model structure refers to variables by index (FMI 2.0) or
+   * by value reference (FMI 3.0); the derived classes resolve these references
+   * and make the FMI calls.
+   */
+  class ComponentFMUMEBase : public Component
+  {
+  public:
+    const FMUInfo* getFMUInfo() const {return &(this->fmuInfo);}
+    fmiHandle* getFMU() {return fmu;}
+    fmi2EventInfo* getEventInfo() {return &eventInfo;}
+
+    oms_status_enu_t initializeDependencyGraph_initialUnknowns();
+    oms_status_enu_t initializeDependencyGraph_outputs();
+
+    size_t getNumberOfContinuousStates() const {return derivatives.size();}
+    size_t getNumberOfEventIndicators() const {return nEventIndicators;}
+
+    void getStateDerivativeDependencies(size_t k, std::vector<unsigned int>& stateDependencies, std::vector<ComRef>& inputDependencies) const;
+    oms_status_enu_t getOutputDependencies(const ComRef& output, std::vector<unsigned int>& stateDependencies, std::vector<ComRef>& inputDependencies) const;
+
+  protected:
+    ComponentFMUMEBase(const ComRef& cref, oms_component_enu_t type, System* parentSystem, const std::string& fmuPath);
+
+    // stop the compiler generating methods copying the object
+    ComponentFMUMEBase(ComponentFMUMEBase const& copy);            ///< not implemented
+    ComponentFMUMEBase& operator=(ComponentFMUMEBase const& copy); ///< not implemented
+
+    /// reference of allVariables[index] in the model structure
+    virtual int getModelStructureReference(unsigned int index) const = 0;
+    /// index in allVariables of a reference in the model structure; false if it doesn't refer to a variable
+    virtual bool getVariableIndex(int reference, unsigned int& index) const = 0;
+
+    oms_status_enu_t initializeStates();
+    oms_status_enu_t initializeConnectors();
+
+    void getDependencies(const std::map<int, std::vector<int>>& modelStructure, const std::map<int, bool>& dependencyExist, unsigned int index, std::vector<unsigned int>& stateDependencies, std::vector<ComRef>& inputDependencies) const;
+
+  protected:
+    fmiHandle *fmu = NULL;
+    FMUInfo fmuInfo;
+
+    fmi2EventInfo eventInfo; ///< result of the last event iteration, mapped from fmi3UpdateDiscreteStates for FMI 3.0
+    size_t nEventIndicators = 0;
+
+    std::vector<Variable> allVariables;
+    std::vector<unsigned int> calculatedParameters;
+    std::vector<unsigned int> derivatives;
+    std::vector<unsigned int> inputs;
+    std::vector<unsigned int> outputs;
+    std::vector<unsigned int> parameters;
+    std::vector<bool> exportVariables;
+
+    Values values; ///< start values defined before instantiating the FMU and external inputs defined after initialization
+
+    std::unordered_map<unsigned int /*allVariables ID*/, unsigned int /*continuous state index*/> stateIndices;
+  };
+}
+
+#endif
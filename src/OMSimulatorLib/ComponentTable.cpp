@@ -432,6 +432,23 @@ oms_status_enu_t oms::ComponentTable::restoreState()
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::ComponentTable::serializeState(Checkpoint& checkpoint)
+{
+  checkpoint.writeValue(time);
+  checkpoint.writeValue<uint64_t>(lastIndex);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::ComponentTable::deserializeState(Checkpoint& checkpoint)
+{
+  uint64_t index;
+  if (!checkpoint.readValue(time) || !checkpoint.readValue(index))
+    return logError("Checkpoint doesn't match " + std::string(getFullCref()));
+
+  lastIndex = index;
+  return oms_status_ok;
+}
+
 void oms::ComponentTable::getFilteredSignals(std::vector<Connector>& filteredSignals) const
 {
   for (auto& x: exportSeries)
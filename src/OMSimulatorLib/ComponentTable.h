@@ -80,6 +80,9 @@ namespace oms
     oms_status_enu_t saveState();
     oms_status_enu_t freeState();
     oms_status_enu_t restoreState();
+    bool getCanSerializeState() {return true;}
+    oms_status_enu_t serializeState(Checkpoint& checkpoint);
+    oms_status_enu_t deserializeState(Checkpoint& checkpoint);
 
     void getFilteredSignals(std::vector<Connector>& filteredSignals) const;
 
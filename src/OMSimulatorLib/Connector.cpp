@@ -92,6 +92,7 @@ oms::Connector::Connector(const oms::Connector& rhs)
 
   this->owner = allocateAndCopyString(rhs.owner);
   this->name = allocateAndCopyString(rhs.name);
+  this->arraySize = rhs.arraySize;
 
   if (rhs.geometry)
     this->geometry = reinterpret_cast<ssd_connector_geometry_t*>(new oms::ssd::ConnectorGeometry(*reinterpret_cast<oms::ssd::ConnectorGeometry*>(rhs.geometry)));
@@ -115,6 +116,7 @@ oms::Connector& oms::Connector::operator=(const oms::Connector& rhs)
   if (this->name)
     delete[] this->name;
   this->name = allocateAndCopyString(rhs.name);
+  this->arraySize = rhs.arraySize;
 
   this->setGeometry(reinterpret_cast<oms::ssd::ConnectorGeometry*>(rhs.geometry));
 
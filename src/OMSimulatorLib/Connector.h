@@ -71,6 +71,9 @@ namespace oms
     void setOwner(const oms::ComRef& owner);
     void setGeometry(const oms::ssd::ConnectorGeometry* newGeometry);
     oms_status_enu_t setExportName(const std::string & exportName) { this->exportName = exportName; return oms_status_ok;};
+    void setArraySize(size_t arraySize) { this->arraySize = arraySize; }
+    size_t getArraySize() const { return arraySize; }
+    bool isArray() const { return arraySize != 1; }
     std::string getExportName() const { return this->exportName; }
 
     std::map<std::string, std::map<std::string, std::string>> connectorUnits;  ///< single entry map which contains unit as key and BaseUnits as value for a connector
@@ -98,6 +101,7 @@ namespace oms
     friend bool operator==(const Connector& v1, const Connector& v2);
     friend bool operator!=(const Connector& v1, const Connector& v2);
     std::string exportName;  ///< name to be used in result file
+    size_t arraySize = 1;    ///< number of elements of an FMI 3.0 array variable, which is connected as a whole
   };
 
   bool operator==(const Connector& v1, const Connector& v2);
@@ -31,6 +31,7 @@
 
 #include "DirectedGraph.h"
 #include "Connection.h"
+#include "Flags.h"
 #include "Logging.h"
 #include "Util.h"
 #include "Variable.h"
@@ -48,6 +49,7 @@
 oms::DirectedGraph::DirectedGraph()
 {
   sortedConnectionsAreValid = true;
+  sortedConnectionsAreTorn = false;
 }
 
 oms::DirectedGraph::~DirectedGraph()
@@ -60,11 +62,15 @@ void oms::DirectedGraph::clear()
   sortedConnections.clear();
   nodes.clear();
   edges.connections.clear();
+  edgeIndices.clear();
+  nodeIndices.clear();
+  unitConversion.clear();
   sortedConnectionsAreValid = true;
 }
 
 int oms::DirectedGraph::addNode(const oms::Connector& var)
 {
+  nodeIndices.insert(std::make_pair(var.getName(), static_cast<int>(nodes.size())));
   nodes.push_back(var);
   std::vector<int> row;
   G.push_back(row);
@@ -73,26 +79,15 @@ int oms::DirectedGraph::addNode(const oms::Connector& var)
 
 void oms::DirectedGraph::addEdge(const oms::Connector& var1, const oms::Connector& var2)
 {
-  int index1 = -1;
-  int index2 = -1;
-
-  for (int i = 0; i < nodes.size(); ++i)
-  {
-    if (var1 == nodes[i])
-      index1 = i;
-
-    if (var2 == nodes[i])
-      index2 = i;
-
-    if (index1 != -1 && index2 != -1)
-      break;
-  }
+  int index1 = getNodeIndex(var1);
+  int index2 = getNodeIndex(var2);
 
   if (-1 == index1)
     index1 = addNode(var1);
   if (-1 == index2)
     index2 = addNode(var2);
 
+  edgeIndices.insert(std::make_pair((static_cast<unsigned long long>(index1) << 32) | static_cast<unsigned int>(index2), static_cast<int>(edges.connections.size())));
   edges.connections.push_back(std::pair<int, int>(index1, index2));
   G[index1].push_back(index2);
   sortedConnectionsAreValid = false;
@@ -146,107 +141,154 @@ void oms::DirectedGraph::includeGraph(const oms::DirectedGraph& graph, const oms
     addEdge(graph.nodes[graph.edges.connections[i].first].addPrefix(prefix), graph.nodes[graph.edges.connections[i].second].addPrefix(prefix));
 }
 
-int oms::DirectedGraph::getEdgeIndex(const scc_t& edges, int from, int to)
+void oms::DirectedGraph::renameModel(const oms::ComRef& model)
 {
-  for (int i = 0; i < edges.connections.size(); ++i)
-    if (edges.connections[i].first == from && edges.connections[i].second == to)
+  // the owners are full crefs, i.e. model.system[.component]
+  for (auto& node : nodes)
+  {
+    ComRef tail(node.getOwner());
+    tail.pop_front();
+    node.setOwner(model + tail);
+  }
+
+  for (auto& scc : sortedConnections)
+  {
+    std::set<oms::ComRef> component_names;
+    for (const auto& name : scc.component_names)
+    {
+      ComRef tail(name);
+      tail.pop_front();
+      component_names.insert(model + tail);
+    }
+    scc.component_names = component_names;
+  }
+}
+
+int oms::DirectedGraph::getNodeIndex(const oms::Connector& var) const
+{
+  auto it = nodeIndices.find(var.getName());
+  if (it == nodeIndices.end())
+    return -1;
+
+  if (var == nodes[it->second])
+    return it->second;
+
+  // same name, but different type or causality
+  for (int i = it->second + 1; i < nodes.size(); ++i)
+    if (var == nodes[i])
       return i;
 
-  logError("getEdgeIndex failed");
   return -1;
 }
 
-void oms::DirectedGraph::strongconnect(int v, std::vector< std::vector<int> > G, int& index, int *d, int *low, std::stack<int>& S, bool *stacked, std::deque< std::vector<int> >& components)
+int oms::DirectedGraph::getEdgeIndex(int from, int to) const
 {
-  // Set the depth index for v to the smallest unused index
-  d[v] = index;
-  low[v] = index;
-  index++;
-  S.push(v);
-  stacked[v] = true;
-
-  // Consider successors of v
-  std::vector<int> successors = G[edges.connections[v].second];
-  for (int i = 0; i < successors.size(); ++i)
-  {
-    int w = getEdgeIndex(edges, edges.connections[v].second, successors[i]);
-    if (d[w] == -1)
-    {
-      // Successor w has not yet been visited; recurse on it
-      strongconnect(w, G, index, d, low, S, stacked, components);
-      low[v] = (std::min)(low[v], low[w]); // this is done to make windows compile std::min => (std::min)
-    }
-    else if (stacked[w])
-    {
-      // Successor w is in stack S and hence in the current SCC
-      // Note: The next line may look odd - but is correct.
-      // It says w.index not w.lowlink; that is deliberate and from the original paper
-      low[v] = (std::min)(low[v], d[w]);  // this is done to make windows compile std::min => (std::min)
-    }
-  }
+  auto it = edgeIndices.find((static_cast<unsigned long long>(from) << 32) | static_cast<unsigned int>(to));
+  if (it != edgeIndices.end())
+    return it->second;
 
-  // If v is a root node, pop the stack and generate an SCC
-  if (low[v] == d[v])
-  {
-    // start a new strongly connected component
-    std::vector<int> SCC;
-    int w;
-    do
-    {
-      w = S.top();
-      S.pop();
-      stacked[w] = false;
-      // add w to current strongly connected component
-      SCC.push_back(w);
-    } while (w != v);
-    // output the current strongly connected component
-    components.push_front(SCC);
-  }
+  logError("getEdgeIndex failed");
+  return -1;
 }
 
+/**
+ * @brief Tarjan's strongly connected components algorithm
+ *
+ * The vertices are the edges of the graph; edge w is a successor of edge v
+ * if w starts at the node where v ends. The depth-first search is iterative
+ * and runs on a compressed (CSR) successor list, so that long chains don't
+ * exhaust the call stack.
+ *
+ * @return Strongly connected components in topological order
+ */
 std::deque< std::vector<int> > oms::DirectedGraph::getSCCs()
 {
-  //std::cout << "Tarjan's strongly connected components algorithm" << std::endl;
-
-  size_t numVertices = edges.connections.size();
-  int *d = new int[numVertices];
-  std::fill(d, d + numVertices, -1);
-  int *low = new int[numVertices];
-  int *scc = new int[numVertices];
-  bool *stacked = new bool[numVertices];
-  std::stack<int> S;
+  const int numVertices = static_cast<int>(edges.connections.size());
+
+  // successors of vertex v are successors[successorPointers[n]..successorPointers[n+1]-1] with n = edges.connections[v].second
+  std::vector<int> successorPointers(nodes.size() + 1, 0);
+  std::vector<int> successors;
+  successors.reserve(numVertices);
+  for (size_t n = 0; n < nodes.size(); ++n)
+  {
+    for (int target : G[n])
+      successors.push_back(getEdgeIndex(static_cast<int>(n), target));
+    successorPointers[n + 1] = static_cast<int>(successors.size());
+  }
+
+  std::vector<int> d(numVertices, -1);
+  std::vector<int> low(numVertices, 0);
+  std::vector<int> next(numVertices, 0);  // next successor to visit
+  std::vector<bool> stacked(numVertices, false);
+  std::vector<int> S;
+  std::vector<int> callStack;
   int index = 0;
   std::deque< std::vector<int> > components;
 
-  for (int v = 0; v < numVertices; ++v)
+  for (int root = 0; root < numVertices; ++root)
   {
-    if (d[v] == -1)
-      strongconnect(v, G, index, d, low, S, stacked, components);
-  }
+    if (d[root] != -1)
+      continue;
 
-  // dump strongly connected components
-  //std::cout << "Strongly connected components:" << std::endl;
-  //for (int i=0; i<components.size(); ++i)
-  //{
-  //  for (int j=0; j<components[i].size(); ++j)
-  //  {
-  //    int v = components[i][j];
-  //    std::cout << nodes[v].getFMUInstanceName() << "." << nodes[v].getName() << " ";
-  //  }
-  //  std::cout << std::endl;
-  //}
-
-  delete[] d;
-  delete[] low;
-  delete[] scc;
-  delete[] stacked;
+    d[root] = low[root] = index++;
+    next[root] = successorPointers[edges.connections[root].second];
+    S.push_back(root);
+    stacked[root] = true;
+    callStack.push_back(root);
+
+    while (!callStack.empty())
+    {
+      const int v = callStack.back();
+      if (next[v] < successorPointers[edges.connections[v].second + 1])
+      {
+        const int w = successors[next[v]++];
+        if (d[w] == -1)
+        {
+          // Successor w has not yet been visited; descend into it
+          d[w] = low[w] = index++;
+          next[w] = successorPointers[edges.connections[w].second];
+          S.push_back(w);
+          stacked[w] = true;
+          callStack.push_back(w);
+        }
+        else if (stacked[w])
+        {
+          // Successor w is in stack S and hence in the current SCC
+          // Note: It is w.index not w.lowlink; that is deliberate and from the original paper
+          low[v] = (std::min)(low[v], d[w]);  // this is done to make windows compile std::min => (std::min)
+        }
+        continue;
+      }
+
+      // all successors of v are done
+      callStack.pop_back();
+
+      // If v is a root node, pop the stack and generate an SCC
+      if (low[v] == d[v])
+      {
+        std::vector<int> SCC;
+        int w;
+        do
+        {
+          w = S.back();
+          S.pop_back();
+          stacked[w] = false;
+          SCC.push_back(w);
+        } while (w != v);
+        components.push_front(SCC);
+      }
+
+      if (!callStack.empty())
+        low[callStack.back()] = (std::min)(low[callStack.back()], low[v]);
+    }
+  }
 
   return components;
 }
 
 const std::vector<oms::scc_t>& oms::DirectedGraph::getSortedConnections()
 {
-  if (!sortedConnectionsAreValid)
+  if (!sortedConnectionsAreValid || sortedConnectionsAreTorn != Flags::AlgLoopTearing())
     calculateSortedConnections();
   return sortedConnections;
 }
@@ -320,13 +362,20 @@ void oms::DirectedGraph::calculateSortedConnections()
     scc.thisIsALoop = (components[i].size() > 1);
     scc.size = scc.connections.size();
     scc.size_including_internal = components[i].size();
+    scc.tearSize = scc.size;
 
     if (scc.size > 0)
     {
       if (scc.thisIsALoop)
       {
+        if (Flags::AlgLoopTearing())
+          tearLoop(components[i], scc);
+
         std::stringstream ss;
-        ss << "Alg. loop (size " << scc.size << "/" << scc.size_including_internal << ")" << std::endl;
+        ss << "Alg. loop (size " << scc.size << "/" << scc.size_including_internal;
+        if (scc.tearSize < scc.size)
+          ss << ", " << scc.tearSize << " tear variables";
+        ss << ")" << std::endl;
         for (const auto& name: scc.component_names)
           ss << "  " << std::string(name) << std::endl;
         logInfo(ss.str());
@@ -336,6 +385,172 @@ void oms::DirectedGraph::calculateSortedConnections()
   }
 
   sortedConnectionsAreValid = true;
+  sortedConnectionsAreTorn = Flags::AlgLoopTearing();
+}
+
+/**
+ * @brief Select the iteration variables of an algebraic loop.
+ *
+ * The output of connection j depends on the input of connection i if the
+ * loop contains a path of internal (feedthrough) edges from the input of i
+ * to the output of j. A greedy heuristic selects a small set of tear
+ * connections such that the remaining connections can be evaluated in
+ * sequence. The connections of the loop are reordered: the tear
+ * connections first, then the others in evaluation order.
+ *
+ * @param component   Edges of the strongly connected component
+ * @param scc         Loop to be torn
+ */
+void oms::DirectedGraph::tearLoop(const std::vector<int>& component, scc_t& scc) const
+{
+  const int n = static_cast<int>(scc.connections.size());
+
+  // internal edges of the loop
+  std::map<int, std::vector<int>> internalEdges;
+  std::set<std::pair<int, int>> connections(scc.connections.begin(), scc.connections.end());
+  for (int e : component)
+    if (connections.find(edges.connections[e]) == connections.end())
+      internalEdges[edges.connections[e].first].push_back(edges.connections[e].second);
+
+  std::map<int, std::vector<int>> outputConnections;
+  for (int j = 0; j < n; ++j)
+    outputConnections[scc.connections[j].first].push_back(j);
+
+  // dependencies between the connections of the loop
+  std::vector< std::vector<int> > successors(n);
+  std::vector< std::vector<int> > predecessors(n);
+  for (int i = 0; i < n; ++i)
+  {
+    std::set<int> visited;
+    std::stack<int> S;
+    S.push(scc.connections[i].second);
+    while (!S.empty())
+    {
+      const int node = S.top();
+      S.pop();
+      if (!visited.insert(node).second)
+        continue;
+
+      auto outputs = outputConnections.find(node);
+      if (outputs != outputConnections.end())
+      {
+        for (int j : outputs->second)
+        {
+          successors[i].push_back(j);
+          predecessors[j].push_back(i);
+        }
+      }
+
+      auto next = internalEdges.find(node);
+      if (next != internalEdges.end())
+        for (int w : next->second)
+          S.push(w);
+    }
+  }
+
+  // connections that depend on themselves have to be torn
+  std::vector<bool> tear(n, false);
+  std::vector<bool> removed(n, false);
+  for (int i = 0; i < n; ++i)
+  {
+    if (std::find(successors[i].begin(), successors[i].end(), i) != successors[i].end())
+    {
+      tear[i] = true;
+      removed[i] = true;
+    }
+  }
+
+  while (true)
+  {
+    // connections without remaining predecessors or successors aren't part of a cycle
+    bool changed = true;
+    while (changed)
+    {
+      changed = false;
+      for (int v = 0; v < n; ++v)
+      {
+        if (removed[v])
+          continue;
+        bool hasPredecessor = false;
+        for (int u : predecessors[v])
+          hasPredecessor |= !removed[u];
+        bool hasSuccessor = false;
+        for (int w : successors[v])
+          hasSuccessor |= !removed[w];
+        if (!hasPredecessor || !hasSuccessor)
+        {
+          removed[v] = true;
+          changed = true;
+        }
+      }
+    }
+
+    // tear the connection that is part of the most cycles, approximately
+    int best = -1;
+    int bestScore = -1;
+    for (int v = 0; v < n; ++v)
+    {
+      if (removed[v])
+        continue;
+      int in = 0, out = 0;
+      for (int u : predecessors[v])
+        if (!removed[u]) in++;
+      for (int w : successors[v])
+        if (!removed[w]) out++;
+      if (in * out > bestScore)
+      {
+        best = v;
+        bestScore = in * out;
+      }
+    }
+    if (best < 0)
+      break;
+    tear[best] = true;
+    removed[best] = true;
+  }
+
+  // evaluation order of the remaining connections
+  std::vector<int> order;
+  std::vector<int> inDegree(n, 0);
+  for (int i = 0; i < n; ++i)
+    if (tear[i])
+      order.push_back(i);
+  const size_t tearSize = order.size();
+  if (tearSize == static_cast<size_t>(n))
+    return;
+
+  for (int i = 0; i < n; ++i)
+    if (!tear[i])
+      for (int j : successors[i])
+        if (!tear[j])
+          inDegree[j]++;
+  for (size_t k = 0; k < static_cast<size_t>(n); ++k)
+  {
+    for (int v = 0; v < n; ++v)
+    {
+      if (!tear[v] && inDegree[v] == 0)
+      {
+        inDegree[v] = -1;
+        order.push_back(v);
+        for (int w : successors[v])
+          if (!tear[w])
+            inDegree[w]--;
+        break;
+      }
+    }
+  }
+
+  if (order.size() != static_cast<size_t>(n))
+  {
+    logWarning("Tearing of algebraic loop failed; all connections are used as iteration variables");
+    return;
+  }
+
+  std::vector< std::pair<int, int> > sorted;
+  for (int i : order)
+    sorted.push_back(scc.connections[i]);
+  scc.connections = sorted;
+  scc.tearSize = static_cast<unsigned int>(tearSize);
 }
 
 void oms::DirectedGraph::setUnits(Connector* conA, Connector* conB, bool suppressUnitConversion)
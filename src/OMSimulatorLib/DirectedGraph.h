@@ -41,6 +41,7 @@
 #include <set>
 #include <stack>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace oms
@@ -56,6 +57,7 @@ namespace oms
     bool thisIsALoop; // needed because a SSC with just one connection can be a loop! fmu.y -> fmu.u
     unsigned int size;
     unsigned int size_including_internal;
+    unsigned int tearSize; ///< the first tearSize connections are the iteration variables of a loop, the others are evaluated in the given order
     std::set<oms::ComRef> component_names;
     double factor;
     bool suppressUnitConversion;
@@ -75,6 +77,7 @@ namespace oms
     void dotExport(const std::string& filename);
 
     void includeGraph(const DirectedGraph& graph, const ComRef& prefix);
+    void renameModel(const ComRef& model); ///< replaces the model name in the owners of all nodes, e.g. for a clone of the model
 
     const std::vector< scc_t >& getSortedConnections();
 
@@ -87,17 +90,22 @@ namespace oms
   private:
     std::deque< std::vector<int> > getSCCs();
     void calculateSortedConnections();
-    void strongconnect(int v, std::vector< std::vector<int> > G, int& index, int *d, int *low, std::stack<int>& S, bool *stacked, std::deque< std::vector<int> >& components);
 
-    static int getEdgeIndex(const scc_t& edges, int from, int to);
+    void tearLoop(const std::vector<int>& component, scc_t& scc) const;
+
+    int getNodeIndex(const Connector& var) const;
+    int getEdgeIndex(int from, int to) const;
 
   private:
     std::vector<Connector> nodes;
     scc_t edges;
 
     std::vector< std::vector<int> > G;
+    std::unordered_map<ComRef, int> nodeIndices; ///< first node for each name, see getNodeIndex()
+    std::unordered_map<unsigned long long, int> edgeIndices; ///< first edge for each pair of nodes, see getEdgeIndex()
     std::vector< scc_t > sortedConnections;
     bool sortedConnectionsAreValid;
+    bool sortedConnectionsAreTorn; ///< value of Flags::AlgLoopTearing() used for sortedConnections
 
     struct suppressUnitConversion
     {
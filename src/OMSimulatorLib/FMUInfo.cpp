@@ -168,6 +168,7 @@ void oms::FMUInfo::updateFMI3Info(fmiHandle* fmu)
     this->needsExecutionTool = fmi3cs_getNeedsExecutionTool(fmu) > 0;
     this->providesDirectionalDerivative = fmi3cs_getProvidesDirectionalDerivative(fmu) > 0;
     this->maxOutputDerivativeOrder = fmi3cs_getMaxOutputDerivativeOrder(fmu);
+    this->hasEventMode = fmi3cs_getHasEventMode(fmu) > 0;
     // TODO handle the following FMI3 CS attributes
     // providesIntermediateUpdate
     // mightReturnEarlyFromDoStep
@@ -176,7 +177,6 @@ void oms::FMUInfo::updateFMI3Info(fmiHandle* fmu)
     // canHandleVariableCommunicationStepSize
     // canReturnEarlyAfterIntermediateUpdate
     // fixedInternalStepSize
-    // hasEventMode
   }
 
   if (oms_fmi_kind_me == fmiKind || oms_fmi_kind_me_and_cs == fmiKind)
@@ -53,15 +53,20 @@ namespace oms
     oms_fmi_kind_enu_t getKind() const {return fmiKind;}
 
     bool getCanInterpolateInputs() const {return canInterpolateInputs;}
+    bool getCanBeInstantiatedOnlyOncePerProcess() const {return canBeInstantiatedOnlyOncePerProcess;}
     bool getCanGetAndSetFMUstate() const {return canGetAndSetFMUstate;}
+    bool getCanSerializeFMUstate() const {return canSerializeFMUstate;}
     unsigned int getMaxOutputDerivativeOrder() const {return maxOutputDerivativeOrder;}
     bool getProvidesDirectionalDerivative() const {return providesDirectionalDerivative;}
     std::string getGenerationTool() const {return std::string(generationTool);}
+    bool getHasEventMode() const {return hasEventMode;}
 
   private:
     void updateFMI2Info(fmiHandle *fmi4c);
     void updateFMI3Info(fmiHandle *fmi4c);
 
+    bool hasEventMode = false; ///< FMI 3.0 co-simulation only
+
     // methods to copy the object
     FMUInfo(const FMUInfo& rhs);            ///< not implemented
     FMUInfo& operator=(const FMUInfo& rhs); ///< not implemented
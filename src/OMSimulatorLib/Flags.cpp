@@ -309,6 +309,8 @@ oms_alg_solver_enu_t oms::Flags::AlgLoopSolver()
     return oms_alg_solver_fixedpoint;
   else if (GetInstance().FlagAlgLoopSolver.value == "kinsol")
     return oms_alg_solver_kinsol;
+  else if (GetInstance().FlagAlgLoopSolver.value == "anderson")
+    return oms_alg_solver_anderson;
 
   assert(false && "Invalid algebraic loop solver");
   return oms_alg_solver_kinsol;  // unreachable; to avoid compiler warning
@@ -329,6 +331,8 @@ oms_solver_enu_t oms::Flags::Solver()
     return oms_solver_sc_explicit_euler;
   else if (GetInstance().FlagSolver.value == "cvode")
     return oms_solver_sc_cvode;
+  else if (GetInstance().FlagSolver.value == "dopri5")
+    return oms_solver_sc_dopri5;
 
   assert(false && "Invalid solver");
   return oms_solver_sc_explicit_euler;  // unreachable; to avoid compiler warning
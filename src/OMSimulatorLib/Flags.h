@@ -57,15 +57,20 @@ namespace oms
     static oms_status_enu_t SetCommandLineOption(const std::string &cmd);
 
     static bool AddParametersToCSV() { return GetInstance().FlagAddParametersToCSV.value == "true"; }
+    static bool AlgLoopJacobianReuse() { return GetInstance().FlagAlgLoopJacobianReuse.value == "true"; }
+    static bool AlgLoopTearing() { return GetInstance().FlagAlgLoopTearing.value == "true"; }
+    static bool CoupledRHS() { return GetInstance().FlagCoupledRHS.value == "true"; }
     static bool DefaultModeIsCS() { return GetInstance().FlagMode.value == "cs"; }
     static bool DeleteTempFiles() { return GetInstance().FlagDeleteTempFiles.value == "true"; }
     static bool DirectionalDerivatives() { return GetInstance().FlagDirectionalDerivatives.value == "true"; }
     static bool DumpAlgLoops() { return GetInstance().FlagDumpAlgLoops.value == "true"; }
+    static bool EarlyReturn() { return GetInstance().FlagEarlyReturn.value == "true"; }
     static bool EmitEvents() { return GetInstance().FlagEmitEvents.value == "true"; }
     static bool IgnoreInitialUnknowns() { return GetInstance().FlagIgnoreInitialUnknowns.value == "true"; }
     static bool InputExtrapolation() { return GetInstance().FlagInputExtrapolation.value == "true"; }
     static bool ProgressBar() { return GetInstance().FlagProgressBar.value == "true"; }
     static bool RealTime() { return GetInstance().FlagRealTime.value == "true"; }
+    static bool SelectiveRollback() { return GetInstance().FlagSelectiveRollback.value == "true"; }
     static bool SkipCSVHeader() { return GetInstance().FlagSkipCSVHeader.value == "true"; }
     static bool SolverStats() { return GetInstance().FlagSolverStats.value == "true"; }
     static bool StripRoot() { return GetInstance().FlagStripRoot.value == "true"; }
@@ -86,7 +91,10 @@ namespace oms
     static oms_alg_solver_enu_t AlgLoopSolver();
     static oms_solver_enu_t MasterAlgorithm();
     static oms_solver_enu_t Solver();
+    static std::string CVODELinearSolver() { return GetInstance().FlagCVODELinearSolver.value; }
     static std::string ResultFile() { return GetInstance().FlagResultFile.value; }
+    static unsigned int AlgLoopExtrapolation() { return atoi(GetInstance().FlagAlgLoopExtrapolation.value.c_str()); }
+    static unsigned int AndersonDepth() { return atoi(GetInstance().FlagAndersonDepth.value.c_str()); }
     static unsigned int Intervals() { return atoi(GetInstance().FlagIntervals.value.c_str()); }
     static unsigned int MaxEventIteration() { return atoi(GetInstance().FlagMaxEventIteration.value.c_str()); }
     static unsigned int MaxLoopIteration() { return atoi(GetInstance().FlagMaxLoopIteration.value.c_str()); }
@@ -103,7 +111,9 @@ namespace oms
     const std::string re_double = "((\\+|-)?[[:digit:]]+)(\\.(([[:digit:]]+)?))?((e|E)((\\+|-)?)[[:digit:]]+)?";
     const std::string re_number = "[[:digit:]]+";
     const std::string re_filename = ".+(\\.fmu|\\.ssp|\\.lua)";
-    const std::string re_solver = "(euler|cvode)";
+    const std::string re_solver = "(euler|cvode|dopri5)";
+    const std::string re_linear_solver = "(dense|sparse|blockdiagonal)";
+    const std::string re_extrapolation = "(0|1|2)";
 
   public:
     struct Flag
@@ -122,15 +132,22 @@ namespace oms
 
     Flag FlagFilename{"", "", "", "", "FMU or SSP file to be loaded", re_filename, Flags::Filename, false, false, false};
     Flag FlagAddParametersToCSV{"--addParametersToCSV", "", "", "false", "Export parameters to a .csv file", re_bool, nullptr, false, false, false};
-    Flag FlagAlgLoopSolver{"--algLoopSolver", "", "", "kinsol", "Specifies the loop solver method (fixedpoint, kinsol) used for algebraic loops spanning multiple components.", re_default, nullptr, false, false, false};
+    Flag FlagAlgLoopExtrapolation{"--algLoopExtrapolation", "", "", "0", "Specifies the order (0, 1, 2) of the extrapolation in time of previous solutions of algebraic loops, used as initial guess for the next solve; 0 starts from the current values", re_extrapolation, nullptr, false, false, false};
+    Flag FlagAlgLoopJacobianReuse{"--algLoopJacobianReuse", "", "", "false", "Reuse the Jacobian of algebraic loops solved with KINSOL in the following solves until the convergence degrades (modified Newton)", re_bool, nullptr, false, false, false};
+    Flag FlagAlgLoopSolver{"--algLoopSolver", "", "", "kinsol", "Specifies the loop solver method (fixedpoint, anderson, kinsol) used for algebraic loops spanning multiple components.", re_default, nullptr, false, false, false};
+    Flag FlagAlgLoopTearing{"--algLoopTearing", "", "", "false", "Reduce algebraic loops to a small set of iteration variables using the direct feedthrough information of the components; the remaining connections are evaluated in sequence", re_bool, nullptr, false, false, false};
+    Flag FlagAndersonDepth{"--andersonDepth", "", "", "5", "Specifies the number of previous iterates used by the Anderson-accelerated fixed-point iteration for algebraic loops (0 disables the acceleration)", re_number, nullptr, false, false, false};
     Flag FlagClearAllOptions{"--clearAllOptions", "", "", "", "Reset all flags to their default values", re_void, Flags::ClearAllOptions, false, false, false};
+    Flag FlagCoupledRHS{"--coupledRHS", "", "", "false", "Propagate the outputs to the connected inputs in each right-hand side evaluation of strongly coupled systems (including algebraic loops) instead of once per step", re_bool, nullptr, false, false, false};
+    Flag FlagCVODELinearSolver{"--CVODELinearSolver", "", "", "dense", "Specify the linear solver used by CVODE (dense, sparse, blockdiagonal); sparse and blockdiagonal use the sparsity pattern from the model structure of the FMUs", re_linear_solver, nullptr, false, false, false};
     Flag FlagCVODEMaxErrTestFails{"--CVODEMaxErrTestFails", "", "", "100", "Maximum number of error test failures for CVODE", re_number, nullptr, false, false, false};
     Flag FlagCVODEMaxNLSFailures{"--CVODEMaxNLSFailures", "", "", "100", "Maximum number of nonlinear convergence failures for CVODE", re_number, nullptr, false, false, false};
     Flag FlagCVODEMaxNLSIterations{"--CVODEMaxNLSIterations", "", "", "5", "Maximum number of nonlinear solver iterations for CVODE", re_number, nullptr, false, false, false};
     Flag FlagCVODEMaxSteps{"--CVODEMaxSteps", "", "", "1000", "Maximum number of steps for CVODE", re_number, nullptr, false, false, false};
     Flag FlagDeleteTempFiles{"--deleteTempFiles", "", "", "true", "Delete temporary files as soon as they are no longer needed", re_bool, nullptr, false, false, false};
-    Flag FlagDirectionalDerivatives{"--directionalDerivatives", "", "", "true", "Use directional derivatives to calculate the Jacobian for algebraic loops", re_bool, nullptr, false, false, false};
+    Flag FlagDirectionalDerivatives{"--directionalDerivatives", "", "", "true", "Use directional derivatives to calculate the Jacobian for algebraic loops and for the sparse CVODE linear solvers", re_bool, nullptr, false, false, false};
     Flag FlagDumpAlgLoops{"--dumpAlgLoops", "", "", "false", "Dump information for algebraic loops", re_bool, nullptr, false, false, false};
+    Flag FlagEarlyReturn{"--earlyReturn", "", "", "false", "Use the event mode of FMI 3.0 co-simulation FMUs and let them return early from a step at internal events; the master algorithm ma shortens the communication step to the earliest event", re_bool, nullptr, false, false, false};
     Flag FlagEmitEvents{"--emitEvents", "", "", "true", "Emit events during simulation", re_bool, nullptr, false, false, false};
     Flag FlagHelp{"--help", "-h", "", "", "Display the help text", re_void, Flags::Help, true, false, false};
     Flag FlagIgnoreInitialUnknowns{"--ignoreInitialUnknowns", "", "", "false", "Ignore initial unknowns from the modelDescription.xml", re_bool, nullptr, false, false, false};
@@ -148,8 +165,9 @@ namespace oms
     Flag FlagProgressBar{"--progressBar", "", "", "false", "Show a progress bar for the simulation progress in the terminal", re_bool, nullptr, false, false, false};
     Flag FlagRealTime{"--realTime", "", "", "false", "Enable experimental feature for (soft) real-time co-simulation", re_bool, nullptr, false, false, false};
     Flag FlagResultFile{"--resultFile", "-r", "", "<default>", "Specify the name of the output result file", re_default, nullptr, false, false, false};
+    Flag FlagSelectiveRollback{"--selectiveRollback", "", "", "false", "Roll back only the FMUs that are coupled to a signal with a rejected error estimate (solver mav); decoupled FMUs keep their progress, and no results are written until the other FMUs catch up", re_bool, nullptr, false, false, false};
     Flag FlagSkipCSVHeader{"--skipCSVHeader", "", "", "true", "Skip exporting the CSV delimiter in the header", re_bool, nullptr, false, false, false};
-    Flag FlagSolver{"--solver", "", "", "cvode", "Specify the integration method (euler, cvode)", re_solver, nullptr, false, false, false};
+    Flag FlagSolver{"--solver", "", "", "cvode", "Specify the integration method (euler, cvode, dopri5)", re_solver, nullptr, false, false, false};
     Flag FlagSolverStats{"--solverStats", "", "", "false", "Add solver stats to the result file, e.g., step size; not supported for all solvers", re_bool, nullptr, false, false, false};
     Flag FlagStartTime{"--startTime", "-s", "", "0", "Specify the start time", re_double, nullptr, false, false, false};
     Flag FlagStepSize{"--stepSize", "", "", "1e-3", "Specify the (maximum) step size", re_double, nullptr, false, false, false};
@@ -165,11 +183,17 @@ namespace oms
     Flag FlagZeroNominal{"--zeroNominal", "", "", "false", "Accept FMUs with invalid nominal values and replace the invalid nominal values with 1.0", re_bool, nullptr, false, false, false};
 
   private:
-    std::array<Flag *, 43> flags = {
+    std::array<Flag *, 51> flags = {
         &FlagFilename,
         &FlagAddParametersToCSV,
+        &FlagAlgLoopExtrapolation,
+        &FlagAlgLoopJacobianReuse,
         &FlagAlgLoopSolver,
+        &FlagAlgLoopTearing,
+        &FlagAndersonDepth,
         &FlagClearAllOptions,
+        &FlagCoupledRHS,
+        &FlagCVODELinearSolver,
         &FlagCVODEMaxErrTestFails,
         &FlagCVODEMaxNLSFailures,
         &FlagCVODEMaxNLSIterations,
@@ -177,6 +201,7 @@ namespace oms
         &FlagDeleteTempFiles,
         &FlagDirectionalDerivatives,
         &FlagDumpAlgLoops,
+        &FlagEarlyReturn,
         &FlagEmitEvents,
         &FlagHelp,
         &FlagIgnoreInitialUnknowns,
@@ -194,6 +219,7 @@ namespace oms
         &FlagProgressBar,
         &FlagRealTime,
         &FlagResultFile,
+        &FlagSelectiveRollback,
         &FlagSkipCSVHeader,
         &FlagSolver,
         &FlagSolverStats,
@@ -0,0 +1,362 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "LinearSolver.h"
+
+#include <sundials/sundials_dense.h>
+#include <sunlinsol/sunlinsol_band.h>
+#include <sunmatrix/sunmatrix_band.h>
+#include <sunmatrix/sunmatrix_dense.h>
+#include <sunmatrix/sunmatrix_sparse.h>
+
+#include <future>
+#include <vector>
+
+namespace
+{
+  struct LinSolContent_SparseBand
+  {
+    std::vector<sunindextype> iperm; ///< iperm[i] is the position of variable i in the band matrix
+    SUNMatrix B;
+    SUNLinearSolver band;
+    N_Vector x;
+    N_Vector b;
+    sunindextype lastFlag;
+  };
+
+  LinSolContent_SparseBand* SparseBand_content(SUNLinearSolver S)
+  {
+    return (LinSolContent_SparseBand*)S->content;
+  }
+
+  SUNLinearSolver_Type SparseBand_gettype(SUNLinearSolver S)
+  {
+    return SUNLINEARSOLVER_DIRECT;
+  }
+
+  SUNLinearSolver_ID SparseBand_getid(SUNLinearSolver S)
+  {
+    return SUNLINEARSOLVER_CUSTOM;
+  }
+
+  int SparseBand_initialize(SUNLinearSolver S)
+  {
+    SparseBand_content(S)->lastFlag = SUNLinSolInitialize(SparseBand_content(S)->band);
+    return (int)SparseBand_content(S)->lastFlag;
+  }
+
+  int SparseBand_setup(SUNLinearSolver S, SUNMatrix A)
+  {
+    LinSolContent_SparseBand* c = SparseBand_content(S);
+    const sunindextype n = SM_COLUMNS_S(A);
+    const sunindextype* indexptrs = SM_INDEXPTRS_S(A);
+    const sunindextype* indexvals = SM_INDEXVALS_S(A);
+    const realtype* data = SM_DATA_S(A);
+
+    SUNMatZero(c->B);
+    for (sunindextype j = 0; j < n; ++j)
+      for (sunindextype k = indexptrs[j]; k < indexptrs[j + 1]; ++k)
+        SM_ELEMENT_B(c->B, c->iperm[indexvals[k]], c->iperm[j]) = data[k];
+
+    c->lastFlag = SUNLinSolSetup(c->band, c->B);
+    return (int)c->lastFlag;
+  }
+
+  int SparseBand_solve(SUNLinearSolver S, SUNMatrix A, N_Vector x, N_Vector b, realtype tol)
+  {
+    LinSolContent_SparseBand* c = SparseBand_content(S);
+    const sunindextype n = NV_LENGTH_S(b);
+
+    for (sunindextype i = 0; i < n; ++i)
+      NV_Ith_S(c->b, c->iperm[i]) = NV_Ith_S(b, i);
+
+    c->lastFlag = SUNLinSolSolve(c->band, c->B, c->x, c->b, tol);
+
+    for (sunindextype i = 0; i < n; ++i)
+      NV_Ith_S(x, i) = NV_Ith_S(c->x, c->iperm[i]);
+
+    return (int)c->lastFlag;
+  }
+
+  sunindextype SparseBand_lastflag(SUNLinearSolver S)
+  {
+    return SparseBand_content(S)->lastFlag;
+  }
+
+  int SparseBand_free(SUNLinearSolver S)
+  {
+    if (!S)
+      return SUNLS_SUCCESS;
+
+    LinSolContent_SparseBand* c = SparseBand_content(S);
+    if (c)
+    {
+      SUNLinSolFree(c->band);
+      SUNMatDestroy(c->B);
+      N_VDestroy_Serial(c->x);
+      N_VDestroy_Serial(c->b);
+      delete c;
+      S->content = NULL;
+    }
+
+    SUNLinSolFreeEmpty(S);
+    return SUNLS_SUCCESS;
+  }
+}
+
+namespace
+{
+  struct LinSolContent_BlockDiagonal
+  {
+    std::vector< std::vector<sunindextype> > blocks; ///< variables of each block
+    std::vector<sunindextype> positions;             ///< position of each variable in its block
+    std::vector<SUNMatrix> A;
+    std::vector< std::vector<sunindextype> > pivots;
+    std::vector< std::vector<realtype> > work;
+    ctpl::thread_pool* pool;
+    sunindextype lastFlag;
+  };
+
+  LinSolContent_BlockDiagonal* BlockDiagonal_content(SUNLinearSolver S)
+  {
+    return (LinSolContent_BlockDiagonal*)S->content;
+  }
+
+  SUNLinearSolver_Type BlockDiagonal_gettype(SUNLinearSolver S)
+  {
+    return SUNLINEARSOLVER_DIRECT;
+  }
+
+  SUNLinearSolver_ID BlockDiagonal_getid(SUNLinearSolver S)
+  {
+    return SUNLINEARSOLVER_CUSTOM;
+  }
+
+  int BlockDiagonal_initialize(SUNLinearSolver S)
+  {
+    BlockDiagonal_content(S)->lastFlag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+  }
+
+  /**
+   * Runs task(b) for all blocks, on the thread pool if available, and
+   * returns the first non-zero result.
+   */
+  template<typename Task>
+  sunindextype BlockDiagonal_forEachBlock(LinSolContent_BlockDiagonal* c, Task task)
+  {
+    sunindextype flag = 0;
+    if (c->pool && c->blocks.size() > 1)
+    {
+      std::vector< std::future<sunindextype> > results(c->blocks.size());
+      for (size_t b = 0; b < c->blocks.size(); ++b)
+        results[b] = c->pool->push([&task, b](int id) { return task(b); });
+      for (auto& r : results)
+      {
+        const sunindextype f = r.get();
+        if (0 == flag)
+          flag = f;
+      }
+    }
+    else
+    {
+      for (size_t b = 0; b < c->blocks.size() && 0 == flag; ++b)
+        flag = task(b);
+    }
+    return flag;
+  }
+
+  int BlockDiagonal_setup(SUNLinearSolver S, SUNMatrix A)
+  {
+    LinSolContent_BlockDiagonal* c = BlockDiagonal_content(S);
+    const sunindextype* indexptrs = SM_INDEXPTRS_S(A);
+    const sunindextype* indexvals = SM_INDEXVALS_S(A);
+    const realtype* data = SM_DATA_S(A);
+
+    auto factorize = [c, indexptrs, indexvals, data](size_t b) -> sunindextype
+    {
+      SUNMatZero(c->A[b]);
+      for (const sunindextype& j : c->blocks[b])
+        for (sunindextype k = indexptrs[j]; k < indexptrs[j + 1]; ++k)
+          SM_ELEMENT_D(c->A[b], c->positions[indexvals[k]], c->positions[j]) = data[k];
+
+      const sunindextype n = static_cast<sunindextype>(c->blocks[b].size());
+      return denseGETRF(SM_COLS_D(c->A[b]), n, n, c->pivots[b].data());
+    };
+
+    c->lastFlag = BlockDiagonal_forEachBlock(c, factorize);
+    return (c->lastFlag > 0) ? SUNLS_LUFACT_FAIL : SUNLS_SUCCESS;
+  }
+
+  int BlockDiagonal_solve(SUNLinearSolver S, SUNMatrix A, N_Vector x, N_Vector b, realtype tol)
+  {
+    LinSolContent_BlockDiagonal* c = BlockDiagonal_content(S);
+    realtype* x_data = NV_DATA_S(x);
+    const realtype* b_data = NV_DATA_S(b);
+
+    auto solve = [c, x_data, b_data](size_t k) -> sunindextype
+    {
+      const std::vector<sunindextype>& block = c->blocks[k];
+      std::vector<realtype>& work = c->work[k];
+      for (size_t i = 0; i < block.size(); ++i)
+        work[i] = b_data[block[i]];
+
+      denseGETRS(SM_COLS_D(c->A[k]), static_cast<sunindextype>(block.size()), c->pivots[k].data(), work.data());
+
+      for (size_t i = 0; i < block.size(); ++i)
+        x_data[block[i]] = work[i];
+      return 0;
+    };
+
+    BlockDiagonal_forEachBlock(c, solve);
+    c->lastFlag = SUNLS_SUCCESS;
+    return SUNLS_SUCCESS;
+  }
+
+  sunindextype BlockDiagonal_lastflag(SUNLinearSolver S)
+  {
+    return BlockDiagonal_content(S)->lastFlag;
+  }
+
+  int BlockDiagonal_free(SUNLinearSolver S)
+  {
+    if (!S)
+      return SUNLS_SUCCESS;
+
+    LinSolContent_BlockDiagonal* c = BlockDiagonal_content(S);
+    if (c)
+    {
+      for (auto& A : c->A)
+        SUNMatDestroy(A);
+      delete c;
+      S->content = NULL;
+    }
+
+    SUNLinSolFreeEmpty(S);
+    return SUNLS_SUCCESS;
+  }
+}
+
+SUNLinearSolver oms::LinSol_SparseBand(N_Vector y, const SparsityPattern& pattern)
+{
+  const sunindextype n = NV_LENGTH_S(y);
+  if (n != pattern.getSize())
+    return NULL;
+
+  std::vector<int> perm;
+  int mu, ml;
+  pattern.getReverseCuthillMcKee(perm);
+  pattern.getBandwidth(perm, mu, ml);
+
+  SUNLinearSolver S = SUNLinSolNewEmpty();
+  if (!S)
+    return NULL;
+
+  S->ops->gettype = SparseBand_gettype;
+  S->ops->getid = SparseBand_getid;
+  S->ops->initialize = SparseBand_initialize;
+  S->ops->setup = SparseBand_setup;
+  S->ops->solve = SparseBand_solve;
+  S->ops->lastflag = SparseBand_lastflag;
+  S->ops->free = SparseBand_free;
+
+  LinSolContent_SparseBand* c = new LinSolContent_SparseBand();
+  c->iperm.resize(n);
+  for (sunindextype k = 0; k < n; ++k)
+    c->iperm[perm[k]] = k;
+  c->B = SUNBandMatrix(n, mu, ml);
+  c->x = N_VNew_Serial(n);
+  c->b = N_VNew_Serial(n);
+  c->band = (c->B && c->x && c->b) ? SUNLinSol_Band(c->x, c->B) : NULL;
+  c->lastFlag = 0;
+  S->content = c;
+
+  if (!c->band)
+  {
+    SUNLinSolFree(S);
+    return NULL;
+  }
+
+  return S;
+}
+
+SUNLinearSolver oms::LinSol_BlockDiagonal(N_Vector y, const SparsityPattern& pattern, ctpl::thread_pool* pool)
+{
+  const sunindextype n = NV_LENGTH_S(y);
+  if (n != pattern.getSize())
+    return NULL;
+
+  std::vector<int> blocks;
+  const int nBlocks = pattern.getBlocks(blocks);
+
+  SUNLinearSolver S = SUNLinSolNewEmpty();
+  if (!S)
+    return NULL;
+
+  S->ops->gettype = BlockDiagonal_gettype;
+  S->ops->getid = BlockDiagonal_getid;
+  S->ops->initialize = BlockDiagonal_initialize;
+  S->ops->setup = BlockDiagonal_setup;
+  S->ops->solve = BlockDiagonal_solve;
+  S->ops->lastflag = BlockDiagonal_lastflag;
+  S->ops->free = BlockDiagonal_free;
+
+  LinSolContent_BlockDiagonal* c = new LinSolContent_BlockDiagonal();
+  c->blocks.resize(nBlocks);
+  c->positions.resize(n);
+  for (sunindextype i = 0; i < n; ++i)
+  {
+    c->positions[i] = static_cast<sunindextype>(c->blocks[blocks[i]].size());
+    c->blocks[blocks[i]].push_back(i);
+  }
+
+  c->A.resize(nBlocks, NULL);
+  c->pivots.resize(nBlocks);
+  c->work.resize(nBlocks);
+  c->pool = pool;
+  c->lastFlag = 0;
+  S->content = c;
+
+  for (int b = 0; b < nBlocks; ++b)
+  {
+    const sunindextype size = static_cast<sunindextype>(c->blocks[b].size());
+    c->A[b] = SUNDenseMatrix(size, size);
+    c->pivots[b].resize(size);
+    c->work[b].resize(size);
+    if (!c->A[b])
+    {
+      SUNLinSolFree(S);
+      return NULL;
+    }
+  }
+
+  return S;
+}
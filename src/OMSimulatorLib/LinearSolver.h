@@ -0,0 +1,64 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef _OMS_LINEAR_SOLVER_H_
+#define _OMS_LINEAR_SOLVER_H_
+
+#include "SparsityPattern.h"
+
+#include <ctpl_stl.h>
+#include <nvector/nvector_serial.h>
+#include <sundials/sundials_linearsolver.h>
+#include <sundials/sundials_matrix.h>
+
+namespace oms
+{
+  /**
+   * @brief Direct solver for sparse CVODE iteration matrices.
+   *
+   * The CSC matrix passed to setup() must have the structure of the given
+   * pattern. It is copied into a band matrix using a reverse Cuthill-McKee
+   * ordering of the pattern and factorized with the SUNDIALS band solver, so
+   * that the cost scales with n*mu*ml instead of n^3.
+   */
+  SUNLinearSolver LinSol_SparseBand(N_Vector y, const SparsityPattern& pattern);
+
+  /**
+   * @brief Direct solver for block-diagonal CVODE iteration matrices.
+   *
+   * The independent blocks of the pattern, e.g. FMUs without state coupling,
+   * are factorized separately with a dense LU decomposition. If a thread pool
+   * is given, the blocks are factorized and solved in parallel.
+   */
+  SUNLinearSolver LinSol_BlockDiagonal(N_Vector y, const SparsityPattern& pattern, ctpl::thread_pool* pool);
+}
+
+#endif
@@ -33,6 +33,7 @@
 
 #include "Logging.h"
 #include "MatVer4.h"
+#include "OMSFileSystem.h"
 #include "ResultWriter.h"
 #include "Util.h"
 
@@ -198,6 +199,66 @@ bool oms::MATWriter::createFile(const std::string& filename, double startTime, d
   return true;
 }
 
+/**
+ * @brief Reopens a result file created by createFile() and shrinks data_2
+ * to the time points before the given position.
+ */
+bool oms::MATWriter::resumeFile(const std::string& filename, long position)
+{
+  if (pFile)
+  {
+    logError("MATWriter::resumeFile: File is already open");
+    return false;
+  }
+
+  std::error_code ec;
+  filesystem::resize_file(filename, position, ec);
+  if (ec)
+  {
+    logError("MATWriter::resumeFile: " + ec.message());
+    return false;
+  }
+
+#if defined(_MSC_VER) || defined(__MINGW32__) || defined(__MINGW64__)
+  pFile = _fsopen(filename.c_str(), "rb+", _SH_DENYWR);
+#else
+  pFile = fopen(filename.c_str(), "rb+");
+#endif
+
+  if (!pFile)
+  {
+    logError("MATWriter::resumeFile: " + std::string(strerror(errno)));
+    return false;
+  }
+
+  // skip Aclass, name, description, dataInfo and data_1
+  for (int i = 0; i < 5; ++i)
+    skipMatVer4Matrix(pFile);
+  pos_data_2 = ftell(pFile);
+
+  MatVer4Header header;
+  if (fread(&header, sizeof(MatVer4Header), 1, pFile) != 1 || header.mrows != 1 + signals.size())
+  {
+    logError("MATWriter::resumeFile: " + filename + " doesn't match the registered signals");
+    fclose(pFile);
+    pFile = NULL;
+    return false;
+  }
+
+  const long pos_data = pos_data_2 + (long) sizeof(MatVer4Header) + header.namelen;
+  header.ncols = (unsigned int) ((position - pos_data) / (header.mrows * sizeof(double)));
+
+  fseek(pFile, pos_data_2, SEEK_SET);
+  fwrite(&header, sizeof(MatVer4Header), 1, pFile);
+  fseek(pFile, 0, SEEK_END);
+  return true;
+}
+
+long oms::MATWriter::tellFile()
+{
+  return pFile ? ftell(pFile) : 0;
+}
+
 void oms::MATWriter::closeFile()
 {
   if (pFile)
@@ -50,6 +50,8 @@ namespace oms
     bool createFile(const std::string& filename, double startTime, double stopTime);
     void closeFile();
     void writeFile();
+    long tellFile();
+    bool resumeFile(const std::string& filename, long position);
 
   private:
     FILE *pFile;
@@ -66,7 +66,7 @@ oms::Model::~Model()
     free(variant.second);
 
   // delete temp directory
-  if (Flags::DeleteTempFiles())
+  if (Flags::DeleteTempFiles() && ownsTempDir)
   {
     if (!tempDir.empty() && filesystem::is_directory(tempDir))
     {
@@ -117,6 +117,94 @@ oms::Model* oms::Model::NewModel(const oms::ComRef& cref)
   return model;
 }
 
+/**
+ * @brief Returns an FMU of the system or its subsystems that can't be
+ * instantiated twice in a process, or NULL.
+ */
+static oms::Component* findSingleInstanceFMU(oms::System* system)
+{
+  for (const auto& component : system->getComponents())
+    if (component.second->getFMUInfo() && component.second->getFMUInfo()->getCanBeInstantiatedOnlyOncePerProcess())
+      return component.second;
+
+  for (const auto& subsystem : system->getSubSystems())
+    if (oms::Component* component = findSingleInstanceFMU(subsystem.second))
+      return component;
+
+  return NULL;
+}
+
+/**
+ * @brief Creates a copy of a model that shares the temp directory, i.e. the
+ * resources and unpacked FMUs, of the original model.
+ *
+ * The systems are rebuilt from an in-memory snapshot and only new FMU
+ * instances are loaded; nothing is read from the SSP file or unpacked again.
+ * The components take over the parsed modelDescription.xml of the original
+ * components and the systems take over the dependency graphs of the original
+ * systems, if these are up to date. The clone starts in the virgin state with
+ * the current start values of the original model.
+ */
+oms::Model* oms::Model::CloneModel(const oms::ComRef& cref, oms::Model& original)
+{
+  if (!cref.isValidIdent())
+  {
+    logError_InvalidIdent(cref);
+    return NULL;
+  }
+
+  // the clone loads the same binaries, i.e. the same module image
+  Component* singleInstanceFMU = original.system ? findSingleInstanceFMU(original.system) : NULL;
+  if (singleInstanceFMU)
+  {
+    logError("Model \"" + std::string(original.getCref()) + "\" can't be cloned, since FMU \"" + std::string(singleInstanceFMU->getFullCref()) + "\" can only be instantiated once per process (canBeInstantiatedOnlyOncePerProcess = true in modelDescription.xml)");
+    return NULL;
+  }
+
+  Snapshot snapshot;
+  if (oms_status_ok != original.exportToSSD(snapshot))
+  {
+    logError("Cloning model \"" + std::string(original.getCref()) + "\" failed");
+    return NULL;
+  }
+  original.exportSignalFilter(snapshot);
+
+  oms::Model* model = new oms::Model(cref, original.tempDir);
+  model->ownsTempDir = false;
+  model->variantName = original.variantName;
+  model->signalFilterFilename = original.signalFilterFilename;
+  model->importedResources = original.importedResources;
+
+  // the components of the clone take over the unpacked fmus and the parsed
+  // modelDescription.xml of the original components, see Component::getCloneSource()
+  model->cloneSource = &original;
+  model->copyResources(false);
+  oms_status_enu_t status = model->importFromSnapshot(snapshot);
+  model->copyResources(original.copy_resources);
+  model->cloneSource = NULL;
+
+  if (oms_status_ok != status)
+  {
+    delete model;
+    logError("Cloning model \"" + std::string(original.getCref()) + "\" failed");
+    return NULL;
+  }
+
+  if (model->system && original.system)
+    model->system->copyDependencyGraphs(*original.system);
+
+  // the snapshot rounds these values
+  model->startTime = original.startTime;
+  model->stopTime = original.stopTime;
+  model->loggingInterval = original.loggingInterval;
+
+  // don't overwrite the result file of the original model
+  if (!model->resultFilename.empty())
+    model->resultFilename = std::string(cref) + "_res" + filesystem::path(original.resultFilename).extension().string();
+
+  return model;
+}
+
 oms_status_enu_t oms::Model::rename(const oms::ComRef& cref)
 {
   if (!cref.isValidIdent())
@@ -1188,6 +1276,27 @@ oms_status_enu_t oms::Model::instantiate()
 }
 
 oms_status_enu_t oms::Model::initialize()
+{
+  return initializeHelper(NULL);
+}
+
+/**
+ * @brief Initializes the model and continues from a checkpoint written by saveCheckpoint().
+ *
+ * The result file of the checkpoint is continued if it is still the result
+ * file of the model; otherwise a new result file is created that starts at
+ * the time of the checkpoint.
+ */
+oms_status_enu_t oms::Model::initializeFromCheckpoint(const std::string& filename)
+{
+  Checkpoint checkpoint;
+  if (oms_status_ok != checkpoint.load(filename))
+    return oms_status_error;
+
+  return initializeHelper(&checkpoint);
+}
+
+oms_status_enu_t oms::Model::initializeHelper(Checkpoint* checkpoint)
 {
   if (!validState(oms_modelState_instantiated))
     return logError_ModelInWrongState(getCref());
@@ -1226,6 +1335,34 @@ oms_status_enu_t oms::Model::initialize()
     return logError_Initialization(system->getFullCref());
   }
 
+  std::string checkpointResultFile;
+  int64_t checkpointResultPosition = 0;
+  if (checkpoint)
+  {
+    std::string name;
+    if (!checkpoint->readString(name) || name != std::string(getCref()) ||
+        !checkpoint->readValue(lastEmit) ||
+        !checkpoint->readString(checkpointResultFile) ||
+        !checkpoint->readValue(checkpointResultPosition))
+    {
+      logError("Checkpoint doesn't match model " + std::string(getCref()));
+      terminate();
+      clock.toc();
+      return logError_Initialization(system->getFullCref());
+    }
+
+    if (oms_status_ok != system->deserializeState(*checkpoint))
+    {
+      terminate();
+      clock.toc();
+      return logError_Initialization(system->getFullCref());
+    }
+
+    // getTime() returns the start time until the model is in simulation mode
+    logInfo("Resumed from checkpoint at time " + std::to_string(system->getTime()));
+  }
+  lastCheckpoint = system->getTime();
+
   if (resultFile)
   {
     logInfo("Result file: " + resultFilename + " (bufferSize=" + std::to_string(bufferSize) + ")");
@@ -1238,8 +1375,9 @@ oms_status_enu_t oms::Model::initialize()
       return logError_Initialization(system->getFullCref());
     }
 
-    // create result file
-    if (!resultFile->create(resultFilename, startTime, stopTime))
+    // create result file or continue the one of the checkpoint
+    const bool resume = checkpoint && checkpointResultFile == resultFilename && checkpointResultPosition > 0;
+    if (resume ? !resultFile->resume(resultFilename, (long)checkpointResultPosition) : !resultFile->create(resultFilename, startTime, stopTime))
     {
       delete resultFile;
       resultFile = NULL;
@@ -1250,7 +1388,11 @@ oms_status_enu_t oms::Model::initialize()
     }
 
     // dump results
-    emit(startTime, true);
+    if (!resume)
+    {
+      lastEmit = startTime - 1.0;
+      emit(getTime(), true);
+    }
   }
   else
     logInfo("No result file will be created");
@@ -1422,6 +1564,62 @@ oms_status_enu_t oms::Model::emit(double time, bool force, bool* emitted)
   return oms_status_ok;
 }
 
+/**
+ * @brief Writes a checkpoint every interval seconds of simulation time, see checkpoint().
+ */
+oms_status_enu_t oms::Model::setCheckpointFile(const std::string& filename, double interval)
+{
+  if (interval < 0.0)
+    return logError("Invalid checkpoint interval: " + std::to_string(interval));
+
+  checkpointFilename = filename;
+  checkpointInterval = interval;
+  return oms_status_ok;
+}
+
+/**
+ * @brief Writes the states of all components, the master algorithms and the
+ * position of the result file, so that the simulation can be continued with
+ * initializeFromCheckpoint().
+ */
+oms_status_enu_t oms::Model::saveCheckpoint(const std::string& filename)
+{
+  if (!validState(oms_modelState_simulation))
+    return logError_ModelInWrongState(getCref());
+
+  if (!system)
+    return logError("Model doesn't contain a system");
+
+  Checkpoint checkpoint;
+  checkpoint.writeString(std::string(getCref()));
+  checkpoint.writeValue(lastEmit);
+  checkpoint.writeString(resultFile ? resultFilename : "");
+  checkpoint.writeValue<int64_t>(resultFile ? resultFile->flush() : 0);
+
+  if (oms_status_ok != system->serializeState(checkpoint))
+    return logError("Creating checkpoint \"" + filename + "\" failed");
+
+  if (oms_status_ok != checkpoint.save(filename))
+    return oms_status_error;
+
+  logDebug("Checkpoint at time " + std::to_string(getTime()) + " written to \"" + filename + "\"");
+  return oms_status_ok;
+}
+
+/**
+ * @brief Periodic checkpoint, called by the top level system after each step.
+ */
+oms_status_enu_t oms::Model::checkpoint(double time)
+{
+  if (checkpointFilename.empty() || checkpointInterval <= 0.0)
+    return oms_status_ok;
+  if (time < lastCheckpoint + checkpointInterval)
+    return oms_status_ok;
+
+  lastCheckpoint = time;
+  return saveCheckpoint(checkpointFilename);
+}
+
 oms_status_enu_t oms::Model::setResultFile(const std::string& filename, int bufferSize)
 {
   this->resultFilename = filename;
@@ -32,6 +32,7 @@
 #ifndef _OMS_MODEL_H_
 #define _OMS_MODEL_H_
 
+#include "Checkpoint.h"
 #include "Clock.h"
 #include "ComRef.h"
 #include "Element.h"
@@ -59,6 +60,7 @@ namespace oms
      * instances with valid names can be created.
      */
     static Model* NewModel(const ComRef& cref);
+    static Model* CloneModel(const ComRef& cref, Model& original);
 
     const ComRef& getCref() const {return cref;}
     System* getSystem(const ComRef& cref);
@@ -66,6 +68,8 @@ namespace oms
     Component* getComponent(const ComRef& cref);
     System* getTopLevelSystem() const {return system;}
     std::string getTempDirectory() const {return tempDir;}
+    bool ownsTempDirectory() const {return ownsTempDir;}
+    Model* getCloneSource() const {return cloneSource;}
     oms_status_enu_t rename(const ComRef& cref);
     oms_status_enu_t rename(const ComRef& cref, const ComRef& newCref);
     oms_status_enu_t list(const ComRef& cref, char** contents);
@@ -101,6 +105,7 @@ namespace oms
 
     oms_status_enu_t instantiate();
     oms_status_enu_t initialize();
+    oms_status_enu_t initializeFromCheckpoint(const std::string& filename);
     oms_status_enu_t simulate();
     oms_status_enu_t doStep();
     oms_status_enu_t stepUntil(double stopTime);
@@ -119,7 +124,11 @@ namespace oms
     double getLoggingInterval() const {return loggingInterval;}
     oms_status_enu_t setResultFile(const std::string& filename, int bufferSize);
     oms_status_enu_t getResultFile(char** filename, int* bufferSize);
+    bool hasResultFile() const {return resultFile != NULL;}
     oms_status_enu_t emit(double time, bool force=false, bool* emitted=NULL);
+    oms_status_enu_t setCheckpointFile(const std::string& filename, double interval);
+    oms_status_enu_t saveCheckpoint(const std::string& filename);
+    oms_status_enu_t checkpoint(double time);
     oms_status_enu_t addSignalsToResults(const char* regex);
     oms_status_enu_t removeSignalsFromResults(const char* regex);
     std::string escapeSpecialCharacters(const std::string& regex);
@@ -148,11 +157,14 @@ namespace oms
     Model& operator=(Model const& copy); ///< not implemented
 
     oms_status_enu_t registerSignalsForResultFile();
+    oms_status_enu_t initializeHelper(Checkpoint* checkpoint);
 
   private: // attributes
     ComRef cref;
     System* system = NULL;
     std::string tempDir;
+    bool ownsTempDir = true; ///< false for clones, which share the temp directory of the original model
+    Model* cloneSource = NULL; ///< model that is being cloned into this one, only set while the clone is imported
 
     std::vector<oms::Element*> elements;
     bool copy_resources = true;
@@ -172,6 +184,10 @@ namespace oms
     Values values;
 
     std::string resultFilename; ///< default <name>_res.mat
+
+    std::string checkpointFilename; ///< no periodic checkpoints if empty
+    double checkpointInterval = 0.0;
+    double lastCheckpoint = 0.0;
     std::string signalFilterFilename = "resources/signalFilter.xml";
 
     std::string variantName = "SystemStructure.ssd";  ///< default name
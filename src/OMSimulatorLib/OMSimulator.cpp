@@ -117,6 +117,11 @@ oms_status_enu_t oms_newModel(const char* cref)
   return oms_status_ok;
 }
 
+oms_status_enu_t oms_cloneModel(const char* cref, const char* newCref)
+{
+  return oms::Scope::GetInstance().cloneModel(oms::ComRef(cref), oms::ComRef(newCref));
+}
+
 oms_status_enu_t oms_rename(const char* cref_, const char* newCref_)
 {
   oms::ComRef cref(cref_);
@@ -871,6 +876,28 @@ oms_status_enu_t oms_initialize(const char* cref_)
   return model->initialize();
 }
 
+oms_status_enu_t oms_initializeFromCheckpoint(const char* cref_, const char* filename)
+{
+  oms::ComRef cref(cref_);
+
+  oms::Model* model = oms::Scope::GetInstance().getModel(cref);
+  if (!model)
+    return logError_ModelNotInScope(cref);
+
+  return model->initializeFromCheckpoint(filename);
+}
+
+oms_status_enu_t oms_saveCheckpoint(const char* cref_, const char* filename)
+{
+  oms::ComRef cref(cref_);
+
+  oms::Model* model = oms::Scope::GetInstance().getModel(cref);
+  if (!model)
+    return logError_ModelNotInScope(cref);
+
+  return model->saveCheckpoint(filename);
+}
+
 oms_status_enu_t oms_simulate(const char* cref_)
 {
   oms::ComRef cref(cref_);
@@ -1452,6 +1479,22 @@ oms_status_enu_t oms_setResultFile(const char* cref_, const char* filename, int
     return logError_OnlyForModel;
 }
 
+oms_status_enu_t oms_setCheckpointFile(const char* cref_, const char* filename, double interval)
+{
+  oms::ComRef cref(cref_);
+
+  if (cref.isValidIdent())
+  {
+    oms::Model* model = oms::Scope::GetInstance().getModel(cref);
+    if (!model)
+      return logError_ModelNotInScope(cref);
+
+    return model->setCheckpointFile(filename, interval);
+  }
+  else
+    return logError_OnlyForModel;
+}
+
 oms_status_enu_t oms_addSignalsToResults(const char* cref, const char* regex)
 {
   oms::ComRef tail(cref);
@@ -1602,6 +1645,23 @@ oms_status_enu_t oms_getTime(const char* cref, double* time)
   return oms_status_ok;
 }
 
+oms_status_enu_t oms_setActivationRatio(const char* cref, int k)
+{
+  oms::ComRef tail(cref);
+  oms::ComRef front = tail.pop_front();
+
+  oms::Model* model = oms::Scope::GetInstance().getModel(front);
+  if (!model)
+    return logError_ModelNotInScope(front);
+
+  front = tail.pop_front();
+  oms::System* system = model->getSystem(front);
+  if (!system)
+    return logError_SystemNotInModel(model->getCref(), front);
+
+  return system->setActivationRatio(tail, k);
+}
+
 oms_status_enu_t oms_setFixedStepSize(const char* cref, double stepSize)
 {
   oms::ComRef tail(cref);
@@ -34,6 +34,8 @@
 #include "Model.h"
 #include "Scope.h"
 
+#include <cstring>
+
 oms::ResultWriter::ResultWriter(unsigned int bufferSize)
   : bufferSize(bufferSize),
     nEmits(0),
@@ -103,6 +105,20 @@ bool oms::ResultWriter::create(const std::string& filename, double startTime, do
   return true;
 }
 
+/**
+ * @brief Continues an existing result file after the given file position,
+ * see flush(). Everything behind that position is discarded.
+ */
+bool oms::ResultWriter::resume(const std::string& filename, long position)
+{
+  if (!resumeFile(filename, position))
+    return false;
+
+  data_2 = new double[bufferSize*(signals.size() + 1)];
+  nEmits = 0;
+  return true;
+}
+
 void oms::ResultWriter::close()
 {
   closeFile();
@@ -117,6 +133,24 @@ void oms::ResultWriter::close()
   parameters.clear();
 }
 
+/**
+ * @brief Writes all buffered results to the file.
+ *
+ * @return End position of the result file, used to resume it after a checkpoint
+ */
+long oms::ResultWriter::flush()
+{
+  if (!data_2)
+    return 0;
+
+  if (nEmits > 0)
+  {
+    writeFile();
+    nEmits = 0;
+  }
+  return tellFile();
+}
+
 void oms::ResultWriter::updateSignal(unsigned int id, SignalValue_t value)
 {
   if (!data_2)
@@ -136,6 +170,17 @@ void oms::ResultWriter::updateSignal(unsigned int id, SignalValue_t value)
   }
 }
 
+/**
+ * @brief Updates the real signals id, ..., id+size-1, e.g. the elements of an array variable.
+ */
+void oms::ResultWriter::updateSignals(unsigned int id, const double* values, size_t size)
+{
+  if (!data_2)
+    return;
+
+  memcpy(&data_2[nEmits*(signals.size() + 1) + id], values, size*sizeof(double));
+}
+
 void oms::ResultWriter::emit(double time)
 {
   if (!data_2)
@@ -75,9 +75,12 @@ namespace oms
     void addParameter(const ComRef& name, const std::string& description, SignalType_t type, SignalValue_t value);
 
     bool create(const std::string& filename, double startTime, double stopTime);
+    bool resume(const std::string& filename, long position);
     void close();
+    long flush();
 
     void updateSignal(unsigned int id, SignalValue_t value);
+    void updateSignals(unsigned int id, const double* values, size_t size);
     void emit(double time);
 
   private:
@@ -89,6 +92,8 @@ namespace oms
     virtual bool createFile(const std::string& filename, double startTime, double stopTime) = 0;
     virtual void closeFile() = 0;
     virtual void writeFile() = 0;
+    virtual long tellFile() = 0;
+    virtual bool resumeFile(const std::string& filename, long position) = 0;
 
     std::vector<Signal> signals;
     std::vector<Parameter> parameters;
@@ -109,6 +114,8 @@ namespace oms
     bool createFile(const std::string& filename, double startTime, double stopTime) {return true;}
     void closeFile() {}
     void writeFile() {}
+    long tellFile() {return 0;}
+    bool resumeFile(const std::string& filename, long position) {return true;}
   };
 }
 
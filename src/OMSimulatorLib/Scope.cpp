@@ -54,7 +54,14 @@ oms::Scope::Scope()
 
 oms::Scope::~Scope()
 {
-  // free memory if no one else does
+  // free memory if no one else does; clones first, since they use the temp
+  // directory of the original model
+  for (auto& model : models)
+    if (model && !model->ownsTempDirectory())
+    {
+      delete model;
+      model = NULL;
+    }
   for (const auto& model : models)
     if (model)
       delete model;
@@ -92,6 +99,12 @@ oms_status_enu_t oms::Scope::deleteModel(const oms::ComRef& cref)
   auto it = models_map.find(cref);
   if (it == models_map.end())
     return logError("Model \"" + std::string(cref) + "\" does not exist in the scope");
+
+  // clones use the temp directory of the original model
+  if (models[it->second]->ownsTempDirectory())
+    for (const auto& model : models)
+      if (model && model != models[it->second] && model->getTempDirectory() == models[it->second]->getTempDirectory())
+        return logError("Model \"" + std::string(cref) + "\" can't be deleted before its clone \"" + std::string(model->getCref()) + "\"");
   delete models[it->second];
 
   models.pop_back();
@@ -106,6 +119,26 @@ oms_status_enu_t oms::Scope::deleteModel(const oms::ComRef& cref)
   return oms_status_ok;
 }
 
+oms_status_enu_t oms::Scope::cloneModel(const oms::ComRef& cref, const oms::ComRef& newCref)
+{
+  Model* original = getModel(cref);
+  if (!original)
+    return logError_ModelNotInScope(cref);
+
+  if (getModel(newCref))
+    return logError_AlreadyInScope(newCref);
+
+  Model* model = oms::Model::CloneModel(newCref, *original);
+  if (!model)
+    return oms_status_error;
+
+  models.back() = model;
+  models_map[newCref] = models.size() - 1;
+  models.push_back(NULL);
+
+  return oms_status_ok;
+}
+
 oms_status_enu_t oms::Scope::renameModel(const oms::ComRef& cref, const oms::ComRef& newCref)
 {
   oms::ComRef tail(cref);
@@ -61,6 +61,7 @@ namespace oms
 
     Model* newModel(const ComRef& cref);
     oms_status_enu_t deleteModel(const ComRef& cref);
+    oms_status_enu_t cloneModel(const ComRef& cref, const ComRef& newCref);
     oms_status_enu_t renameModel(const ComRef& cref, const ComRef& newCref);
     oms_status_enu_t exportModel(const ComRef& cref, const std::string& filename);
     oms_status_enu_t importModel(const std::string& filename, char** cref);
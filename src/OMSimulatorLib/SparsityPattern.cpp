@@ -0,0 +1,290 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#include "SparsityPattern.h"
+
+#include <algorithm>
+#include <deque>
+
+oms::SparsityPattern::SparsityPattern()
+  : n(0)
+{
+}
+
+oms::SparsityPattern::~SparsityPattern()
+{
+}
+
+void oms::SparsityPattern::clear()
+{
+  n = 0;
+  entries.clear();
+  columnPointers.clear();
+  rowIndices.clear();
+  colorPointers.clear();
+  columnsByColor.clear();
+}
+
+void oms::SparsityPattern::resize(int n)
+{
+  clear();
+  this->n = n;
+  entries.resize(n);
+}
+
+void oms::SparsityPattern::addEntry(int row, int col)
+{
+  entries[col].push_back(row);
+}
+
+void oms::SparsityPattern::compress()
+{
+  columnPointers.resize(n + 1);
+  rowIndices.clear();
+
+  for (int j = 0; j < n; ++j)
+  {
+    std::vector<int>& column = entries[j];
+    column.push_back(j);
+    std::sort(column.begin(), column.end());
+    column.erase(std::unique(column.begin(), column.end()), column.end());
+
+    columnPointers[j] = static_cast<int>(rowIndices.size());
+    rowIndices.insert(rowIndices.end(), column.begin(), column.end());
+  }
+  columnPointers[n] = static_cast<int>(rowIndices.size());
+
+  entries.clear();
+  entries.shrink_to_fit();
+
+  colorColumns();
+}
+
+/**
+ * Greedy column coloring: two columns get different colors if they have a
+ * non-zero entry in the same row. All columns of one color can therefore be
+ * evaluated together with a single seed vector.
+ */
+void oms::SparsityPattern::colorColumns()
+{
+  // row-wise access to the pattern
+  std::vector<int> rowPointers(n + 1, 0);
+  std::vector<int> columnIndices(rowIndices.size());
+  for (const int& i : rowIndices)
+    rowPointers[i + 1]++;
+  for (int i = 0; i < n; ++i)
+    rowPointers[i + 1] += rowPointers[i];
+  std::vector<int> next(rowPointers.begin(), rowPointers.end() - 1);
+  for (int j = 0; j < n; ++j)
+    for (int k = columnPointers[j]; k < columnPointers[j + 1]; ++k)
+      columnIndices[next[rowIndices[k]]++] = j;
+
+  std::vector<int> colors(n, -1);
+  std::vector<int> forbidden(n, -1);
+  int nColors = 0;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int k = columnPointers[j]; k < columnPointers[j + 1]; ++k)
+    {
+      const int i = rowIndices[k];
+      for (int l = rowPointers[i]; l < rowPointers[i + 1]; ++l)
+        if (colors[columnIndices[l]] >= 0)
+          forbidden[colors[columnIndices[l]]] = j;
+    }
+
+    int color = 0;
+    while (forbidden[color] == j)
+      color++;
+    colors[j] = color;
+    nColors = std::max(nColors, color + 1);
+  }
+
+  colorPointers.assign(nColors + 1, 0);
+  for (int j = 0; j < n; ++j)
+    colorPointers[colors[j] + 1]++;
+  for (int c = 0; c < nColors; ++c)
+    colorPointers[c + 1] += colorPointers[c];
+
+  columnsByColor.resize(n);
+  next.assign(colorPointers.begin(), colorPointers.end() - 1);
+  for (int j = 0; j < n; ++j)
+    columnsByColor[next[colors[j]]++] = j;
+}
+
+void oms::SparsityPattern::getSymmetricAdjacency(std::vector< std::vector<int> >& adjacency) const
+{
+  adjacency.assign(n, std::vector<int>());
+  for (int j = 0; j < n; ++j)
+  {
+    for (int k = columnPointers[j]; k < columnPointers[j + 1]; ++k)
+    {
+      const int i = rowIndices[k];
+      if (i != j)
+      {
+        adjacency[i].push_back(j);
+        adjacency[j].push_back(i);
+      }
+    }
+  }
+
+  for (auto& neighbours : adjacency)
+  {
+    std::sort(neighbours.begin(), neighbours.end());
+    neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+  }
+}
+
+/**
+ * Reverse Cuthill-McKee ordering of the symmetrized pattern; perm[k] is the
+ * original index of the variable that is moved to position k.
+ */
+void oms::SparsityPattern::getReverseCuthillMcKee(std::vector<int>& perm) const
+{
+  std::vector< std::vector<int> > adjacency;
+  getSymmetricAdjacency(adjacency);
+
+  auto byDegree = [&adjacency](int a, int b) { return adjacency[a].size() < adjacency[b].size(); };
+  for (auto& neighbours : adjacency)
+    std::stable_sort(neighbours.begin(), neighbours.end(), byDegree);
+
+  perm.clear();
+  perm.reserve(n);
+  std::vector<bool> visited(n, false);
+  std::vector<int> distance(n, -1);
+
+  for (int root = 0; root < n; ++root)
+  {
+    if (visited[root])
+      continue;
+
+    // find a start node with low degree and large eccentricity in this component
+    int start = root;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+      std::vector<int> component{start};
+      distance[start] = 0;
+      for (size_t head = 0; head < component.size(); ++head)
+      {
+        for (const int& v : adjacency[component[head]])
+        {
+          if (distance[v] < 0)
+          {
+            distance[v] = distance[component[head]] + 1;
+            component.push_back(v);
+          }
+        }
+      }
+
+      const int eccentricity = distance[component.back()];
+      start = component.back();
+      for (const int& v : component)
+      {
+        if (distance[v] == eccentricity && adjacency[v].size() < adjacency[start].size())
+          start = v;
+        distance[v] = -1;
+      }
+    }
+
+    const size_t first = perm.size();
+    perm.push_back(start);
+    visited[start] = true;
+    for (size_t head = first; head < perm.size(); ++head)
+    {
+      for (const int& v : adjacency[perm[head]])
+      {
+        if (!visited[v])
+        {
+          visited[v] = true;
+          perm.push_back(v);
+        }
+      }
+    }
+  }
+
+  std::reverse(perm.begin(), perm.end());
+}
+
+void oms::SparsityPattern::getBandwidth(const std::vector<int>& perm, int& mu, int& ml) const
+{
+  std::vector<int> iperm(n);
+  for (int k = 0; k < n; ++k)
+    iperm[perm[k]] = k;
+
+  mu = 0;
+  ml = 0;
+  for (int j = 0; j < n; ++j)
+  {
+    for (int k = columnPointers[j]; k < columnPointers[j + 1]; ++k)
+    {
+      const int d = iperm[rowIndices[k]] - iperm[j];
+      if (d > 0)
+        ml = std::max(ml, d);
+      else
+        mu = std::max(mu, -d);
+    }
+  }
+}
+
+/**
+ * Splits the variables into independent diagonal blocks, i.e. the connected
+ * components of the symmetrized pattern; blocks[i] is the block of variable i.
+ */
+int oms::SparsityPattern::getBlocks(std::vector<int>& blocks) const
+{
+  std::vector< std::vector<int> > adjacency;
+  getSymmetricAdjacency(adjacency);
+
+  blocks.assign(n, -1);
+  int nBlocks = 0;
+  std::vector<int> queue;
+  for (int root = 0; root < n; ++root)
+  {
+    if (blocks[root] >= 0)
+      continue;
+
+    queue.assign(1, root);
+    blocks[root] = nBlocks;
+    for (size_t head = 0; head < queue.size(); ++head)
+    {
+      for (const int& v : adjacency[queue[head]])
+      {
+        if (blocks[v] < 0)
+        {
+          blocks[v] = nBlocks;
+          queue.push_back(v);
+        }
+      }
+    }
+    nBlocks++;
+  }
+
+  return nBlocks;
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of OpenModelica.
+ *
+ * Copyright (c) 1998-CurrentYear, Open Source Modelica Consortium (OSMC),
+ * c/o Linköpings universitet, Department of Computer and Information Science,
+ * SE-58183 Linköping, Sweden.
+ *
+ * All rights reserved.
+ *
+ * THIS PROGRAM IS PROVIDED UNDER THE TERMS OF GPL VERSION 3 LICENSE OR
+ * THIS OSMC PUBLIC LICENSE (OSMC-PL) VERSION 1.2.
+ * ANY USE, REPRODUCTION OR DISTRIBUTION OF THIS PROGRAM CONSTITUTES
+ * RECIPIENT'S ACCEPTANCE OF THE OSMC PUBLIC LICENSE OR THE GPL VERSION 3,
+ * ACCORDING TO RECIPIENTS CHOICE.
+ *
+ * The OpenModelica software and the Open Source Modelica
+ * Consortium (OSMC) Public License (OSMC-PL) are obtained
+ * from OSMC, either from the above address,
+ * from the URLs: http://www.ida.liu.se/projects/OpenModelica or
+ * http://www.openmodelica.org, and in the OpenModelica distribution.
+ * GNU version 3 is obtained from: http://www.gnu.org/copyleft/gpl.html.
+ *
+ * This program is distributed WITHOUT ANY WARRANTY; without
+ * even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE, EXCEPT AS EXPRESSLY SET FORTH
+ * IN THE BY RECIPIENT SELECTED SUBSIDIARY LICENSE CONDITIONS OF OSMC-PL.
+ *
+ * See the full OSMC Public License conditions for more details.
+ *
+ */
+
+#ifndef _OMS_SPARSITY_PATTERN_H_
+#define _OMS_SPARSITY_PATTERN_H_
+
+#include <vector>
+
+namespace oms
+{
+  /**
+   * @brief Sparsity pattern of a square Jacobian matrix.
+   *
+   * Entries are collected with addEntry() and converted to compressed sparse
+   * column (CSC) format by compress(). The diagonal is always included, since
+   * the Newton iteration matrices are of the form I - gamma*J.
+   */
+  class SparsityPattern
+  {
+  public:
+    SparsityPattern();
+    ~SparsityPattern();
+
+    void clear();
+    void resize(int n);
+
+    void addEntry(int row, int col);
+    void compress();
+
+    int getSize() const {return n;}
+    int getNumberOfNonZeros() const {return static_cast<int>(rowIndices.size());}
+    const std::vector<int>& getColumnPointers() const {return columnPointers;}
+    const std::vector<int>& getRowIndices() const {return rowIndices;}
+
+    int getNumberOfColors() const {return static_cast<int>(colorPointers.size()) - 1;}
+    const std::vector<int>& getColorPointers() const {return colorPointers;}
+    const std::vector<int>& getColumnsByColor() const {return columnsByColor;}
+
+    void getReverseCuthillMcKee(std::vector<int>& perm) const;
+    void getBandwidth(const std::vector<int>& perm, int& mu, int& ml) const;
+    int getBlocks(std::vector<int>& blocks) const;
+
+  private:
+    void colorColumns();
+    void getSymmetricAdjacency(std::vector< std::vector<int> >& adjacency) const;
+
+  private:
+    int n;
+    std::vector< std::vector<int> > entries; ///< row indices per column, only used before compress()
+
+    std::vector<int> columnPointers;
+    std::vector<int> rowIndices;
+
+    std::vector<int> colorPointers;  ///< columns of color c are columnsByColor[colorPointers[c]..colorPointers[c+1]-1]
+    std::vector<int> columnsByColor;
+  };
+}
+
+#endif
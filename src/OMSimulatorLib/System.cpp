@@ -34,6 +34,7 @@
 #include "Component.h"
 #include "ComponentFMUCS.h"
 #include "ComponentFMU3CS.h"
+#include "ComponentFMU3ME.h"
 #include "ComponentFMUME.h"
 #include "ComponentTable.h"
 #include "Flags.h"
@@ -251,6 +252,7 @@ bool oms::System::validCref(const oms::ComRef& cref)
 
 oms_status_enu_t oms::System::addSubSystem(const oms::ComRef& cref, oms_system_enu_t type)
 {
+  markDependencyGraphsDirty();
   if (cref.isEmpty())
     return logError_AlreadyInScope(getFullCref());
 
@@ -283,6 +285,7 @@ oms_status_enu_t oms::System::addSubSystem(const oms::ComRef& cref, oms_system_e
 
 oms_status_enu_t oms::System::addSubModel(const oms::ComRef& cref, const std::string& path)
 {
+  markDependencyGraphsDirty();
   if (cref.isValidIdent())
   {
     if (!validCref(cref))
@@ -307,6 +310,8 @@ oms_status_enu_t oms::System::addSubModel(const oms::ComRef& cref, const std::st
       component = ComponentFMUCS::NewComponent(cref, this, path_.string());
     else if (extension == ".fmu" && oms_system_wc == type && fmiVersion == "3.0")
       component = ComponentFMU3CS::NewComponent(cref, this, path_.string());
+    else if (extension == ".fmu" && oms_system_sc == type && fmiVersion == "3.0")
+      component = ComponentFMU3ME::NewComponent(cref, this, path_.string());
     else if (extension == ".fmu" && oms_system_sc == type)
       component = ComponentFMUME::NewComponent(cref, this, path_.string());
     else if (extension == ".csv" || extension == ".mat")
@@ -365,6 +370,7 @@ std::string oms::System::getFmiVersion(const std::string& path)
 
 oms_status_enu_t oms::System::replaceSubModel(const oms::ComRef& cref, const std::string& path, bool dryRun, int& warningCount)
 {
+  markDependencyGraphsDirty();
   /*
     take the snapshot of entire ssd before replacing,
     if (dryRun==true)
@@ -808,6 +814,7 @@ oms_status_enu_t oms::System::exportToSSV(Snapshot& snapshot) const
 
 oms_status_enu_t oms::System::importFromSnapshot(const pugi::xml_node& node, const std::string& sspVersion, const Snapshot& snapshot, std::string variantName)
 {
+  markDependencyGraphsDirty();
   for(pugi::xml_node_iterator it = node.begin(); it != node.end(); ++it)
   {
     std::string name = it->name();
@@ -917,6 +924,8 @@ oms_status_enu_t oms::System::importFromSnapshot(const pugi::xml_node& node, con
               component = ComponentFMU3CS::NewComponent(*itElements, this, sspVersion, snapshot, variantName);
             else if (getType() == oms_system_sc && fmiVersion == "2.0")
               component = ComponentFMUME::NewComponent(*itElements, this, sspVersion, snapshot, variantName);
+            else if (getType() == oms_system_sc && fmiVersion == "3.0")
+              component = ComponentFMU3ME::NewComponent(*itElements, this, sspVersion, snapshot, variantName);
             else
               return logError("wrong xml schema detected: " + name);
           }
@@ -1045,6 +1054,7 @@ oms_status_enu_t oms::System::importFromSnapshot(const pugi::xml_node& node, con
 
 oms_status_enu_t oms::System::addConnector(const oms::ComRef& cref, oms_causality_enu_t causality, oms_signal_type_enu_t type)
 {
+  markDependencyGraphsDirty();
   oms::ComRef tail(cref);
   oms::ComRef head = tail.pop_front();
   auto subsystem = subsystems.find(head);
@@ -1126,6 +1136,7 @@ oms::Connection** oms::System::getConnections(const oms::ComRef& cref)
 
 oms_status_enu_t oms::System::addConnection(const oms::ComRef& crefA, const oms::ComRef& crefB, bool suppressUnitConversion)
 {
+  markDependencyGraphsDirty();
   oms::ComRef tailA(crefA);
   oms::ComRef headA = tailA.pop_front();
 
@@ -1185,6 +1196,12 @@ oms_status_enu_t oms::System::addConnection(const oms::ComRef& crefA, const oms:
     return logError("Type mismatch in connection: " + std::string(crefA) + " -> " + std::string(crefB));
   }
 
+  // array connectors are connected as a whole
+  if (conA->getArraySize() != conB->getArraySize())
+    return logError("Array size mismatch in connection: " + std::string(crefA) + " -> " + std::string(crefB));
+  if ((conA->isArray() || conB->isArray()) && (conA->getType() != oms_signal_type_real || conB->getType() != oms_signal_type_real))
+    return logError("Only real arrays can be connected: " + std::string(crefA) + " -> " + std::string(crefB));
+
   // Do not allow multiple connections to same 'input' connector
   // (signal B). The 'input' connector (signal B) can actually be an
   // output connector, e.g. if connecting a component to a system
@@ -1231,6 +1248,7 @@ oms_status_enu_t oms::System::addConnection(const oms::ComRef& crefA, const oms:
 
 oms_status_enu_t oms::System::deleteConnection(const oms::ComRef& crefA, const oms::ComRef& crefB)
 {
+  markDependencyGraphsDirty();
   for (auto& connection : connections)
   {
     if (connection && connection->isEqual(crefA, crefB))
@@ -1427,6 +1445,7 @@ oms::Model& oms::System::getModel()
 
 oms_status_enu_t oms::System::deleteAllConectionsTo(const oms::ComRef& cref)
 {
+  markDependencyGraphsDirty();
   for (int i=0; i<connections.size(); ++i)
   {
     while (connections[i] && connections[i]->containsSignal(cref))
@@ -1453,6 +1472,7 @@ bool oms::System::isConnected(const ComRef& cref) const
 
 oms_status_enu_t oms::System::delete_(const oms::ComRef& cref)
 {
+  markDependencyGraphsDirty();
   oms::ComRef tail(cref);
   oms::ComRef front = tail.pop_front();
 
@@ -1621,17 +1641,34 @@ oms_status_enu_t oms::System::exportDependencyGraphs(const std::string& pathInit
   return status;
 }
 
+void oms::System::markDependencyGraphsDirty()
+{
+  // the graphs of the parent systems include the graphs of this system
+  for (System* system = this; system; system = system->getParentSystem())
+    system->dependencyGraphsDirty = true;
+}
+
 oms_status_enu_t oms::System::updateDependencyGraphs()
 {
+  for (const auto& subsystem : subsystems)
+    if (oms_status_ok != subsystem.second->updateDependencyGraphs())
+      return oms_status_error;
+
+  // The graphs only depend on the components, subsystems and connections.
+  // Unless one of them changed since the last call, the graphs and their
+  // sorted connections are kept.
+  if (!dependencyGraphsDirty)
+  {
+    logDebug(std::string(getFullCref()) + ": dependency graphs are up to date");
+    return oms_status_ok;
+  }
+
   initializationGraph.clear();
   eventGraph.clear();
   simulationGraph.clear();
 
   for (const auto& subsystem : subsystems)
   {
-    if (oms_status_ok != subsystem.second->updateDependencyGraphs())
-      return oms_status_error;
-
     initializationGraph.includeGraph(subsystem.second->getInitialUnknownsGraph(), subsystem.first);
     eventGraph.includeGraph(subsystem.second->getOutputsGraph(), subsystem.first);
     simulationGraph.includeGraph(subsystem.second->getOutputsGraph(), subsystem.first);
@@ -1694,9 +1731,42 @@ oms_status_enu_t oms::System::updateDependencyGraphs()
     }
   }
 
+  dependencyGraphsDirty = false;
   return oms_status_ok;
 }
 
+/**
+ * @brief Takes over the dependency graphs of the system a model is cloned
+ * from, including the sorted connections and torn loops.
+ *
+ * The clone has the same components, subsystems and connections, so the
+ * graphs only differ in the name of the model.
+ */
+void oms::System::copyDependencyGraphs(const System& source)
+{
+  fmuGuid = source.fmuGuid;
+
+  for (const auto& subsystem : subsystems)
+  {
+    auto it = source.subsystems.find(subsystem.first);
+    if (it != source.subsystems.end())
+      subsystem.second->copyDependencyGraphs(*it->second);
+  }
+
+  if (source.dependencyGraphsDirty)
+    return;
+
+  initializationGraph = source.initializationGraph;
+  eventGraph = source.eventGraph;
+  simulationGraph = source.simulationGraph;
+
+  initializationGraph.renameModel(getModel().getCref());
+  eventGraph.renameModel(getModel().getCref());
+  simulationGraph.renameModel(getModel().getCref());
+
+  dependencyGraphsDirty = false;
+}
+
 oms_status_enu_t oms::System::getBoolean(const ComRef& cref, bool& value)
 {
   if (!getModel().validState(oms_modelState_virgin|oms_modelState_instantiated|oms_modelState_initialization|oms_modelState_simulation))
@@ -1837,6 +1907,25 @@ oms_status_enu_t oms::System::getInteger(const ComRef& cref, int& value)
   return logError_UnknownSignal(getFullCref() + cref);
 }
 
+/**
+ * @brief Reads an FMI 3.0 array variable of a component with a single call.
+ */
+oms_status_enu_t oms::System::getRealArray(const ComRef& cref, double* values, size_t size)
+{
+  oms::ComRef tail(cref);
+  oms::ComRef head = tail.pop_front();
+
+  auto subsystem = subsystems.find(head);
+  if (subsystem != subsystems.end())
+    return subsystem->second->getRealArray(tail, values, size);
+
+  auto component = components.find(head);
+  if (component != components.end())
+    return component->second->getRealArray(tail, values, size);
+
+  return logError_UnknownSignal(getFullCref() + cref);
+}
+
 oms_status_enu_t oms::System::getReal(const ComRef& cref, double& value)
 {
   if (!getModel().validState(oms_modelState_virgin|oms_modelState_instantiated|oms_modelState_initialization|oms_modelState_simulation))
@@ -2056,6 +2145,63 @@ oms_status_enu_t oms::System::freeState(const ComRef& cref)
   return logError_UnknownSignal(getFullCref() + cref);
 }
 
+/**
+ * @brief Writes the time, all components, all subsystems and the solver
+ * state to the checkpoint.
+ *
+ * Each element is preceded by its name, so that deserializeState() can
+ * detect a checkpoint that doesn't belong to this system.
+ */
+oms_status_enu_t oms::System::serializeState(Checkpoint& checkpoint)
+{
+  checkpoint.writeString(std::string(getCref()));
+  checkpoint.writeValue(time);
+
+  checkpoint.writeValue<uint64_t>(components.size());
+  for (const auto& component : components)
+  {
+    if (!component.second->getCanSerializeState())
+      return logError("Component \"" + std::string(component.second->getFullCref()) + "\" doesn't support serialization of its state");
+
+    checkpoint.writeString(std::string(component.first));
+    if (oms_status_ok != component.second->serializeState(checkpoint))
+      return oms_status_error;
+  }
+
+  checkpoint.writeValue<uint64_t>(subsystems.size());
+  for (const auto& subsystem : subsystems)
+    if (oms_status_ok != subsystem.second->serializeState(checkpoint))
+      return oms_status_error;
+
+  return serializeSolverState(checkpoint);
+}
+
+oms_status_enu_t oms::System::deserializeState(Checkpoint& checkpoint)
+{
+  std::string name;
+  uint64_t n;
+  if (!checkpoint.readString(name) || name != std::string(getCref()) || !checkpoint.readValue(time))
+    return logError("Checkpoint doesn't match system " + std::string(getFullCref()));
+
+  if (!checkpoint.readValue(n) || n != components.size())
+    return logError("Checkpoint doesn't match the components of system " + std::string(getFullCref()));
+  for (const auto& component : components)
+  {
+    if (!checkpoint.readString(name) || name != std::string(component.first))
+      return logError("Checkpoint doesn't match the components of system " + std::string(getFullCref()));
+    if (oms_status_ok != component.second->deserializeState(checkpoint))
+      return oms_status_error;
+  }
+
+  if (!checkpoint.readValue(n) || n != subsystems.size())
+    return logError("Checkpoint doesn't match the subsystems of system " + std::string(getFullCref()));
+  for (const auto& subsystem : subsystems)
+    if (oms_status_ok != subsystem.second->deserializeState(checkpoint))
+      return oms_status_error;
+
+  return deserializeSolverState(checkpoint);
+}
+
 oms_status_enu_t oms::System::setBoolean(const ComRef& cref, bool value)
 {
   if (!getModel().validState(oms_modelState_virgin|oms_modelState_enterInstantiation|oms_modelState_instantiated|oms_modelState_initialization|oms_modelState_simulation))
@@ -2150,6 +2296,25 @@ oms_status_enu_t oms::System::setInteger(const ComRef& cref, int value)
   return logError_UnknownSignal(getFullCref() + cref);
 }
 
+/**
+ * @brief Writes an FMI 3.0 array variable of a component with a single call.
+ */
+oms_status_enu_t oms::System::setRealArray(const ComRef& cref, const double* values, size_t size)
+{
+  oms::ComRef tail(cref);
+  oms::ComRef head = tail.pop_front();
+
+  auto subsystem = subsystems.find(head);
+  if (subsystem != subsystems.end())
+    return subsystem->second->setRealArray(tail, values, size);
+
+  auto component = components.find(head);
+  if (component != components.end())
+    return component->second->setRealArray(tail, values, size);
+
+  return logError_UnknownSignal(getFullCref() + cref);
+}
+
 oms_status_enu_t oms::System::setReal(const ComRef& cref, double value)
 {
   if (!getModel().validState(oms_modelState_virgin|oms_modelState_enterInstantiation|oms_modelState_instantiated|oms_modelState_initialization|oms_modelState_simulation))
@@ -2248,6 +2413,7 @@ oms_status_enu_t oms::System::setString(const ComRef& cref, const std::string& v
 
 oms_status_enu_t oms::System::setUnit(const ComRef& cref, const std::string& value)
 {
+  markDependencyGraphsDirty();
   oms::ComRef tail(cref);
   oms::ComRef head = tail.pop_front();
 
@@ -2633,6 +2799,7 @@ oms_status_enu_t oms::System::solveAlgLoop(DirectedGraph& graph, int loopNumber)
 
 oms_status_enu_t oms::System::rename(const oms::ComRef& newCref)
 {
+  markDependencyGraphsDirty();
   this->cref = newCref;
   this->renameConnectors();
 
@@ -2645,6 +2812,7 @@ oms_status_enu_t oms::System::rename(const oms::ComRef& newCref)
 
 oms_status_enu_t oms::System::rename(const ComRef& cref, const ComRef& newCref)
 {
+  markDependencyGraphsDirty();
   // renaming the system itself
   if (cref.isEmpty())
     return this->rename(newCref);
@@ -2698,6 +2866,7 @@ oms_status_enu_t oms::System::rename(const ComRef& cref, const ComRef& newCref)
 
 oms_status_enu_t oms::System::renameConnections(const ComRef &cref, const ComRef &newCref)
 {
+  markDependencyGraphsDirty();
   //logInfo("renameConnections in " + std::string(getFullCref()) + ": [" + std::string(cref) + "], [" + std::string(newCref) + "]");
   for (const auto &connection : connections)
     if (connection)
@@ -2708,6 +2877,7 @@ oms_status_enu_t oms::System::renameConnections(const ComRef &cref, const ComRef
 
 oms_status_enu_t oms::System::renameConnectors()
 {
+  markDependencyGraphsDirty();
   // update the connector owner with new cref
   for (const auto &connector : connectors)
   {
@@ -34,11 +34,13 @@
 
 #include "AlgLoop.h"
 #include "BusConnector.h"
+#include "Checkpoint.h"
 #include "Clock.h"
 #include "ComRef.h"
 #include "Connection.h"
 #include "DirectedGraph.h"
 #include "Element.h"
+#include "Logging.h"
 #include "ResultWriter.h"
 #include "Snapshot.h"
 #include "ssd/ConnectorGeometry.h"
@@ -68,6 +70,7 @@ namespace oms
     virtual oms_status_enu_t registerSignalsForResultFile(ResultWriter& resultFile);
     virtual oms_status_enu_t updateSignals(ResultWriter& resultFile);
     virtual oms_status_enu_t setSolver(oms_solver_enu_t solver) {return oms_status_error;}
+    virtual oms_status_enu_t setActivationRatio(const ComRef& cref, int k) {return logError_NotImplemented;}
     virtual oms_status_enu_t instantiate() = 0;
     virtual oms_status_enu_t initialize() = 0;
     virtual oms_status_enu_t terminate() = 0;
@@ -125,6 +128,8 @@ namespace oms
     std::map<ComRef, Component*>& getComponents() {return components;}
     std::vector<Connection*>& getConnections() {return connections;}
     oms_status_enu_t updateDependencyGraphs();
+    void copyDependencyGraphs(const System& source);
+    void markDependencyGraphsDirty();
     const DirectedGraph& getInitialUnknownsGraph() {return initializationGraph;}
     const DirectedGraph& getOutputsGraph() {return eventGraph;}
     oms_status_enu_t exportDependencyGraphs(const std::string& pathInitialization, const std::string& pathEvent, const std::string& pathSimulation);
@@ -134,10 +139,12 @@ namespace oms
     oms_status_enu_t getBoolean(const ComRef& cref, bool& value);
     oms_status_enu_t getInteger(const ComRef& cref, int& value);
     oms_status_enu_t getReal(const ComRef& cref, double& value);
+    oms_status_enu_t getRealArray(const ComRef& cref, double* values, size_t size);
     oms_status_enu_t getString(const ComRef& cref, std::string& value);
     oms_status_enu_t setBoolean(const ComRef& cref, bool value);
     oms_status_enu_t setInteger(const ComRef& cref, int value);
     oms_status_enu_t setReal(const ComRef& cref, double value);
+    oms_status_enu_t setRealArray(const ComRef& cref, const double* values, size_t size);
     oms_status_enu_t setString(const ComRef& cref, const std::string& value);
     oms_status_enu_t setUnit(const ComRef& cref, const std::string& value);
     oms_status_enu_t getVariableType(const ComRef& cref, oms_signal_type_enu_t& type);
@@ -152,6 +159,9 @@ namespace oms
     oms_status_enu_t setState(const ComRef& cref);
     oms_status_enu_t freeState(const ComRef& cref);
 
+    oms_status_enu_t serializeState(Checkpoint& checkpoint);
+    oms_status_enu_t deserializeState(Checkpoint& checkpoint);
+
     oms_status_enu_t rename(const ComRef& newCref); ///< rename the system itself
     oms_status_enu_t rename(const ComRef& cref, const ComRef& newCref); ///< rename any component within the system
     oms_status_enu_t renameConnections(const ComRef& cref, const ComRef& newCref);
@@ -192,6 +202,10 @@ namespace oms
   protected: // methods
     System(const ComRef& cref, oms_system_enu_t type, Model* parentModel, System* parentSystem, oms_solver_enu_t solverMethod);
 
+    /// master algorithm state of the derived system, written after all components and subsystems
+    virtual oms_status_enu_t serializeSolverState(Checkpoint& checkpoint) {return oms_status_ok;}
+    virtual oms_status_enu_t deserializeSolverState(Checkpoint& checkpoint) {return oms_status_ok;}
+
     // stop the compiler generating methods copying the object
     System(System const& copy);            ///< not implemented
     System& operator=(System const& copy); ///< not implemented
@@ -207,6 +221,7 @@ namespace oms
     DirectedGraph initializationGraph;  ///< dependency graph, with all connections, solved at initialization
     DirectedGraph eventGraph;  ///< filtered dependency graph, without parameters, solved at event mode
     DirectedGraph simulationGraph;  ///< filtered dependency graph, with connections of type Real, solved at continuous time mode;
+    bool dependencyGraphsDirty = true;  ///< components or connections changed since the dependency graphs were built, see markDependencyGraphsDirty()
 
     Clock clock;
     unsigned int clock_id;
@@ -32,46 +32,68 @@
 #include "SystemSC.h"
 
 #include "Component.h"
-#include "ComponentFMUME.h"
 #include "ComponentTable.h"
 #include "Flags.h"
+#include "LinearSolver.h"
 #include "Model.h"
 #include "ssd/Tags.h"
 
+#include <sunmatrix/sunmatrix_sparse.h>
+
 #include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <functional>
 #include <sstream>
 
-int oms::cvode_rhs(realtype t, N_Vector y, N_Vector ydot, void* user_data)
+namespace
 {
-  SystemSC* system = (SystemSC*)user_data;
-  oms_status_enu_t status;
-  fmi2Status fmistatus;
-
-  // update states in FMUs
-  for (size_t i=0, j_y=0, j_ydot=0; i < system->fmus.size(); ++i)
+  // Butcher tableau of the Dormand-Prince 5(4) method
+  const double dopri5_c[7] = {0.0, 1.0/5.0, 3.0/10.0, 4.0/5.0, 8.0/9.0, 1.0, 1.0};
+  const double dopri5_a[7][6] = {
+    {0.0},
+    {1.0/5.0},
+    {3.0/40.0, 9.0/40.0},
+    {44.0/45.0, -56.0/15.0, 32.0/9.0},
+    {19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0},
+    {9017.0/3168.0, -355.0/33.0, 46732.0/5247.0, 49.0/176.0, -5103.0/18656.0},
+    {35.0/384.0, 0.0, 500.0/1113.0, 125.0/192.0, -2187.0/6784.0, 11.0/84.0}};
+
+  // difference of the 5th and the embedded 4th order solution
+  const double dopri5_e[7] = {71.0/57600.0, 0.0, -71.0/16695.0, 71.0/1920.0, -17253.0/339200.0, 22.0/525.0, -1.0/40.0};
+
+  // continuous extension of order 4 (Hairer, Norsett, Wanner)
+  const double dopri5_d[7] = {-12715105075.0/11282082432.0, 0.0, 87487479700.0/32700410799.0, -10690763975.0/1880347072.0, 701980252875.0/199316789632.0, -1453857185.0/822651844.0, 69997945.0/29380423.0};
+
+  /// dense output at t + theta*h of the step from y to ynew with the stage derivatives k
+  void dopri5_dense(size_t n, double theta, double h, const double* y, const double* ynew, const double* k, double* yout)
   {
-    system->fmus[i]->setTime(t);
-
-    if (0 == system->nStates[i])
-      continue;
-
-    for (size_t k = 0; k < system->nStates[i]; k++, j_y++)
-      system->states[i][k] = NV_Ith_S(y, j_y);
-
-    // set states
-    status = system->fmus[i]->setContinuousStates(system->states[i]);
-    if (oms_status_ok != status) return status;
-
-    // get state derivatives
-    status = system->fmus[i]->getDerivatives(system->states_der[i]);
-    if (oms_status_ok != status) return status;
+    const double theta1 = 1.0 - theta;
+    for (size_t j = 0; j < n; ++j)
+    {
+      const double ydiff = ynew[j] - y[j];
+      const double bspl = h*k[j] - ydiff;
+      double r5 = 0.0;
+      for (size_t s = 0; s < 7; ++s)
+        r5 += dopri5_d[s]*k[s*n + j];
+      yout[j] = y[j] + theta*(ydiff + theta1*(bspl + theta*(ydiff - h*k[6*n + j] - bspl + theta1*h*r5)));
+    }
+  }
 
-    for (size_t k=0; k < system->nStates[i]; ++k, ++j_ydot)
-      NV_Ith_S(ydot, j_ydot) = system->states_der[i][k];
+  /// true if any event indicator changed its sign
+  bool signChanged(const std::vector<double>& g, const std::vector<double>& gnew)
+  {
+    for (size_t k = 0; k < g.size(); ++k)
+      if ((g[k] > 0) != (gnew[k] > 0))
+        return true;
+    return false;
   }
+}
 
-  return 0;
+int oms::cvode_rhs(realtype t, N_Vector y, N_Vector ydot, void* user_data)
+{
+  SystemSC* system = (SystemSC*)user_data;
+  return system->evaluateRHS(t, NV_DATA_S(y), NV_DATA_S(ydot));
 }
 
 int oms::cvode_rhs_algebraic(realtype t, N_Vector y, N_Vector ydot, void* user_data)
@@ -88,30 +110,82 @@ int oms::cvode_rhs_algebraic(realtype t, N_Vector y, N_Vector ydot, void* user_d
 
 int oms::cvode_roots(realtype t, N_Vector y, realtype *gout, void *user_data)
 {
-  logDebug("cvode_roots at time " + std::to_string(t));
+  if (logDebugEnabled())
+    logDebug("cvode_roots at time " + std::to_string(t));
+
   SystemSC* system = (SystemSC*)user_data;
-  oms_status_enu_t status;
-  fmi2Status fmistatus;
+  return system->evaluateEventIndicators(t, NV_DATA_S(y), gout);
+}
 
-  for (size_t i=0, j_y=0, j_gout=0; i < system->fmus.size(); ++i)
+int oms::cvode_jac(realtype t, N_Vector y, N_Vector fy, SUNMatrix J, void* user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3)
+{
+  SystemSC* system = (SystemSC*)user_data;
+  const SparsityPattern& pattern = system->sparsityPattern;
+  const std::vector<int>& columnPointers = pattern.getColumnPointers();
+  const std::vector<int>& rowIndices = pattern.getRowIndices();
+
+  // SUNMatZero also clears the structure of sparse matrices, so it is set on every call
+  sunindextype* indexptrs = SM_INDEXPTRS_S(J);
+  sunindextype* indexvals = SM_INDEXVALS_S(J);
+  realtype* data = SM_DATA_S(J);
+  for (int j = 0; j <= pattern.getSize(); ++j)
+    indexptrs[j] = columnPointers[j];
+  for (int k = 0; k < pattern.getNumberOfNonZeros(); ++k)
+    indexvals[k] = rowIndices[k];
+
+  realtype* y_data = NV_DATA_S(y);
+  realtype* fy_data = NV_DATA_S(fy);
+  realtype* ftemp_data = NV_DATA_S(tmp1);
+  realtype* ysave_data = NV_DATA_S(tmp2);
+  const realtype* abstol_data = NV_DATA_S(system->solverData.cvode.abstol);
+  const realtype srur = std::sqrt(UNIT_ROUNDOFF);
+
+  // the diagonal blocks are evaluated with the inputs that belong to y
+  if (system->coupledRHS)
   {
-    system->fmus[i]->setTime(t);
+    oms_status_enu_t status = system->updateStates(t, y_data);
+    if (oms_status_ok != status) return status;
+    status = system->updateRHSInputs();
+    if (oms_status_ok != status) return status;
+  }
 
-    if (0 != system->nStates[i])
-    {
-      for (size_t k = 0; k < system->nStates[i]; k++, j_y++)
-        system->states[i][k] = NV_Ith_S(y, j_y);
+  // diagonal blocks of the FMUs
+  for (size_t i = 0; i < system->fmus.size(); ++i)
+  {
+    if (0 == system->nStates[i] || system->jacobianBlocks[i].coupled)
+      continue;
 
-      // set states
-      status = system->fmus[i]->setContinuousStates(system->states[i]);
-      if (oms_status_ok != status) return status;
+    int flag = system->getJacobianBlock(i, t, y_data, fy_data, data);
+    if (0 != flag)
+      return flag;
+  }
+
+  // coupling between FMUs: all coupling columns of one color are perturbed at once, since they don't share any row
+  for (size_t c = 0; c + 1 < system->couplingColorPointers.size(); ++c)
+  {
+    for (int l = system->couplingColorPointers[c]; l < system->couplingColorPointers[c + 1]; ++l)
+    {
+      const int j = system->couplingColumns[l];
+      ysave_data[j] = y_data[j];
+      y_data[j] += srur * std::max(std::fabs(y_data[j]), abstol_data[j] / system->relativeTolerance);
     }
 
-    fmistatus = fmi2_getEventIndicators(system->fmus[i]->getFMU(), system->event_indicators[i], system->nEventIndicators[i]);
-    if (fmi2OK != fmistatus) logError_FMUCall("fmi2_getEventIndicators", system->fmus[i]);
+    int flag = cvode_rhs(t, y, tmp1, user_data);
+
+    for (int l = system->couplingColorPointers[c]; l < system->couplingColorPointers[c + 1]; ++l)
+    {
+      const int j = system->couplingColumns[l];
+      const realtype inc = y_data[j] - ysave_data[j];
+      y_data[j] = ysave_data[j];
+      for (int e = system->couplingEntryPointers[l]; e < system->couplingEntryPointers[l + 1]; ++e)
+      {
+        const int k = system->couplingEntries[e];
+        data[k] = (ftemp_data[rowIndices[k]] - fy_data[rowIndices[k]]) / inc;
+      }
+    }
 
-    for (size_t k=0; k < system->nEventIndicators[i]; k++, j_gout++)
-      gout[j_gout] = system->event_indicators[i][k];
+    if (0 != flag)
+      return flag;
   }
 
   return 0;
@@ -152,6 +226,8 @@ std::string oms::SystemSC::getSolverName() const
       return std::string("euler");
     case oms_solver_sc_cvode:
       return std::string("cvode");
+    case oms_solver_sc_dopri5:
+      return std::string("dopri5");
     default:
       return std::string("unknown");
   }
@@ -163,6 +239,8 @@ oms_status_enu_t oms::SystemSC::setSolverMethod(std::string solver)
     solverMethod = oms_solver_sc_explicit_euler;
   else if (std::string("cvode") == solver)
     solverMethod = oms_solver_sc_cvode;
+  else if (std::string("dopri5") == solver)
+    solverMethod = oms_solver_sc_dopri5;
   else
     return oms_status_error;
 
@@ -232,9 +310,9 @@ oms_status_enu_t oms::SystemSC::instantiate()
     if (oms_status_ok != component.second->instantiate())
       return oms_status_error;
 
-    if (component.second->getType() == oms_component_fmu)
+    if (component.second->getType() == oms_component_fmu || component.second->getType() == oms_component_fmu3)
     {
-      fmus.push_back(dynamic_cast<ComponentFMUME*>(component.second));
+      fmus.push_back(component.second);
 
       callEventUpdate.push_back(fmi2False);
       terminateSimulation.push_back(fmi2False);
@@ -250,13 +328,26 @@ oms_status_enu_t oms::SystemSC::instantiate()
     }
   }
 
+  stateOffsets.assign(1, 0);
+  eventIndicatorOffsets.assign(1, 0);
+  for (size_t i=0; i < fmus.size(); ++i)
+  {
+    stateOffsets.push_back(stateOffsets.back() + nStates[i]);
+    eventIndicatorOffsets.push_back(eventIndicatorOffsets.back() + nEventIndicators[i]);
+  }
+
   if (n_states == 0)
     logInfo("model doesn't contain any continuous state");
 
+  // also for the other solvers, since the solver can be changed after reset()
+  solverData.cvode.mem = nullptr;
+
   if (oms_solver_sc_explicit_euler == solverMethod)
     ;
   else if (oms_solver_sc_cvode == solverMethod)
-    solverData.cvode.mem = nullptr;
+    ;
+  else if (oms_solver_sc_dopri5 == solverMethod)
+    ;
   else
     return logError_InternalError;
 
@@ -322,7 +413,16 @@ oms_status_enu_t oms::SystemSC::initialize()
     }
   }
 
-  if (oms_solver_sc_cvode == solverMethod)
+  // the CVODE memory kept by reset() only fits the same solver settings
+  if (solverData.cvode.mem && (oms_solver_sc_cvode != solverMethod || cvodeLinearSolver != Flags::CVODELinearSolver()))
+    freeCVODE();
+
+  if (oms_solver_sc_cvode == solverMethod && solverData.cvode.mem)
+  {
+    if (oms_status_ok != reinitializeCVODE())
+      return oms_status_error;
+  }
+  else if (oms_solver_sc_cvode == solverMethod)
   {
     size_t n_states = 0;
     for (size_t i=0; i < fmus.size(); ++i)
@@ -358,6 +458,7 @@ oms_status_enu_t oms::SystemSC::initialize()
     // Backward Differentiation Formula and the use of a Newton iteration
     solverData.cvode.mem = CVodeCreate(CV_BDF);
     if (!solverData.cvode.mem) logError("SUNDIALS_ERROR: CVodeCreate() failed - returned NULL pointer");
+    cvodeLinearSolver = Flags::CVODELinearSolver();
 
     int flag = CVodeSetUserData(solverData.cvode.mem, (void*)this);
     if (flag < 0) logError("SUNDIALS_ERROR: CVodeSetUserData() failed with flag = " + std::to_string(flag));
@@ -376,19 +477,53 @@ oms_status_enu_t oms::SystemSC::initialize()
     flag = CVodeSVtolerances(solverData.cvode.mem, relativeTolerance, solverData.cvode.abstol);
     if (flag < 0) logError("SUNDIALS_ERROR: CVodeSVtolerances() failed with flag = " + std::to_string(flag));
 
-    // Call N_VNew_Serial and SUNDenseMatrix to generate dense vector abd natrix for lin. solver module
     solverData.cvode.liny = N_VNew_Serial(n_states);
     if (solverData.cvode.liny == NULL) logError("SUNDIALS_ERROR: N_VNew_Serial() failed");
-    solverData.cvode.J = SUNDenseMatrix(n_states, n_states);
-    if (solverData.cvode.J == NULL) logError("SUNDIALS_ERROR: N_VNew_Serial() failed");
 
-    // Call SUNLinSol_Dense to creat linear solver object
-    solverData.cvode.linSol = SUNLinSol_Dense(solverData.cvode.liny, solverData.cvode.J);
-    if (solverData.cvode.linSol == NULL) logError("SUNDIALS_ERROR: SUNLinSol_Dense() failed");
+    if (!algebraic && Flags::CVODELinearSolver() != "dense")
+    {
+      if (oms_status_ok != updateSparsityPattern())
+        return oms_status_error;
+      if (oms_status_ok != initializeJacobian())
+        return oms_status_error;
+
+      // Call SUNSparseMatrix to use the structure of the FMUs for the lin. solver module
+      solverData.cvode.J = SUNSparseMatrix(n_states, n_states, sparsityPattern.getNumberOfNonZeros(), CSC_MAT);
+      if (solverData.cvode.J == NULL) logError("SUNDIALS_ERROR: SUNSparseMatrix() failed");
+
+      if (Flags::CVODELinearSolver() == "blockdiagonal")
+      {
+        // blocks are only factorized in parallel if no enclosing system is using the thread pool
+        solverData.cvode.linSol = LinSol_BlockDiagonal(solverData.cvode.liny, sparsityPattern, (isTopLevelSystem() && useThreadPool()) ? &getThreadPool() : nullptr);
+        if (solverData.cvode.linSol == NULL) logError("SUNDIALS_ERROR: LinSol_BlockDiagonal() failed");
+      }
+      else
+      {
+        solverData.cvode.linSol = LinSol_SparseBand(solverData.cvode.liny, sparsityPattern);
+        if (solverData.cvode.linSol == NULL) logError("SUNDIALS_ERROR: LinSol_SparseBand() failed");
+      }
+
+      flag = CVodeSetLinearSolver(solverData.cvode.mem, solverData.cvode.linSol, solverData.cvode.J);
+      if (flag < 0) logError("SUNDIALS_ERROR: CVodeSetLinearSolver() failed with flag = " + std::to_string(flag));
+
+      // The Jacobian is evaluated by finite differences using a column coloring of the sparsity pattern
+      flag = CVodeSetJacFn(solverData.cvode.mem, cvode_jac);
+      if (flag < 0) logError("SUNDIALS_ERROR: CVodeSetJacFn() failed with flag = " + std::to_string(flag));
+    }
+    else
+    {
+      // Call SUNDenseMatrix to generate dense matrix for lin. solver module
+      solverData.cvode.J = SUNDenseMatrix(n_states, n_states);
+      if (solverData.cvode.J == NULL) logError("SUNDIALS_ERROR: SUNDenseMatrix() failed");
+
+      // Call SUNLinSol_Dense to creat linear solver object
+      solverData.cvode.linSol = SUNLinSol_Dense(solverData.cvode.liny, solverData.cvode.J);
+      if (solverData.cvode.linSol == NULL) logError("SUNDIALS_ERROR: SUNLinSol_Dense() failed");
 
-    // Call CVodeSetLinearSolver to set the dense linear solver */
-    flag = CVodeSetLinearSolver(solverData.cvode.mem, solverData.cvode.linSol, solverData.cvode.J);
-    if (flag < 0) logError("SUNDIALS_ERROR: CVDense() failed with flag = " + std::to_string(flag));
+      // Call CVodeSetLinearSolver to set the dense linear solver */
+      flag = CVodeSetLinearSolver(solverData.cvode.mem, solverData.cvode.linSol, solverData.cvode.J);
+      if (flag < 0) logError("SUNDIALS_ERROR: CVDense() failed with flag = " + std::to_string(flag));
+    }
 
     logInfo("maximum step size for '" + std::string(getFullCref()) + "': " + std::to_string(maximumStepSize));
     flag = CVodeSetMaxStep(solverData.cvode.mem, maximumStepSize);
@@ -411,6 +546,50 @@ oms_status_enu_t oms::SystemSC::initialize()
     if (flag < 0) logError("SUNDIALS_ERROR: CVodeSetMaxErrTestFails() failed with flag = " + std::to_string(flag));
     flag = CVodeSetMaxNumSteps(solverData.cvode.mem, Flags::CVODEMaxSteps());            // MAXIMUM NUMBER OF STEPS
     if (flag < 0) logError("SUNDIALS_ERROR: CVodeSetMaxNumSteps() failed with flag = " + std::to_string(flag));
+
+    if (oms_status_ok != initializeEventRouting())
+      return oms_status_error;
+
+    coupledRHS = !algebraic && Flags::CoupledRHS();
+    if (coupledRHS && oms_status_ok != initializeRHSConnections())
+      return oms_status_error;
+  }
+  else if (oms_solver_sc_dopri5 == solverMethod)
+  {
+    SolverDataDOPRI5_t& rk = solverDataDOPRI5;
+    const size_t n_states = stateOffsets.back();
+
+    rk.y.assign(n_states, 0.0);
+    rk.abstol.assign(n_states, 0.0);
+    for (size_t j=0, k=0; j < fmus.size(); ++j)
+      for (size_t i=0; i < nStates[j]; ++i, ++k)
+      {
+        rk.y[k] = states[j][i];
+        rk.abstol[k] = relativeTolerance*states_nominal[j][i];
+      }
+    rk.ynew.assign(n_states, 0.0);
+    rk.ytmp.assign(n_states, 0.0);
+    rk.k.assign(7*n_states, 0.0);
+    rk.g.assign(eventIndicatorOffsets.back(), 0.0);
+    rk.gnew.assign(eventIndicatorOffsets.back(), 0.0);
+
+    rk.h = initialStepSize;
+    rk.errorNorm = 0.0;
+    rk.fsal = false;
+    rk.nSteps = 0;
+    rk.nRejectedSteps = 0;
+    rk.nRhsEvals = 0;
+    rk.nEvents = 0;
+    rk.active = true;
+
+    logInfo("maximum step size for '" + std::string(getFullCref()) + "': " + std::to_string(maximumStepSize));
+
+    if (oms_status_ok != initializeEventRouting())
+      return oms_status_error;
+
+    coupledRHS = n_states > 0 && Flags::CoupledRHS();
+    if (coupledRHS && oms_status_ok != initializeRHSConnections())
+      return oms_status_error;
   }
 
   // Mark algebraic loops to be updated on next call
@@ -419,6 +598,71 @@ oms_status_enu_t oms::SystemSC::initialize()
   return oms_status_ok;
 }
 
+/**
+ * @brief Restarts CVODE from the initial states of the FMUs after reset().
+ *
+ * The structure of the system can't change between reset() and
+ * initialize(), so the solver memory, the linear solver and the Jacobian
+ * of the previous run are reused. initialize() frees them instead if the
+ * solver or --CVODELinearSolver was changed.
+ */
+oms_status_enu_t oms::SystemSC::reinitializeCVODE()
+{
+  if (algebraic)
+  {
+    NV_Ith_S(solverData.cvode.y, 0) = 0.0;
+    NV_Ith_S(solverData.cvode.abstol, 0) = relativeTolerance;
+  }
+  else
+    for (size_t j=0, k=0; j < fmus.size(); ++j)
+      for (size_t i=0; i < nStates[j]; ++i, ++k)
+      {
+        NV_Ith_S(solverData.cvode.y, k) = states[j][i];
+        NV_Ith_S(solverData.cvode.abstol, k) = relativeTolerance*states_nominal[j][i];
+      }
+
+  int flag = CVodeReInit(solverData.cvode.mem, time, solverData.cvode.y);
+  if (flag < 0) return logError("SUNDIALS_ERROR: CVodeReInit() failed with flag = " + std::to_string(flag));
+
+  flag = CVodeSVtolerances(solverData.cvode.mem, relativeTolerance, solverData.cvode.abstol);
+  if (flag < 0) return logError("SUNDIALS_ERROR: CVodeSVtolerances() failed with flag = " + std::to_string(flag));
+
+  // the step size settings may have been changed since the last run
+  flag = CVodeSetMaxStep(solverData.cvode.mem, maximumStepSize);
+  if (flag < 0) logError("SUNDIALS_ERROR: CVodeSetMaxStep() failed with flag = " + std::to_string(flag));
+  flag = CVodeSetInitStep(solverData.cvode.mem, initialStepSize);
+  if (flag < 0) logError("SUNDIALS_ERROR: CVodeSetInitStep() failed with flag = " + std::to_string(flag));
+  flag = CVodeSetMinStep(solverData.cvode.mem, minimumStepSize);
+  if (flag < 0) logError("SUNDIALS_ERROR: CVodeSetMinStep() failed with flag = " + std::to_string(flag));
+
+  if (oms_status_ok != initializeEventRouting())
+    return oms_status_error;
+
+  if (coupledRHS && oms_status_ok != initializeRHSConnections())
+    return oms_status_error;
+
+  return oms_status_ok;
+}
+
+/**
+ * @brief Frees the CVODE memory, the linear solver and the Jacobian.
+ */
+void oms::SystemSC::freeCVODE()
+{
+  if (!solverData.cvode.mem)
+    return;
+
+  SUNMatDestroy(solverData.cvode.J);
+  N_VDestroy_Serial(solverData.cvode.liny);
+  SUNLinSolFree(solverData.cvode.linSol);
+  N_VDestroy_Serial(solverData.cvode.y);
+  N_VDestroy_Serial(solverData.cvode.abstol);
+  CVodeFree(&(solverData.cvode.mem));
+  solverData.cvode.mem = NULL;
+  sparsityPattern.clear();
+  jacobianBlocks.clear();
+}
+
 oms_status_enu_t oms::SystemSC::terminate()
 {
   for (const auto& subsystem : getSubSystems())
@@ -452,15 +696,30 @@ oms_status_enu_t oms::SystemSC::terminate()
     msg += "NumNonlinSolvIters = " + std::to_string(nni) + " NumNonlinSolvConvFails = " + std::to_string(ncfn) + " NumErrTestFails = " + std::to_string(netf);
     logInfo(msg);
 
-    SUNMatDestroy(solverData.cvode.J);
-    N_VDestroy_Serial(solverData.cvode.liny);
-    SUNLinSolFree(solverData.cvode.linSol);
-    N_VDestroy_Serial(solverData.cvode.y);
-    N_VDestroy_Serial(solverData.cvode.abstol);
-    CVodeFree(&(solverData.cvode.mem));
-    solverData.cvode.mem = NULL;
+    rhsConnections.clear();
+    eventSuccessors.clear();
+    eventFMUs.clear();
+    rootsFound.clear();
+    states_der_event.clear();
+  }
+  else if (oms_solver_sc_dopri5 == solverMethod && solverDataDOPRI5.active)
+  {
+    const SolverDataDOPRI5_t& rk = solverDataDOPRI5;
+    std::string msg = "Final Statistics for '" + std::string(getFullCref()) + "':\n";
+    msg += "NumSteps = " + std::to_string(rk.nSteps) + " NumRhsEvals  = " + std::to_string(rk.nRhsEvals) + " NumRejectedSteps = " + std::to_string(rk.nRejectedSteps) + " NumEvents = " + std::to_string(rk.nEvents);
+    logInfo(msg);
+
+    solverDataDOPRI5.active = false;
+    rhsConnections.clear();
+    eventSuccessors.clear();
+    eventFMUs.clear();
+    rootsFound.clear();
+    states_der_event.clear();
   }
 
+  // reset() keeps the CVODE memory, also if the solver is changed afterwards
+  freeCVODE();
+
   for (size_t i=0; i<fmus.size(); ++i)
   {
     free(states[i]);
@@ -475,6 +734,8 @@ oms_status_enu_t oms::SystemSC::terminate()
   terminateSimulation.clear();
   nStates.clear();
   nEventIndicators.clear();
+  stateOffsets.clear();
+  eventIndicatorOffsets.clear();
   states.clear();
   states_der.clear();
   states_nominal.clear();
@@ -519,13 +780,27 @@ oms_status_enu_t oms::SystemSC::reset()
     msg += "NumNonlinSolvIters = " + std::to_string(nni) + " NumNonlinSolvConvFails = " + std::to_string(ncfn) + " NumErrTestFails = " + std::to_string(netf);
     logInfo(msg);
 
-    SUNMatDestroy(solverData.cvode.J);
-    N_VDestroy_Serial(solverData.cvode.liny);
-    SUNLinSolFree(solverData.cvode.linSol);
-    N_VDestroy_Serial(solverData.cvode.y);
-    N_VDestroy_Serial(solverData.cvode.abstol);
-    CVodeFree(&(solverData.cvode.mem));
-    solverData.cvode.mem = nullptr;
+    // the solver memory, the linear solver and the Jacobian structure are
+    // kept for the next run, see initialize(); terminate() frees them
+    rhsConnections.clear();
+    eventSuccessors.clear();
+    eventFMUs.clear();
+    rootsFound.clear();
+    states_der_event.clear();
+  }
+  else if (oms_solver_sc_dopri5 == solverMethod && solverDataDOPRI5.active)
+  {
+    const SolverDataDOPRI5_t& rk = solverDataDOPRI5;
+    std::string msg = "Final Statistics for '" + std::string(getFullCref()) + "':\n";
+    msg += "NumSteps = " + std::to_string(rk.nSteps) + " NumRhsEvals  = " + std::to_string(rk.nRhsEvals) + " NumRejectedSteps = " + std::to_string(rk.nRejectedSteps) + " NumEvents = " + std::to_string(rk.nEvents);
+    logInfo(msg);
+
+    solverDataDOPRI5.active = false;
+    rhsConnections.clear();
+    eventSuccessors.clear();
+    eventFMUs.clear();
+    rootsFound.clear();
+    states_der_event.clear();
   }
 
   return oms_status_ok;
@@ -541,6 +816,9 @@ oms_status_enu_t oms::SystemSC::doStep()
     case oms_solver_sc_cvode:
       return doStepCVODE();
 
+    case oms_solver_sc_dopri5:
+      return doStepDOPRI5();
+
     default:
       return logError_InternalError;
   }
@@ -548,7 +826,6 @@ oms_status_enu_t oms::SystemSC::doStep()
 
 oms_status_enu_t oms::SystemSC::doStepEuler()
 {
-  fmi2Status fmistatus;
   oms_status_enu_t status;
 
   // Step 1: Initialize state variables and time
@@ -583,8 +860,7 @@ oms_status_enu_t oms::SystemSC::doStepEuler()
       status = fmus[i]->getDerivatives(states_der_backup[i]);
       if (oms_status_ok != status) return status;
     }
-    fmistatus = fmi2_getEventIndicators(fmus[i]->getFMU(), event_indicators_prev[i], nEventIndicators[i]);
-    if (fmi2OK != fmistatus) logError_FMUCall("fmi2_getEventIndicators", fmus[i]);
+    fmus[i]->getEventindicators(event_indicators_prev[i]);
   }
 
   fmi2Real step_size_adjustment = maximumStepSize;
@@ -634,8 +910,7 @@ oms_status_enu_t oms::SystemSC::doStepEuler()
     logDebug("Event detected: " + std::to_string(event_detected));
     for (size_t i = 0; i < fmus.size() && !event_detected; ++i)
     {
-      fmistatus = fmi2_getEventIndicators(fmus[i]->getFMU(), event_indicators[i], nEventIndicators[i]);
-      if (fmi2OK != fmistatus) logError_FMUCall("fmi2_getEventIndicators", fmus[i]);
+      fmus[i]->getEventindicators(event_indicators[i]);
 
       for (size_t k=0; k < nEventIndicators[i]; k++)
       {
@@ -665,8 +940,8 @@ oms_status_enu_t oms::SystemSC::doStepEuler()
 
         for (size_t i = 0; i < fmus.size(); ++i)
         {
-          fmistatus = fmi2_completedIntegratorStep(fmus[i]->getFMU(), fmi2True, &callEventUpdate[i], &terminateSimulation[i]);
-          if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_completedIntegratorStep", fmus[i]);
+          status = fmus[i]->completedIntegratorStep(callEventUpdate[i], terminateSimulation[i]);
+          if (oms_status_ok != status) return status;
         }
 
         // emit the left limit of the event (if it hasn't already been emitted)
@@ -705,16 +980,14 @@ oms_status_enu_t oms::SystemSC::doStepEuler()
         // Enter event mode and handle discrete state updates for each FMU
         for (size_t i = 0; i < fmus.size(); ++i)
         {
-          fmistatus = fmi2_completedIntegratorStep(fmus[i]->getFMU(), fmi2True, &callEventUpdate[i], &terminateSimulation[i]);
-          if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_completedIntegratorStep", fmus[i]);
+          status = fmus[i]->completedIntegratorStep(callEventUpdate[i], terminateSimulation[i]);
+          if (oms_status_ok != status) return status;
 
-          fmistatus = fmi2_enterEventMode(fmus[i]->getFMU());
-          if (fmi2OK != fmistatus) logError_FMUCall("fmi2_enterEventMode", fmus[i]);
+          fmus[i]->enterEventMode();
 
           fmus[i]->doEventIteration();
 
-          fmistatus = fmi2_enterContinuousTimeMode(fmus[i]->getFMU());
-          if (fmi2OK != fmistatus) logError_FMUCall("fmi2_enterContinuousTimeMode", fmus[i]);
+          fmus[i]->enterContinuousTimeMode();
 
           if (nStates[i] > 0)
           {
@@ -770,7 +1043,6 @@ oms_status_enu_t oms::SystemSC::doStepEuler()
 
 oms_status_enu_t oms::SystemSC::doStepCVODE()
 {
-  fmi2Status fmistatus;
   oms_status_enu_t status;
   int flag;
 
@@ -813,76 +1085,23 @@ oms_status_enu_t oms::SystemSC::doStepCVODE()
 
     if (flag == CV_ROOT_RETURN || time == tnext)
     {
-      logDebug("event found!!! " + std::to_string(time));
-
-      // set time
-      for (const auto& component : getComponents())
-        component.second->setTime(time);
-
-      for (size_t i = 0; i < fmus.size(); ++i)
-      {
-        fmistatus = fmi2_completedIntegratorStep(fmus[i]->getFMU(), fmi2True, &callEventUpdate[i], &terminateSimulation[i]);
-        if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_completedIntegratorStep", fmus[i]);
-      }
-
-      // emit the left limit of the event (if it hasn't already been emitted)
-      if (isTopLevelSystem())
-        getModel().emit(time, false);
-
-      // Enter event mode and handle discrete state updates for each FMU
-      for (size_t i = 0; i < fmus.size(); ++i)
-      {
-        fmistatus = fmi2_enterEventMode(fmus[i]->getFMU());
-        if (fmi2OK != fmistatus) logError_FMUCall("fmi2_enterEventMode", fmus[i]);
-
-        fmus[i]->doEventIteration();
-      }
-
-      updateInputs(eventGraph);
-
-      for (size_t i = 0; i < fmus.size(); ++i)
-      {
-        fmistatus = fmi2_enterContinuousTimeMode(fmus[i]->getFMU());
-        if (fmi2OK != fmistatus) logError_FMUCall("fmi2_enterContinuousTimeMode", fmus[i]);
-      }
-
-      for (size_t i = 0; i < fmus.size(); ++i)
-      {
-        if (0 == nStates[i])
-          continue;
-
-        status = fmus[i]->getContinuousStates(states[i]);
-        if (oms_status_ok != status) return status;
-      }
-
-      // find next time event
-      tnext = end_time+1.0;
-      for (size_t i = 0; i < fmus.size(); ++i)
+      if (flag == CV_ROOT_RETURN)
       {
-        if (fmus[i]->getEventInfo()->nextEventTimeDefined && (tnext > fmus[i]->getEventInfo()->nextEventTime))
-          tnext = fmus[i]->getEventInfo()->nextEventTime;
-
-        if(fmus[i]->getEventInfo()->terminateSimulation)
-        {
-          logInfo("Simulation terminated by FMU " + std::string(fmus[i]->getFullCref()) + " at time " + std::to_string(time));
-          getModel().setStopTime(time);
-          time = end_time;
-        }
+        flag = CVodeGetRootInfo(solverData.cvode.mem, rootsFound.data());
+        if (flag < 0) return logError("SUNDIALS_ERROR: CVodeGetRootInfo() failed with flag = " + std::to_string(flag));
       }
-      logDebug("tnext: " + std::to_string(tnext));
+      else
+        std::fill(rootsFound.begin(), rootsFound.end(), 0);
 
-      // emit the right limit of the event
-      updateInputs(eventGraph);
-      if (isTopLevelSystem())
-        getModel().emit(time, true);
+      // CVODE only needs to be restarted if the states or the state derivatives changed
+      bool restart = true;
+      status = handleEvent(end_time, tnext, NV_DATA_S(solverData.cvode.y), restart);
+      if (oms_status_ok != status) return status;
 
-      for (size_t i = 0; i < fmus.size(); ++i)
+      if (!restart)
       {
-        if (0 == nStates[i])
-          continue;
-
-        status = fmus[i]->getContinuousStates(states[i]);
-        if (oms_status_ok != status) return status;
+        logDebug("state-preserving event at time " + std::to_string(time) + ", CVODE continues without reinitialization");
+        continue;
       }
 
       for (size_t j=0, k=0; j < fmus.size(); ++j)
@@ -905,8 +1124,8 @@ oms_status_enu_t oms::SystemSC::doStepCVODE()
 
       for (size_t i = 0; i < fmus.size(); ++i)
       {
-        fmistatus = fmi2_completedIntegratorStep(fmus[i]->getFMU(), fmi2True, &callEventUpdate[i], &terminateSimulation[i]);
-        if (fmi2OK != fmistatus) return logError_FMUCall("fmi2_completedIntegratorStep", fmus[i]);
+        status = fmus[i]->completedIntegratorStep(callEventUpdate[i], terminateSimulation[i]);
+        if (oms_status_ok != status) return status;
 
         if (0 == nStates[i])
           continue;
@@ -927,30 +1146,923 @@ oms_status_enu_t oms::SystemSC::doStepCVODE()
 
 }
 
-oms_status_enu_t oms::SystemSC::stepUntil(double stopTime)
+oms_status_enu_t oms::SystemSC::doStepDOPRI5()
 {
-  CallClock callClock(clock);
-  const double startTime=time;
+  oms_status_enu_t status;
+  SolverDataDOPRI5_t& rk = solverDataDOPRI5;
+  const size_t n = rk.y.size();
+  double* k = rk.k.data();
 
-  if (Flags::ProgressBar())
-    logInfo("step SC system [" + std::to_string(startTime) + "; " + std::to_string(stopTime) + "] with step size [" + std::to_string(initialStepSize) + "; " + std::to_string(minimumStepSize) + "; " + std::to_string(maximumStepSize) + "]");
+  const fmi2Real end_time = std::min(time + maximumStepSize, getModel().getStopTime());
 
-  // main simulation loop
-  oms_status_enu_t status = oms_status_ok;
-  while (time < std::min(stopTime, getModel().getStopTime()) && oms_status_ok == status)
+  // the states and inputs might have been changed since the last step
+  for (size_t i = 0; i < fmus.size(); ++i)
   {
-    status = doStep();
-    if (status != oms_status_ok)
-      logWarning("Bad return code at time " + std::to_string(time));
+    if (0 == nStates[i])
+      continue;
 
-    if (isTopLevelSystem() && Flags::ProgressBar())
-      Log::ProgressBar(startTime, stopTime, time);
+    status = fmus[i]->getContinuousStates(rk.y.data() + stateOffsets[i]);
+    if (oms_status_ok != status) return status;
   }
+  rk.fsal = false;
 
-  if (isTopLevelSystem() && Flags::ProgressBar())
-    Log::TerminateBar();
+  // find next time event
+  fmi2Real tnext = end_time+1.0;
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    if (fmus[i]->getEventInfo()->nextEventTimeDefined && (tnext > fmus[i]->getEventInfo()->nextEventTime))
+      tnext = fmus[i]->getEventInfo()->nextEventTime;
 
-  return status;
+    if(fmus[i]->getEventInfo()->terminateSimulation)
+    {
+      logInfo("Simulation terminated by FMU " + std::string(fmus[i]->getFullCref()) + " at time " + std::to_string(time));
+      getModel().setStopTime(time);
+      time = end_time;
+    }
+  }
+
+  int nNaN = 0; // consecutive steps with an error norm that isn't a number
+  while (time < end_time)
+  {
+    if (!rk.fsal)
+    {
+      status = evaluateRHS(time, rk.y.data(), k);
+      if (oms_status_ok != status) return status;
+      status = evaluateEventIndicators(time, rk.y.data(), rk.g.data());
+      if (oms_status_ok != status) return status;
+      rk.nRhsEvals++;
+      rk.fsal = true;
+    }
+
+    // the step is stretched by up to 10% to hit the next event or communication point
+    const fmi2Real t_end = std::min(tnext, end_time);
+    const bool last = time + 1.1*rk.h >= t_end;
+    const double h = last ? t_end - time : rk.h;
+    const fmi2Real t_new = last ? t_end : time + h;
+
+    // stages 2 to 7; the last stage is evaluated at the new states and reused as first stage of the next step
+    for (size_t s = 1; s < 7; ++s)
+    {
+      double* ystage = (6 == s) ? rk.ynew.data() : rk.ytmp.data();
+      for (size_t j = 0; j < n; ++j)
+      {
+        double sum = 0.0;
+        for (size_t l = 0; l < s; ++l)
+          sum += dopri5_a[s][l]*k[l*n + j];
+        ystage[j] = rk.y[j] + h*sum;
+      }
+
+      status = evaluateRHS((6 == s) ? t_new : time + dopri5_c[s]*h, ystage, k + s*n);
+      if (oms_status_ok != status) return status;
+    }
+    rk.nRhsEvals += 6;
+
+    // error estimate, weighted like the CVODE tolerances
+    double err = 0.0;
+    for (size_t j = 0; j < n; ++j)
+    {
+      double e = 0.0;
+      for (size_t s = 0; s < 7; ++s)
+        e += dopri5_e[s]*k[s*n + j];
+      e *= h/(rk.abstol[j] + relativeTolerance*std::max(std::fabs(rk.y[j]), std::fabs(rk.ynew[j])));
+      err += e*e;
+    }
+    err = n > 0 ? std::sqrt(err/n) : 0.0;
+
+    // a NaN error norm is rejected, too
+    if (!(err <= 1.0))
+    {
+      if (std::isnan(err) && ++nNaN > 10)
+        return logError("DOPRI5: the error estimate at time " + std::to_string(time) + " is not a number for '" + std::string(getFullCref()) + "'");
+
+      rk.nRejectedSteps++;
+      rk.h = std::isnan(err) ? 0.2*h : h*std::max(0.2, 0.9*std::pow(err, -0.2));
+      if (rk.h < minimumStepSize)
+        return logError("DOPRI5: step size " + std::to_string(rk.h) + " at time " + std::to_string(time) + " is below the minimum step size for '" + std::string(getFullCref()) + "'");
+      continue;
+    }
+
+    nNaN = 0;
+    rk.nSteps++;
+    rk.errorNorm = err;
+    const double fac = err > 0.0 ? std::min(5.0, std::max(0.2, 0.9*std::pow(err, -0.2))) : 5.0;
+    rk.h = std::min(last ? std::max(rk.h, h*fac) : h*fac, maximumStepSize);
+
+    // state events are located by bisection on the dense output
+    status = evaluateEventIndicators(t_new, rk.ynew.data(), rk.gnew.data());
+    if (oms_status_ok != status) return status;
+
+    if (signChanged(rk.g, rk.gnew))
+    {
+      double lo = 0.0, hi = 1.0;
+      while ((hi - lo)*h > minimumStepSize)
+      {
+        const double mid = 0.5*(lo + hi);
+        dopri5_dense(n, mid, h, rk.y.data(), rk.ynew.data(), k, rk.ytmp.data());
+        status = evaluateEventIndicators(time + mid*h, rk.ytmp.data(), rk.gnew.data());
+        if (oms_status_ok != status) return status;
+
+        if (signChanged(rk.g, rk.gnew))
+          hi = mid;
+        else
+          lo = mid;
+      }
+
+      // the event is handled at the right end of the bracket
+      dopri5_dense(n, hi, h, rk.y.data(), rk.ynew.data(), k, rk.ytmp.data());
+      time = (1.0 == hi) ? t_new : time + hi*h;
+      status = evaluateEventIndicators(time, rk.ytmp.data(), rk.gnew.data());
+      if (oms_status_ok != status) return status;
+
+      for (size_t l = 0; l < rk.g.size(); ++l)
+        rootsFound[l] = (rk.g[l] > 0) != (rk.gnew[l] > 0) ? 1 : 0;
+      std::swap(rk.y, rk.ytmp);
+
+      bool restart = true;
+      status = handleEvent(end_time, tnext, rk.y.data(), restart);
+      if (oms_status_ok != status) return status;
+
+      for (size_t j=0, l=0; j < fmus.size(); ++j)
+        for (size_t i=0; i < nStates[j]; ++i, ++l)
+          rk.y[l] = states[j][i];
+
+      rk.nEvents++;
+      rk.fsal = false;
+      continue;
+    }
+
+    time = t_new;
+    std::swap(rk.y, rk.ynew);
+    std::swap(rk.g, rk.gnew);
+    std::copy(k + 6*n, k + 7*n, k);
+
+    if (time == tnext)
+    {
+      std::fill(rootsFound.begin(), rootsFound.end(), 0);
+
+      bool restart = true;
+      status = handleEvent(end_time, tnext, rk.y.data(), restart);
+      if (oms_status_ok != status) return status;
+
+      for (size_t j=0, l=0; j < fmus.size(); ++j)
+        for (size_t i=0; i < nStates[j]; ++i, ++l)
+          rk.y[l] = states[j][i];
+
+      rk.nEvents++;
+      rk.fsal = false;
+      continue;
+    }
+
+    for (size_t i = 0; i < fmus.size(); ++i)
+    {
+      status = fmus[i]->completedIntegratorStep(callEventUpdate[i], terminateSimulation[i]);
+      if (oms_status_ok != status) return status;
+    }
+  }
+
+  // set time
+  for (const auto& component : getComponents())
+    component.second->setTime(time);
+
+  updateInputs(simulationGraph);
+  if (isTopLevelSystem())
+    getModel().emit(time, false);
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemSC::handleEvent(fmi2Real end_time, fmi2Real& tnext, const realtype* y, bool& restart)
+{
+  oms_status_enu_t status;
+
+  logDebug("event found!!! " + std::to_string(time));
+
+  // set time
+  for (const auto& component : getComponents())
+    component.second->setTime(time);
+
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    status = fmus[i]->completedIntegratorStep(callEventUpdate[i], terminateSimulation[i]);
+    if (oms_status_ok != status) return status;
+  }
+
+  // only the FMUs with an event and the FMUs depending on them via discrete signals enter event mode
+  updateEventFMUs();
+
+  // emit the left limit of the event (if it hasn't already been emitted)
+  if (isTopLevelSystem())
+    getModel().emit(time, false);
+
+  // derivatives of the left limit, to detect events that preserve the states and their derivatives
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    if (0 == nStates[i])
+      continue;
+
+    status = fmus[i]->getDerivatives(states_der[i]);
+    if (oms_status_ok != status) return status;
+  }
+
+  // Enter event mode and handle discrete state updates for each FMU
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    if (!eventFMUs[i])
+      continue;
+
+    fmus[i]->enterEventMode();
+
+    fmus[i]->doEventIteration();
+  }
+
+  updateInputs(eventGraph);
+
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    if (!eventFMUs[i])
+      continue;
+
+    fmus[i]->enterContinuousTimeMode();
+  }
+
+  // find next time event
+  tnext = end_time+1.0;
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    if (fmus[i]->getEventInfo()->nextEventTimeDefined && (tnext > fmus[i]->getEventInfo()->nextEventTime))
+      tnext = fmus[i]->getEventInfo()->nextEventTime;
+
+    if(fmus[i]->getEventInfo()->terminateSimulation)
+    {
+      logInfo("Simulation terminated by FMU " + std::string(fmus[i]->getFullCref()) + " at time " + std::to_string(time));
+      getModel().setStopTime(time);
+      time = end_time;
+    }
+  }
+  logDebug("tnext: " + std::to_string(tnext));
+
+  // emit the right limit of the event
+  updateInputs(eventGraph);
+  if (isTopLevelSystem())
+    getModel().emit(time, true);
+
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    if (0 == nStates[i])
+      continue;
+
+    status = fmus[i]->getContinuousStates(states[i]);
+    if (oms_status_ok != status) return status;
+  }
+
+  // the integrator only needs to be restarted if the states or the state derivatives changed
+  restart = false;
+  for (size_t i = 0; i < fmus.size() && !restart; ++i)
+  {
+    if (0 == nStates[i])
+      continue;
+
+    for (size_t k = 0; k < nStates[i] && !restart; ++k)
+      restart = states[i][k] != y[stateOffsets[i] + k];
+
+    status = fmus[i]->getDerivatives(states_der_event.data());
+    if (oms_status_ok != status) return status;
+
+    for (size_t k = 0; k < nStates[i] && !restart; ++k)
+      restart = states_der[i][k] != states_der_event[k];
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemSC::registerSignalsForResultFile(ResultWriter& resultFile)
+{
+  if (oms_solver_sc_dopri5 == solverMethod && Flags::SolverStats())
+  {
+    h_id = resultFile.addSignal(std::string(getFullCref() + ComRef("$h")), "Step-size h [s]", SignalType_REAL);
+    rejected_id = resultFile.addSignal(std::string(getFullCref() + ComRef("$rejectedSteps")), "Number of rejected steps", SignalType_INT);
+    error_id = resultFile.addSignal(std::string(getFullCref() + ComRef("$errorNorm")), "Normalized error of the last step", SignalType_REAL);
+  }
+  else
+  {
+    h_id = 0;
+    rejected_id = 0;
+    error_id = 0;
+  }
+
+  return System::registerSignalsForResultFile(resultFile);
+}
+
+oms_status_enu_t oms::SystemSC::updateSignals(ResultWriter& resultFile)
+{
+  if (h_id)
+  {
+    SignalValue_t stepS;
+    stepS.realValue = solverDataDOPRI5.h;
+    resultFile.updateSignal(h_id, stepS);
+    SignalValue_t rejected;
+    rejected.intValue = static_cast<int>(solverDataDOPRI5.nRejectedSteps);
+    resultFile.updateSignal(rejected_id, rejected);
+    SignalValue_t errNorm;
+    errNorm.realValue = solverDataDOPRI5.errorNorm;
+    resultFile.updateSignal(error_id, errNorm);
+  }
+
+  return System::updateSignals(resultFile);
+}
+
+oms_status_enu_t oms::SystemSC::stepUntil(double stopTime)
+{
+  CallClock callClock(clock);
+  const double startTime=time;
+
+  if (Flags::ProgressBar())
+    logInfo("step SC system [" + std::to_string(startTime) + "; " + std::to_string(stopTime) + "] with step size [" + std::to_string(initialStepSize) + "; " + std::to_string(minimumStepSize) + "; " + std::to_string(maximumStepSize) + "]");
+
+  // main simulation loop
+  oms_status_enu_t status = oms_status_ok;
+  while (time < std::min(stopTime, getModel().getStopTime()) && oms_status_ok == status)
+  {
+    status = doStep();
+    if (status != oms_status_ok)
+      logWarning("Bad return code at time " + std::to_string(time));
+
+    if (isTopLevelSystem() && oms_status_ok == status)
+      status = getModel().checkpoint(time);
+
+    if (isTopLevelSystem() && Flags::ProgressBar())
+      Log::ProgressBar(startTime, stopTime, time);
+  }
+
+  if (isTopLevelSystem() && Flags::ProgressBar())
+    Log::TerminateBar();
+
+  return status;
+}
+
+oms_status_enu_t oms::SystemSC::serializeSolverState(Checkpoint& checkpoint)
+{
+  checkpoint.writeValue(solverDataDOPRI5.h);
+  return oms_status_ok;
+}
+
+/**
+ * @brief Restarts the solver from the states of the deserialized FMUs.
+ */
+oms_status_enu_t oms::SystemSC::deserializeSolverState(Checkpoint& checkpoint)
+{
+  oms_status_enu_t status;
+  double h;
+  if (!checkpoint.readValue(h))
+    return logError("Checkpoint doesn't match the solver state of system " + std::string(getFullCref()));
+
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    if (nStates[i] > 0)
+    {
+      status = fmus[i]->getContinuousStates(states[i]);
+      if (oms_status_ok != status) return status;
+    }
+    if (nEventIndicators[i] > 0)
+    {
+      status = fmus[i]->getEventindicators(event_indicators[i]);
+      if (oms_status_ok != status) return status;
+    }
+  }
+
+  if (oms_solver_sc_cvode == solverMethod)
+  {
+    if (!algebraic)
+      for (size_t j=0, k=0; j < fmus.size(); ++j)
+        for (size_t i=0; i < nStates[j]; ++i, ++k)
+          NV_Ith_S(solverData.cvode.y, k) = states[j][i];
+
+    int flag = CVodeReInit(solverData.cvode.mem, time, solverData.cvode.y);
+    if (flag < 0) return logError("SUNDIALS_ERROR: CVodeReInit() failed with flag = " + std::to_string(flag));
+  }
+  else if (oms_solver_sc_dopri5 == solverMethod)
+  {
+    // the states are read back from the FMUs at the beginning of each step
+    solverDataDOPRI5.h = h;
+    solverDataDOPRI5.fsal = false;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemSC::initializeEventRouting()
+{
+  std::map<ComRef, size_t> fmuIndices;
+  size_t maxStates = 0;
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    fmuIndices[fmus[i]->getCref()] = i;
+    maxStates = std::max(maxStates, nStates[i]);
+  }
+
+  // an event of an FMU also has to be handled by the FMUs that receive discrete signals from it
+  eventSuccessors.assign(fmus.size(), std::vector<size_t>());
+  const std::vector<Connector>& nodes = eventGraph.getNodes();
+  for (const auto& edge : eventGraph.getEdges().connections)
+  {
+    ComRef output(nodes[edge.first].getName());
+    ComRef input(nodes[edge.second].getName());
+    auto source = fmuIndices.find(output.pop_front());
+    auto target = fmuIndices.find(input.pop_front());
+    if (source == fmuIndices.end() || target == fmuIndices.end() || source->second == target->second)
+      continue;
+
+    if (nodes[edge.second].getType() == oms_signal_type_real)
+    {
+      Variable* var = fmus[target->second]->getVariable(input);
+      if (!var)
+        return oms_status_error;
+      if (var->isContinuous())
+        continue;
+    }
+
+    eventSuccessors[source->second].push_back(target->second);
+  }
+
+  eventFMUs.assign(fmus.size(), true);
+  rootsFound.assign(eventIndicatorOffsets.back(), 0);
+  states_der_event.assign(maxStates, 0.0);
+
+  return oms_status_ok;
+}
+
+void oms::SystemSC::updateEventFMUs()
+{
+  std::vector<size_t> stack;
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    const fmi2EventInfo* eventInfo = fmus[i]->getEventInfo();
+    bool event = callEventUpdate[i] || (eventInfo->nextEventTimeDefined && eventInfo->nextEventTime <= time);
+    for (size_t k = eventIndicatorOffsets[i]; k < eventIndicatorOffsets[i + 1] && !event; ++k)
+      event = 0 != rootsFound[k];
+
+    eventFMUs[i] = event;
+    if (event)
+      stack.push_back(i);
+  }
+
+  // an event without any cause is handled by all FMUs
+  if (stack.empty())
+  {
+    std::fill(eventFMUs.begin(), eventFMUs.end(), true);
+    return;
+  }
+
+  while (!stack.empty())
+  {
+    size_t i = stack.back();
+    stack.pop_back();
+    for (size_t j : eventSuccessors[i])
+    {
+      if (!eventFMUs[j])
+      {
+        eventFMUs[j] = true;
+        stack.push_back(j);
+      }
+    }
+  }
+}
+
+oms_status_enu_t oms::SystemSC::updateStates(realtype t, realtype* y)
+{
+  oms_status_enu_t status;
+
+  // the FMUs read their states in place from y
+  for (size_t i=0; i < fmus.size(); ++i)
+  {
+    fmus[i]->setTime(t);
+
+    if (0 == nStates[i])
+      continue;
+
+    status = fmus[i]->setContinuousStates(y + stateOffsets[i]);
+    if (oms_status_ok != status) return status;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemSC::evaluateRHS(realtype t, realtype* y, realtype* ydot)
+{
+  oms_status_enu_t status;
+
+  // update states in FMUs
+  status = updateStates(t, y);
+  if (oms_status_ok != status) return status;
+
+  // update inputs of strongly coupled FMUs
+  if (coupledRHS)
+  {
+    status = updateRHSInputs();
+    if (oms_status_ok != status) return status;
+  }
+
+  // get state derivatives, written directly into ydot
+  for (size_t i=0; i < fmus.size(); ++i)
+  {
+    if (0 == nStates[i])
+      continue;
+
+    status = fmus[i]->getDerivatives(ydot + stateOffsets[i]);
+    if (oms_status_ok != status) return status;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemSC::evaluateEventIndicators(realtype t, realtype* y, realtype* g)
+{
+  oms_status_enu_t status;
+
+  status = updateStates(t, y);
+  if (oms_status_ok != status) return status;
+
+  if (coupledRHS)
+  {
+    status = updateRHSInputs();
+    if (oms_status_ok != status) return status;
+  }
+
+  for (size_t i=0; i < fmus.size(); ++i)
+  {
+    if (0 == nEventIndicators[i])
+      continue;
+
+    status = fmus[i]->getEventindicators(g + eventIndicatorOffsets[i]);
+    if (oms_status_ok != status) return status;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemSC::initializeRHSConnections()
+{
+  rhsConnections.clear();
+
+  // resolves the FMU and the prepared signal of a variable; NULL if it doesn't belong to an FMU
+  auto getFMUVariable = [&](const ComRef& name, int& index) -> Component*
+  {
+    ComRef signal(name);
+    ComRef head = signal.pop_front();
+    auto component = getComponents().find(head);
+    if (component == getComponents().end())
+      return NULL;
+    if (component->second->getType() != oms_component_fmu && component->second->getType() != oms_component_fmu3)
+      return NULL;
+
+    Component* fmu = component->second;
+    Variable* var = fmu->getVariable(signal);
+    if (!var || oms_status_ok != fmu->prepareRealSignals({signal}, index))
+      return NULL;
+
+    return fmu;
+  };
+
+  int loopNum = 0;
+  for (const scc_t& scc : simulationGraph.getSortedConnections())
+  {
+    RHSConnection_t connection;
+    if (scc.thisIsALoop)
+      connection.loop = loopNum++;
+    else
+    {
+      const Connector& output = simulationGraph.getNodes()[scc.connections[0].first];
+      const Connector& input = simulationGraph.getNodes()[scc.connections[0].second];
+      if (input.getType() != oms_signal_type_real)
+        return logError_InternalError;
+
+      connection.output = output.getName();
+      connection.input = input.getName();
+      if (!scc.suppressUnitConversion)
+        connection.factor = scc.factor;
+
+      connection.source = getFMUVariable(connection.output, connection.signalSource);
+      connection.target = getFMUVariable(connection.input, connection.signalTarget);
+    }
+    rhsConnections.push_back(connection);
+  }
+
+  logInfo("coupled right-hand side for '" + std::string(getFullCref()) + "': " + std::to_string(rhsConnections.size() - loopNum) + " connections, " + std::to_string(loopNum) + " algebraic loops");
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemSC::updateRHSInputs()
+{
+  oms_status_enu_t status;
+
+  // the loops are shared with updateInputs and only rebuilt if they got invalid
+  updateAlgebraicLoops(simulationGraph.getSortedConnections(), simulationGraph);
+
+  for (const RHSConnection_t& connection : rhsConnections)
+  {
+    if (connection.loop >= 0)
+    {
+      status = solveAlgLoop(simulationGraph, connection.loop);
+      if (oms_status_ok != status)
+      {
+        forceLoopsToBeUpdated();
+        return status;
+      }
+      continue;
+    }
+
+    double value = 0.0;
+    if (connection.source)
+      status = connection.source->getRealSignals(connection.signalSource, &value);
+    else
+      status = getReal(connection.output, value);
+    if (oms_status_ok != status) return status;
+
+    value *= connection.factor;
+
+    if (connection.target)
+      status = connection.target->setRealSignals(connection.signalTarget, &value);
+    else
+      status = setReal(connection.input, value);
+    if (oms_status_ok != status) return status;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemSC::updateSparsityPattern()
+{
+  std::vector<int> offsets(fmus.size() + 1, 0);
+  std::map<ComRef, size_t> fmuIndices;
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    offsets[i + 1] = offsets[i] + static_cast<int>(nStates[i]);
+    fmuIndices[fmus[i]->getCref()] = i;
+  }
+
+  // input := output
+  std::map<ComRef, ComRef> sources;
+  for (const auto& connection : getConnections())
+    if (connection && connection->getType() == oms_connection_single)
+      sources[connection->getSignalB()] = connection->getSignalA();
+
+  // States an input depends on through connected outputs, possibly of several FMUs.
+  // Results that are incomplete because of an algebraic loop aren't cached.
+  std::map<ComRef, std::vector<int>> cache;
+  std::set<ComRef> visiting;
+  std::function<bool(const ComRef&, std::vector<int>&)> getInputDependencies = [&](const ComRef& input, std::vector<int>& columns) -> bool
+  {
+    auto cached = cache.find(input);
+    if (cached != cache.end())
+    {
+      columns.insert(columns.end(), cached->second.begin(), cached->second.end());
+      return true;
+    }
+    if (visiting.count(input))
+      return false;
+
+    auto source = sources.find(input);
+    if (source == sources.end())
+      return true;
+
+    ComRef output(source->second);
+    ComRef head = output.pop_front();
+    auto fmu = fmuIndices.find(head);
+    if (fmu == fmuIndices.end())
+      return true;
+
+    std::vector<unsigned int> stateDependencies;
+    std::vector<ComRef> inputDependencies;
+    if (oms_status_ok != fmus[fmu->second]->getOutputDependencies(output, stateDependencies, inputDependencies))
+      return true;
+
+    std::vector<int> result;
+    for (const auto& k : stateDependencies)
+      result.push_back(offsets[fmu->second] + static_cast<int>(k));
+
+    bool complete = true;
+    visiting.insert(input);
+    for (const auto& u : inputDependencies)
+      complete = getInputDependencies(head + u, result) && complete;
+    visiting.erase(input);
+
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    columns.insert(columns.end(), result.begin(), result.end());
+    if (complete)
+      cache[input] = result;
+    return complete;
+  };
+
+  sparsityPattern.resize(offsets.back());
+  roundTrips.assign(fmus.size(), false);
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    for (size_t k = 0; k < nStates[i]; ++k)
+    {
+      const int row = offsets[i] + static_cast<int>(k);
+      std::vector<unsigned int> stateDependencies;
+      std::vector<ComRef> inputDependencies;
+      fmus[i]->getStateDerivativeDependencies(k, stateDependencies, inputDependencies);
+
+      for (const auto& j : stateDependencies)
+        sparsityPattern.addEntry(row, offsets[i] + static_cast<int>(j));
+
+      std::vector<int> columns;
+      for (const auto& u : inputDependencies)
+        getInputDependencies(fmus[i]->getCref() + u, columns);
+      for (const auto& j : columns)
+      {
+        sparsityPattern.addEntry(row, j);
+        if (j >= offsets[i] && j < offsets[i + 1])
+          roundTrips[i] = true;
+      }
+    }
+  }
+  sparsityPattern.compress();
+
+  std::string msg = "sparsity pattern for '" + std::string(getFullCref()) + "': " + std::to_string(sparsityPattern.getSize()) + " states, " + std::to_string(sparsityPattern.getNumberOfNonZeros()) + " non-zeros, " + std::to_string(sparsityPattern.getNumberOfColors()) + " colors";
+  if (Flags::CVODELinearSolver() == "blockdiagonal")
+  {
+    std::vector<int> blocks;
+    const int nBlocks = sparsityPattern.getBlocks(blocks);
+    std::vector<int> blockSizes(nBlocks, 0);
+    for (const auto& b : blocks)
+      blockSizes[b]++;
+    msg += ", " + std::to_string(nBlocks) + " blocks (largest: " + std::to_string(*std::max_element(blockSizes.begin(), blockSizes.end())) + ")";
+  }
+  else
+  {
+    std::vector<int> perm;
+    int mu, ml;
+    sparsityPattern.getReverseCuthillMcKee(perm);
+    sparsityPattern.getBandwidth(perm, mu, ml);
+    msg += ", bandwidth " + std::to_string(mu) + "/" + std::to_string(ml);
+  }
+  logInfo(msg);
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemSC::initializeJacobian()
+{
+  const std::vector<int>& columnPointers = sparsityPattern.getColumnPointers();
+  const std::vector<int>& rowIndices = sparsityPattern.getRowIndices();
+
+  std::vector<int> lower(sparsityPattern.getSize()), upper(sparsityPattern.getSize());
+  size_t nDirectionalDerivatives = 0;
+  size_t nCoupled = 0;
+  jacobianBlocks.clear();
+  jacobianBlocks.resize(fmus.size());
+  for (size_t i = 0, offset = 0; i < fmus.size(); offset += nStates[i], ++i)
+  {
+    JacobianBlock_t& block = jacobianBlocks[i];
+    const int n = static_cast<int>(nStates[i]);
+    block.offset = static_cast<int>(offset);
+    block.pattern.resize(n);
+    block.blockStart.resize(n);
+
+    // With the coupled right-hand side, entries of the block also come from
+    // round trips through other FMUs (output -> input -> output). The FMU
+    // alone can't provide them, so all its columns are coupling columns.
+    block.coupled = Flags::CoupledRHS() && roundTrips[i];
+    if (block.coupled)
+    {
+      for (int j = 0; j < n; ++j)
+      {
+        lower[block.offset + j] = 0;
+        upper[block.offset + j] = 0;
+      }
+      block.pattern.compress();
+      block.directionalDerivatives = false;
+      nCoupled++;
+      continue;
+    }
+
+    // the rows of a block are contiguous in each column, since the row indices are sorted
+    for (int j = 0; j < n; ++j)
+    {
+      const int column = block.offset + j;
+      lower[column] = block.offset;
+      upper[column] = block.offset + n;
+      block.blockStart[j] = -1;
+      for (int k = columnPointers[column]; k < columnPointers[column + 1]; ++k)
+      {
+        if (rowIndices[k] >= block.offset && rowIndices[k] < block.offset + n)
+        {
+          if (block.blockStart[j] < 0)
+            block.blockStart[j] = k;
+          block.pattern.addEntry(rowIndices[k] - block.offset, j);
+        }
+      }
+    }
+    block.pattern.compress();
+
+    block.directionalDerivatives = Flags::DirectionalDerivatives() && fmus[i]->getFMUInfo()->getProvidesDirectionalDerivative();
+    if (block.directionalDerivatives)
+    {
+      block.knownStates.resize(n);
+      block.seed.assign(n, 1.0);
+      block.dvUnknown.resize(n);
+      nDirectionalDerivatives++;
+    }
+  }
+
+  // columns with entries outside the diagonal block of their FMU are evaluated for the whole system
+  const std::vector<int>& colorPointers = sparsityPattern.getColorPointers();
+  const std::vector<int>& columnsByColor = sparsityPattern.getColumnsByColor();
+  couplingColorPointers.assign(1, 0);
+  couplingColumns.clear();
+  couplingEntryPointers.assign(1, 0);
+  couplingEntries.clear();
+  for (int c = 0; c < sparsityPattern.getNumberOfColors(); ++c)
+  {
+    for (int l = colorPointers[c]; l < colorPointers[c + 1]; ++l)
+    {
+      const int j = columnsByColor[l];
+      const size_t first = couplingEntries.size();
+      for (int k = columnPointers[j]; k < columnPointers[j + 1]; ++k)
+        if (rowIndices[k] < lower[j] || rowIndices[k] >= upper[j])
+          couplingEntries.push_back(k);
+
+      if (couplingEntries.size() > first)
+      {
+        couplingColumns.push_back(j);
+        couplingEntryPointers.push_back(static_cast<int>(couplingEntries.size()));
+      }
+    }
+    if (static_cast<int>(couplingColumns.size()) > couplingColorPointers.back())
+      couplingColorPointers.push_back(static_cast<int>(couplingColumns.size()));
+  }
+
+  logInfo("Jacobian for '" + std::string(getFullCref()) + "': directional derivatives for " + std::to_string(nDirectionalDerivatives) + " of " + std::to_string(fmus.size()) + " FMUs, " + std::to_string(nCoupled) + " FMUs with round trips, " + std::to_string(couplingColorPointers.size() - 1) + " colors for the coupling between FMUs");
+
+  return oms_status_ok;
+}
+
+int oms::SystemSC::getJacobianBlock(size_t i, realtype t, const realtype* y, const realtype* fy, realtype* jac)
+{
+  JacobianBlock_t& block = jacobianBlocks[i];
+  const std::vector<int>& columnPointers = block.pattern.getColumnPointers();
+  const std::vector<int>& rowIndices = block.pattern.getRowIndices();
+  const std::vector<int>& colorPointers = block.pattern.getColorPointers();
+  const std::vector<int>& columnsByColor = block.pattern.getColumnsByColor();
+  const realtype* abstol = NV_DATA_S(solverData.cvode.abstol) + block.offset;
+  const realtype srur = std::sqrt(UNIT_ROUNDOFF);
+  oms_status_enu_t status;
+
+  fmus[i]->setTime(t);
+  for (size_t k = 0; k < nStates[i]; ++k)
+    states[i][k] = y[block.offset + k];
+  status = fmus[i]->setContinuousStates(states[i]);
+  if (oms_status_ok != status) return status;
+
+  for (int c = 0; c < block.pattern.getNumberOfColors(); ++c)
+  {
+    if (block.directionalDerivatives)
+    {
+      size_t nKnown = 0;
+      for (int l = colorPointers[c]; l < colorPointers[c + 1]; ++l)
+        block.knownStates[nKnown++] = columnsByColor[l];
+
+      status = fmus[i]->getStateDirectionalDerivative(block.knownStates.data(), nKnown, block.seed.data(), block.dvUnknown.data());
+      if (oms_status_ok != status) return status;
+
+      for (int l = colorPointers[c]; l < colorPointers[c + 1]; ++l)
+      {
+        const int j = columnsByColor[l];
+        for (int k = columnPointers[j]; k < columnPointers[j + 1]; ++k)
+          jac[block.blockStart[j] + k - columnPointers[j]] = block.dvUnknown[rowIndices[k]];
+      }
+    }
+    else
+    {
+      for (int l = colorPointers[c]; l < colorPointers[c + 1]; ++l)
+      {
+        const int j = columnsByColor[l];
+        states[i][j] += srur * std::max(std::fabs(states[i][j]), abstol[j] / relativeTolerance);
+      }
+
+      status = fmus[i]->setContinuousStates(states[i]);
+      if (oms_status_ok != status) return status;
+      status = fmus[i]->getDerivatives(states_der[i]);
+      if (oms_status_ok != status) return status;
+
+      for (int l = colorPointers[c]; l < colorPointers[c + 1]; ++l)
+      {
+        const int j = columnsByColor[l];
+        const realtype inc = states[i][j] - y[block.offset + j];
+        states[i][j] = y[block.offset + j];
+        for (int k = columnPointers[j]; k < columnPointers[j + 1]; ++k)
+          jac[block.blockStart[j] + k - columnPointers[j]] = (states_der[i][rowIndices[k]] - fy[block.offset + rowIndices[k]]) / inc;
+      }
+    }
+  }
+
+  if (!block.directionalDerivatives)
+    return fmus[i]->setContinuousStates(states[i]);
+
+  return 0;
 }
 
 oms_status_enu_t oms::SystemSC::updateInputs(DirectedGraph& graph)
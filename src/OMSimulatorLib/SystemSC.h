@@ -33,6 +33,7 @@
 #define _OMS_SYSTEM_SC_H_
 
 #include "ComRef.h"
+#include "SparsityPattern.h"
 #include "System.h"
 #include "OMSimulator/Types.h"
 
@@ -43,10 +44,10 @@
 namespace oms
 {
   class Model;
-  class ComponentFMUME;
   int cvode_rhs(realtype t, N_Vector y, N_Vector ydot, void* user_data);
   int cvode_rhs_algebraic(realtype t, N_Vector y, N_Vector ydot, void* user_data);
   int cvode_roots(realtype t, N_Vector y, realtype *gout, void* user_data);
+  int cvode_jac(realtype t, N_Vector y, N_Vector fy, SUNMatrix J, void* user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
 
   class SystemSC : public System
   {
@@ -66,6 +67,9 @@ namespace oms
 
     oms_status_enu_t updateInputs(DirectedGraph& graph);
 
+    oms_status_enu_t registerSignalsForResultFile(ResultWriter& resultFile);
+    oms_status_enu_t updateSignals(ResultWriter& resultFile);
+
     std::string getSolverName() const;
     oms_status_enu_t setSolverMethod(std::string);
 
@@ -74,21 +78,43 @@ namespace oms
   private:
     oms_status_enu_t doStepEuler();
     oms_status_enu_t doStepCVODE();
+    oms_status_enu_t doStepDOPRI5();
+    oms_status_enu_t handleEvent(fmi2Real end_time, fmi2Real& tnext, const realtype* y, bool& restart);
+
+    oms_status_enu_t reinitializeCVODE();
+    void freeCVODE();
+    oms_status_enu_t initializeEventRouting();
+    void updateEventFMUs();
+
+    oms_status_enu_t updateStates(realtype t, realtype* y);
+    oms_status_enu_t evaluateRHS(realtype t, realtype* y, realtype* ydot);
+    oms_status_enu_t evaluateEventIndicators(realtype t, realtype* y, realtype* g);
+    oms_status_enu_t initializeRHSConnections();
+    oms_status_enu_t updateRHSInputs();
+
+    oms_status_enu_t updateSparsityPattern();
+    oms_status_enu_t initializeJacobian();
+    int getJacobianBlock(size_t i, realtype t, const realtype* y, const realtype* fy, realtype* jac);
 
   protected:
     SystemSC(const ComRef& cref, Model* parentModel, System* parentSystem);
 
+    oms_status_enu_t serializeSolverState(Checkpoint& checkpoint);
+    oms_status_enu_t deserializeSolverState(Checkpoint& checkpoint);
+
     // stop the compiler generating methods copying the object
     SystemSC(SystemSC const& copy);            ///< not implemented
     SystemSC& operator=(SystemSC const& copy); ///< not implemented
 
   private:
-    std::vector<ComponentFMUME*> fmus;
+    std::vector<Component*> fmus; ///< FMI 2.0 and FMI 3.0 model exchange FMUs
 
     std::vector<fmi2Boolean> callEventUpdate;
     std::vector<fmi2Boolean> terminateSimulation;
     std::vector<size_t> nStates;
     std::vector<size_t> nEventIndicators;
+    std::vector<size_t> stateOffsets;          ///< states of fmus[i] are y[stateOffsets[i]..stateOffsets[i+1]-1]
+    std::vector<size_t> eventIndicatorOffsets; ///< event indicators of fmus[i] start at gout[eventIndicatorOffsets[i]]
 
     std::vector<double*> states;
     std::vector<double*> states_der;
@@ -96,7 +122,59 @@ namespace oms
     std::vector<double*> event_indicators;
     std::vector<double*> event_indicators_prev;
 
+    std::vector<std::vector<size_t>> eventSuccessors; ///< FMUs that receive discrete signals from fmus[i]
+    std::vector<bool> eventFMUs;                       ///< FMUs that enter event mode at the current event
+    std::vector<int> rootsFound;
+    std::vector<double> states_der_event;
+
     bool algebraic = false;
+    bool coupledRHS = false;
+    std::string cvodeLinearSolver; ///< value of --CVODELinearSolver when the CVODE memory was created
+
+    /**
+     * @brief Connection of the simulation graph, evaluated in each right-hand side evaluation.
+     *
+     * The entries follow the sorted connections of the simulation graph,
+     * so that each input is updated before it is used.
+     */
+    struct RHSConnection_t
+    {
+      Component* source = NULL; ///< NULL if the output doesn't belong to an FMU
+      Component* target = NULL; ///< NULL if the input doesn't belong to an FMU
+      int signalSource = -1;    ///< index of prepareRealSignals()
+      int signalTarget = -1;    ///< index of prepareRealSignals()
+      ComRef output;                 ///< only used if source is NULL
+      ComRef input;                  ///< only used if target is NULL
+      double factor = 1.0;
+      int loop = -1;                 ///< number of the algebraic loop or -1
+    };
+    std::vector<RHSConnection_t> rhsConnections;
+
+    SparsityPattern sparsityPattern; ///< structure of the state Jacobian, only used by the sparse CVODE linear solvers
+    std::vector<bool> roundTrips;    ///< derivatives of fmus[i] depend on its own states through other FMUs
+
+    /**
+     * @brief Diagonal block of the state Jacobian that belongs to one FMU.
+     *
+     * The block is evaluated with directional derivatives if the FMU
+     * provides them, otherwise by finite differences of that FMU only.
+     */
+    struct JacobianBlock_t
+    {
+      int offset;                     ///< index of the first state of the FMU
+      SparsityPattern pattern;        ///< local pattern of the block
+      std::vector<int> blockStart;    ///< index of the first block entry of each local column in the global CSC data
+      bool directionalDerivatives;
+      bool coupled;                   ///< evaluated with the coupling columns, see roundTrips
+      std::vector<int> knownStates;   ///< states of the current color
+      std::vector<double> seed;
+      std::vector<double> dvUnknown;
+    };
+    std::vector<JacobianBlock_t> jacobianBlocks;
+    std::vector<int> couplingColorPointers;  ///< columns with entries outside their own FMU, grouped by color
+    std::vector<int> couplingColumns;
+    std::vector<int> couplingEntryPointers;  ///< entries of couplingColumns[l] are couplingEntries[couplingEntryPointers[l]..couplingEntryPointers[l+1]-1]
+    std::vector<int> couplingEntries;
 
     struct SolverDataEuler_t
     {
@@ -118,9 +196,38 @@ namespace oms
       SolverDataCVODE_t cvode;
     } solverData;
 
+    /**
+     * @brief Data of the embedded Dormand-Prince 5(4) method.
+     *
+     * Not part of solverData, since it isn't trivially constructible.
+     */
+    struct SolverDataDOPRI5_t
+    {
+      std::vector<double> y;       ///< states at the current time
+      std::vector<double> ynew;    ///< states at the end of the current step
+      std::vector<double> ytmp;    ///< stage states and dense output
+      std::vector<double> k;       ///< derivatives of stage s are k[s*n..(s+1)*n-1]
+      std::vector<double> abstol;
+      std::vector<double> g;       ///< event indicators at the current time
+      std::vector<double> gnew;    ///< event indicators at the end of the current step
+      double h;                    ///< proposed step size
+      double errorNorm;            ///< error norm of the last accepted step
+      bool fsal;                   ///< k[0..n-1] holds the derivatives at the current time
+      long int nSteps;
+      long int nRejectedSteps;
+      long int nRhsEvals;
+      long int nEvents;
+      bool active = false;         ///< initialized and not yet terminated
+    } solverDataDOPRI5;
+
+    unsigned int h_id = 0;
+    unsigned int rejected_id = 0;
+    unsigned int error_id = 0;
+
     friend int oms::cvode_rhs(realtype t, N_Vector y, N_Vector ydot, void* user_data);
     friend int oms::cvode_rhs_algebraic(realtype t, N_Vector y, N_Vector ydot, void* user_data);
     friend int oms::cvode_roots(realtype t, N_Vector y, realtype *gout, void* user_data);
+    friend int oms::cvode_jac(realtype t, N_Vector y, N_Vector fy, SUNMatrix J, void* user_data, N_Vector tmp1, N_Vector tmp2, N_Vector tmp3);
   };
 }
 
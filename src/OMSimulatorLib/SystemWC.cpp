@@ -40,6 +40,7 @@
 
 #include <future>
 #include <math.h>
+#include <set>
 #include <thread>
 
 oms::SystemWC::SystemWC(const ComRef& cref, Model* parentModel, System* parentSystem)
@@ -229,6 +230,8 @@ oms_status_enu_t oms::SystemWC::initialize()
   clock.reset();
   CallClock callClock(clock);
 
+  lastCommunicationTimes.clear();
+
   if (oms_status_ok != updateDependencyGraphs())
     return oms_status_error;
 
@@ -271,6 +274,19 @@ oms_status_enu_t oms::SystemWC::initialize()
     if (mav_FMUcomponents.size() != 0 && mav_doDoubleStep)
       return logError("The double step approach requires that all the components can rollback their states. At least one component doesn't provide this functionality.");
 
+    mav_aheadComponents.clear();
+    mav_clusters.clear();
+    if (Flags::SelectiveRollback())
+    {
+      updateRollbackClusters();
+
+      // see doStep(), the samples at these communication points are missing in the results
+      if (isTopLevelSystem() && getModel().hasResultFile())
+        logWarning("No results are written while FMUs that weren't rolled back are ahead of the system (--selectiveRollback)");
+    }
+
+    if (!activationRatios.empty())
+      logWarning("System \"" + std::string(getFullCref()) + "\": activation ratios are ignored by solver \"" + getSolverName() + "\"; use solver \"oms-ma\"");
   }
   else if (solverMethod == oms_solver_wc_ma)
   {
@@ -287,6 +303,21 @@ oms_status_enu_t oms::SystemWC::initialize()
     }
     else
       masiMax = 1;
+
+    communicationStopTime = getModel().getStopTime();
+
+    if (!activationRatios.empty())
+    {
+      if (masiMax > 1)
+      {
+        masiMax = 1;
+        logWarning("System \"" + std::string(getFullCref()) + "\": activation ratios are used; an explicit master algorithm will be used instead of --inputExtrapolation");
+      }
+
+      multirateStep = 0;
+      for (const auto& ratio : activationRatios)
+        lastCommunicationTimes[ratio.first] = time;
+    }
   }
   else
     return logError("Invalid solver selected");
@@ -335,6 +366,8 @@ oms_status_enu_t oms::SystemWC::doStep()
     std::vector<double> outputVectEnd;
     std::vector<double> inputVect;
     std::vector<double> outputVect;
+    std::vector<double> nominalVect;
+    std::vector<ComRef> ownerVect;
 
     if (stepSize > maximumStepSize) stepSize = maximumStepSize;
     if (stepSize < minimumStepSize) stepSize = minimumStepSize;
@@ -351,15 +384,25 @@ oms_status_enu_t oms::SystemWC::doStep()
 
     oms_status_enu_t status;
 
-    // Get states of FMUs that can get state
+    // FMUs that are ahead after a selective rollback wait until the system catches up
+    const bool selectiveRollback = Flags::SelectiveRollback() && solverMethod == oms_solver_wc_mav && !mav_clusters.empty();
+    std::map<ComRef, Component*> steppedComponents;
     for (const auto& component : mav_canGetAndSetStateFMUcomponents)
-      component.second->saveState();
+    {
+      auto ahead = mav_aheadComponents.find(component.first);
+      if (ahead == mav_aheadComponents.end() || ahead->second < tNext)
+        steppedComponents.insert(component);
+    }
+
+    // Get states of FMUs that can get state
+    if (oms_status_ok != callComponents(steppedComponents, &Component::saveState))
+      return oms_status_error;
 
     const int howManySteps = mav_doDoubleStep ? 3 : 1;
     for (int whichStepIndex = 0; whichStepIndex < howManySteps; whichStepIndex++)
     {
       // stepUntil for FMUs that can get state
-      for (const auto& component : mav_canGetAndSetStateFMUcomponents)
+      for (const auto& component : steppedComponents)
       {
         status = component.second->stepUntil(tNext);
         if (oms_status_ok != status)
@@ -378,16 +421,14 @@ oms_status_enu_t oms::SystemWC::doStep()
       // get inputs and outputs at the end of all steps.
       if (whichStepIndex == 0)
       {
-        if (oms_status_ok != getInputAndOutput(eventGraph, inputVect, outputVect, mav_canGetAndSetStateFMUcomponents))
+        if (oms_status_ok != getInputAndOutput(eventGraph, inputVect, outputVect, nominalVect, ownerVect, steppedComponents))
           return oms_status_error;
 
         if (mav_doDoubleStep) // Rollback for small steppies.
         {
           // Rollback all FMUs
-          for (const auto& component : mav_canGetAndSetStateFMUcomponents)
-          {
-            component.second->restoreState();
-          }
+          if (oms_status_ok != callComponents(steppedComponents, &Component::restoreState))
+            return oms_status_error;
 
           //Fix time
           time = tNext-stepSize;
@@ -407,7 +448,7 @@ oms_status_enu_t oms::SystemWC::doStep()
       else if (whichStepIndex == 1)
         updateInputs(eventGraph);
       else if (whichStepIndex == 2)
-        if (oms_status_ok != getInputAndOutput(eventGraph, inputVectEnd, outputVectEnd, mav_canGetAndSetStateFMUcomponents))
+        if (oms_status_ok != getInputAndOutput(eventGraph, inputVectEnd, outputVectEnd, nominalVect, ownerVect, steppedComponents))
           return oms_status_error;
     }
     logDebug("DEBUGGING: Lets do Error control");
@@ -420,6 +461,8 @@ oms_status_enu_t oms::SystemWC::doStep()
     double maxChange = 1.5;
     double minChange = 0.5;
     maxError = 0.0;
+    normError = 0.0;
+    std::set<int> rejectedClusters;
     for (int n=0; n < inputVect.size(); n++) // Calculate error in the FMUs we do error_control on.
     {
       double error;
@@ -428,14 +471,17 @@ oms_status_enu_t oms::SystemWC::doStep()
       else
         error = fabs(outputVectEnd[n]-outputVect[n]);
 
-      double absoluteTolerance = relativeTolerance*1.0; //TODO: Use nominal values
-      logDebug("DEBUGGING: Error is:"+std::to_string(error)+" and Scale factor is: "+std::to_string((fabs(outputVect[n])*relativeTolerance+absoluteTolerance)));
+      const double absoluteTolerance = relativeTolerance*nominalVect[n];
+      const double scale = fabs(outputVect[n])*relativeTolerance + absoluteTolerance;
+      logDebug("DEBUGGING: Error is:"+std::to_string(error)+" and Scale factor is: "+std::to_string(scale));
 
-      normError = normError+pow(error/(fabs(outputVect[n])*relativeTolerance+absoluteTolerance),2);
-      if (error/(fabs(outputVect[n])*relativeTolerance+absoluteTolerance) > maxError)
+      normError = normError+pow(error/scale, 2);
+      if (selectiveRollback && error/scale > 1.0)
+        rejectedClusters.insert(mav_clusters[ownerVect[n]]);
+      if (error/scale > maxError)
       {
-        maxError = error/(fabs(outputVect[n])*relativeTolerance+absoluteTolerance);
-        logDebug("DEBUGGING: scaled error is: " + std::to_string(error/(fabs(outputVect[n])*relativeTolerance+absoluteTolerance)) + " New biggest Differance is: " + std::to_string(maxError));
+        maxError = error/scale;
+        logDebug("DEBUGGING: scaled error is: " + std::to_string(error/scale) + " New biggest Differance is: " + std::to_string(maxError));
       }
     }
     normError = pow(normError, 0.5);
@@ -443,11 +489,20 @@ oms_status_enu_t oms::SystemWC::doStep()
     logDebug("DEBUGGING: fixRatio is: " + std::to_string(fixRatio));
     if (fixRatio < 1.0 && minimumStepSize < stepSize) //Going to rollback.
     {
-      // Rollback FMUs
-      for (const auto& component : mav_canGetAndSetStateFMUcomponents)
+      // Rollback FMUs; with selective rollback, isolated clusters without a rejected signal keep their progress
+      std::map<ComRef, Component*> rollbackComponents;
+      for (const auto& component : steppedComponents)
       {
-        component.second->restoreState();
+        const int cluster = mav_clusters[component.first];
+        if (!selectiveRollback || !mav_isolatedClusters[cluster] || rejectedClusters.find(cluster) != rejectedClusters.end())
+          rollbackComponents.insert(component);
+        else
+          mav_aheadComponents[component.first] = tNext;
       }
+      logDebug("DEBUGGING: rolling back " + std::to_string(rollbackComponents.size()) + " of " + std::to_string(steppedComponents.size()) + " FMUs");
+
+      if (oms_status_ok != callComponents(rollbackComponents, &Component::restoreState))
+        return oms_status_error;
 
       // Fix time
       time = tNext-stepSize;
@@ -486,11 +541,24 @@ oms_status_enu_t oms::SystemWC::doStep()
       }
 
       time = tNext;
+
+      // FMUs that were ahead are back in sync once the system reaches their time
+      for (auto it = mav_aheadComponents.begin(); it != mav_aheadComponents.end();)
+      {
+        if (it->second <= tNext)
+          it = mav_aheadComponents.erase(it);
+        else
+          ++it;
+      }
+
+      // the outputs of FMUs that are still ahead belong to a later time, so
+      // results are only emitted once all FMUs are at the system time again
+      const bool inSync = mav_aheadComponents.empty();
       bool emitted;
-      if (isTopLevelSystem())
+      if (isTopLevelSystem() && inSync)
         getModel().emit(time, false, &emitted);
       updateInputs(eventGraph);
-      if (isTopLevelSystem())
+      if (isTopLevelSystem() && inSync)
         getModel().emit(time, emitted);
 
       rollBackIt = 0;
@@ -501,9 +569,7 @@ oms_status_enu_t oms::SystemWC::doStep()
       stepSize = stepSize*fixRatio;
     }
 
-    for (const auto& component : mav_canGetAndSetStateFMUcomponents)
-      component.second->freeState();
-
+    // the saved states are kept and updated in place by the next step; they are freed in terminate()
     return oms_status_ok;
   }
   else if (solverMethod == oms_solver_wc_ma)
@@ -512,21 +578,35 @@ oms_status_enu_t oms::SystemWC::doStep()
     std::vector<double> inputVect2;
     std::vector<double> inputDer;
 
+    // the last step of stepUntil() ends at its stop time, so that the model is exactly at that time afterwards
     double tNext = time+maximumStepSize;
-    const double stopTime = this->getModel().getStopTime();
+    const double stopTime = communicationStopTime;
     if (tNext > stopTime)
       tNext = stopTime;
 
+    // FMI 3.0 FMUs may return early at internal events; the step then ends at the earliest event
+    if (masiMax == 1 && lastCommunicationTimes.empty())
+      if (oms_status_ok != stepEventComponents(tNext))
+        return oms_status_error;
+
     double h = tNext - time;
     logDebug("doStep: " + std::to_string(time) + " -> " + std::to_string(tNext) + ", stopTime " + std::to_string(stopTime) + ", h " + std::to_string(h));
 
     // save component's state
     if (masiMax > 1)
     {
-      for (const auto& component : getComponents())
-        component.second->saveState();
+      if (oms_status_ok != callComponents(getComponents(), &Component::saveState))
+        return oms_status_error;
     }
 
+    // with activation ratios, only the elements that reach a communication point are stepped
+    std::map<ComRef, System*> activeSubSystems;
+    std::map<ComRef, Component*> activeComponents;
+    if (!lastCommunicationTimes.empty())
+      getActiveElements(tNext, activeSubSystems, activeComponents);
+    const std::map<ComRef, System*>& steppedSubSystems = lastCommunicationTimes.empty() ? getSubSystems() : activeSubSystems;
+    const std::map<ComRef, Component*>& steppedComponents = lastCommunicationTimes.empty() ? getComponents() : activeComponents;
+
     getInputs(eventGraph, inputVect1);
     for (int masi=0; masi<masiMax; masi++)
     {
@@ -534,9 +614,9 @@ oms_status_enu_t oms::SystemWC::doStep()
       if (useThreadPool())
       {
         ctpl::thread_pool& pool = getThreadPool();
-        std::vector<std::future<oms_status_enu_t>> results(getSubSystems().size());
+        std::vector<std::future<oms_status_enu_t>> results(steppedSubSystems.size());
         int i=0;
-        for (const auto& subsystem : getSubSystems())
+        for (const auto& subsystem : steppedSubSystems)
         {
           results[i] = pool.push([&subsystem, tNext](int id){ /*logInfo("Id: " + std::to_string(id));*/ return subsystem.second->stepUntil(tNext); });
           i++;
@@ -551,7 +631,7 @@ oms_status_enu_t oms::SystemWC::doStep()
       }
       else
       {
-        for (const auto& subsystem : getSubSystems())
+        for (const auto& subsystem : steppedSubSystems)
         {
           status = subsystem.second->stepUntil(tNext);
           if (oms_status_ok != status)
@@ -562,9 +642,9 @@ oms_status_enu_t oms::SystemWC::doStep()
       if (useThreadPool())
       {
         ctpl::thread_pool& pool = getThreadPool();
-        std::vector<std::future<oms_status_enu_t>> results(getComponents().size());
+        std::vector<std::future<oms_status_enu_t>> results(steppedComponents.size());
         int i=0;
-        for (const auto& component : getComponents())
+        for (const auto& component : steppedComponents)
         {
           results[i] = pool.push([&component, tNext](int id){ /*logInfo("Id: " + std::to_string(id));*/ return component.second->stepUntil(tNext); });
           i++;
@@ -579,7 +659,7 @@ oms_status_enu_t oms::SystemWC::doStep()
       }
       else
       {
-        for (const auto& component : getComponents())
+        for (const auto& component : steppedComponents)
         {
           status = component.second->stepUntil(tNext);
           if (oms_status_ok != status)
@@ -608,8 +688,8 @@ oms_status_enu_t oms::SystemWC::doStep()
           inputDer.push_back((inputVect2[inputI]-inputVect1[inputI]) / h);
 
         // Restore component's state
-        for (const auto& component : getComponents())
-          component.second->restoreState();
+        if (oms_status_ok != callComponents(getComponents(), &Component::restoreState))
+          return oms_status_error;
 
         //updateInputs(outputsGraph);
         setInputsDer(eventGraph, inputDer);
@@ -617,6 +697,11 @@ oms_status_enu_t oms::SystemWC::doStep()
       else
       {
         time = tNext;
+        multirateStep++;
+        for (auto& last : lastCommunicationTimes)
+          if (steppedSubSystems.find(last.first) != steppedSubSystems.end() || steppedComponents.find(last.first) != steppedComponents.end())
+            last.second = tNext;
+
         bool emitted;
         if (isTopLevelSystem())
           getModel().emit(time, false, &emitted);
@@ -632,6 +717,223 @@ oms_status_enu_t oms::SystemWC::doStep()
   return logError("Invalid solver selected");
 }
 
+/**
+ * @brief Groups the components into clusters that are coupled through connections.
+ *
+ * Only isolated clusters, i.e., clusters without subsystems, system connectors
+ * or FMUs that can't get and set their state, may skip a rollback.
+ */
+void oms::SystemWC::updateRollbackClusters()
+{
+  std::map<ComRef, int> owners;
+  std::vector<int> parent;
+  auto find = [&parent](int i) { while (parent[i] != i) i = parent[i] = parent[parent[i]]; return i; };
+  auto getOwner = [&owners, &parent](const ComRef& name) {
+    ComRef tail(name);
+    auto it = owners.insert(std::make_pair(tail.pop_front(), static_cast<int>(parent.size())));
+    if (it.second)
+      parent.push_back(it.first->second);
+    return it.first->second;
+  };
+
+  for (const auto& component : getComponents())
+    getOwner(component.first);
+
+  const std::vector<Connector>& nodes = eventGraph.getNodes();
+  for (const std::pair<int, int>& edge : eventGraph.getEdges().connections)
+  {
+    const int a = find(getOwner(nodes[edge.first].getName()));
+    const int b = find(getOwner(nodes[edge.second].getName()));
+    parent[a] = b;
+  }
+
+  mav_clusters.clear();
+  mav_isolatedClusters.assign(parent.size(), true);
+  for (const auto& owner : owners)
+  {
+    const int cluster = find(owner.second);
+    if (mav_canGetAndSetStateFMUcomponents.find(owner.first) == mav_canGetAndSetStateFMUcomponents.end())
+      mav_isolatedClusters[cluster] = false;
+    else
+      mav_clusters[owner.first] = cluster;
+  }
+}
+
+/**
+ * @brief Calls a method of all given components, using the thread pool if available.
+ *
+ * Used for saving and restoring the FMU states in the adaptive master algorithms.
+ */
+oms_status_enu_t oms::SystemWC::callComponents(const std::map<ComRef, Component*>& components, oms_status_enu_t (Component::*method)())
+{
+  oms_status_enu_t status = oms_status_ok;
+  if (useThreadPool() && components.size() > 1)
+  {
+    ctpl::thread_pool& pool = getThreadPool();
+    std::vector<std::future<oms_status_enu_t>> results(components.size());
+    int i=0;
+    for (const auto& component : components)
+    {
+      Component* c = component.second;
+      results[i] = pool.push([c, method](int id){ return (c->*method)(); });
+      i++;
+    }
+
+    // wait for all tasks before returning, since they refer to the components
+    for (auto& r : results)
+    {
+      oms_status_enu_t s = r.get();
+      if (oms_status_ok != s)
+        status = s;
+    }
+  }
+  else
+  {
+    for (const auto& component : components)
+    {
+      status = (component.second->*method)();
+      if (oms_status_ok != status)
+        return status;
+    }
+  }
+
+  return status;
+}
+
+/**
+ * @brief Steps the FMI 3.0 FMUs that use event mode and shortens the step to the earliest internal event.
+ *
+ * FMUs that were already stepped past the event are rolled back and stepped
+ * again if they can get and set their state. Otherwise, the FMU with the
+ * event continues to the end of the step.
+ */
+oms_status_enu_t oms::SystemWC::stepEventComponents(double& tNext)
+{
+  std::vector<ComponentFMU3CS*> fmus;
+  for (const auto& component : getComponents())
+  {
+    if (oms_component_fmu3 != component.second->getType())
+      continue;
+
+    ComponentFMU3CS* fmu = dynamic_cast<ComponentFMU3CS*>(component.second);
+    if (fmu && fmu->getEventModeUsed())
+      fmus.push_back(fmu);
+  }
+
+  bool canRollback = true;
+  for (size_t i = 0; i < fmus.size(); ++i)
+  {
+    // an event of fmus[i] only requires the earlier FMUs to roll back
+    const bool earlierCanRollback = canRollback;
+
+    // the state is needed if one of the following FMUs returns early
+    if (canRollback && i + 1 < fmus.size())
+    {
+      canRollback = fmus[i]->getCanGetAndSetState();
+      if (canRollback && oms_status_ok != fmus[i]->saveState())
+        return oms_status_error;
+    }
+
+    oms_status_enu_t status = fmus[i]->stepUntilEvent(tNext);
+    if (oms_status_ok != status)
+      return status;
+
+    const double tEvent = fmus[i]->getFmuTime();
+    if (tEvent >= tNext || tEvent >= getModel().getStopTime())
+      continue;
+
+    if (i > 0 && !earlierCanRollback)
+    {
+      logDebug("Event of \"" + std::string(fmus[i]->getFullCref()) + "\" at time " + std::to_string(tEvent) + " doesn't shorten the step, since not all FMUs can roll back");
+      status = fmus[i]->stepUntil(tNext);
+      if (oms_status_ok != status)
+        return status;
+      continue;
+    }
+
+    logDebug("Step is shortened to the event of \"" + std::string(fmus[i]->getFullCref()) + "\" at time " + std::to_string(tEvent));
+    for (size_t j = 0; j < i; ++j)
+    {
+      if (oms_status_ok != fmus[j]->restoreState())
+        return oms_status_error;
+      status = fmus[j]->stepUntil(tEvent);
+      if (oms_status_ok != status)
+        return status;
+    }
+    tNext = tEvent;
+  }
+
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemWC::setActivationRatio(const ComRef& cref, int k)
+{
+  ComRef tail(cref);
+  ComRef head = tail.pop_front();
+
+  auto subsystem = getSubSystems().find(head);
+  if (subsystem != getSubSystems().end() && !tail.isEmpty())
+    return subsystem->second->setActivationRatio(tail, k);
+
+  if (!tail.isEmpty() || (subsystem == getSubSystems().end() && getComponents().find(head) == getComponents().end()))
+    return logError_ComponentNotInSystem(this, cref);
+
+  if (k < 1)
+    return logError("Invalid activation ratio " + std::to_string(k) + " for \"" + std::string(getFullCref() + head) + "\"; it must be positive");
+
+  if (k == 1)
+    activationRatios.erase(head);
+  else
+  {
+    activationRatios[head] = k;
+    if (solverMethod != oms_solver_wc_ma)
+      logWarning("System \"" + std::string(getFullCref()) + "\": activation ratios are ignored by solver \"" + getSolverName() + "\"; use solver \"oms-ma\"");
+  }
+
+  return oms_status_ok;
+}
+
+/**
+ * @brief Selects the components and subsystems that reach a communication point at the end of the current step.
+ *
+ * Elements with an activation ratio k are stepped every k-th step of the
+ * system and in the last step of stepUntil; all others in each step.
+ */
+void oms::SystemWC::getActiveElements(double tNext, std::map<ComRef, System*>& activeSubSystems, std::map<ComRef, Component*>& activeComponents)
+{
+  const bool lastStep = tNext >= communicationStopTime;
+  auto isActive = [&](const ComRef& name) {
+    auto ratio = activationRatios.find(name);
+    return lastStep || ratio == activationRatios.end() || (multirateStep + 1) % ratio->second == 0;
+  };
+
+  for (const auto& subsystem : getSubSystems())
+    if (isActive(subsystem.first))
+      activeSubSystems.insert(subsystem);
+
+  for (const auto& component : getComponents())
+    if (isActive(component.first))
+      activeComponents.insert(component);
+}
+
+/**
+ * @brief Time since the last communication point of the element a signal belongs to.
+ *
+ * Zero for signals of elements that communicate in each step.
+ */
+double oms::SystemWC::getCommunicationLag(const ComRef& signal) const
+{
+  if (lastCommunicationTimes.empty())
+    return 0.0;
+
+  ComRef tail(signal);
+  auto last = lastCommunicationTimes.find(tail.pop_front());
+  if (last == lastCommunicationTimes.end())
+    return 0.0;
+
+  return time - last->second;
+}
+
 oms_status_enu_t oms::SystemWC::stepUntil(double stopTime)
 {
   CallClock callClock(clock);
@@ -660,6 +962,9 @@ oms_status_enu_t oms::SystemWC::stepUntil(double stopTime)
     {
       status = doStep();
 
+      if (isTopLevelSystem() && oms_status_ok == status)
+        status = getModel().checkpoint(time);
+
       if (isTopLevelSystem() && Flags::ProgressBar())
         Log::ProgressBar(startTime, stopTime, time);
     }
@@ -667,21 +972,28 @@ oms_status_enu_t oms::SystemWC::stepUntil(double stopTime)
     if (isTopLevelSystem() && Flags::ProgressBar())
       Log::TerminateBar();
 
-    return oms_status_ok;
+    return status;
   }
   else if (solverMethod == oms_solver_wc_ma)
   {
     logDebug("DEBUGGING: Entering FixedStep solver");
 
+    // all elements communicate at the end of stepUntil, see doStep() and getActiveElements()
+    communicationStopTime = std::min(stopTime, getModel().getStopTime());
+
     // main simulation loop
     oms_status_enu_t status = oms_status_ok;
     while (time < std::min(stopTime, getModel().getStopTime()) && oms_status_ok == status)
     {
       status = doStep();
 
+      if (isTopLevelSystem() && oms_status_ok == status)
+        status = getModel().checkpoint(time);
+
       if (isTopLevelSystem() && Flags::ProgressBar())
         Log::ProgressBar(startTime, stopTime, time);
     }
+    communicationStopTime = getModel().getStopTime();
 
     if (isTopLevelSystem() && Flags::ProgressBar())
       Log::TerminateBar();
@@ -692,6 +1004,55 @@ oms_status_enu_t oms::SystemWC::stepUntil(double stopTime)
     return logError("Invalid solver selected");
 }
 
+static void serializeTimes(oms::Checkpoint& checkpoint, const std::map<oms::ComRef, double>& times)
+{
+  checkpoint.writeValue<uint64_t>(times.size());
+  for (const auto& t : times)
+  {
+    checkpoint.writeString(std::string(t.first));
+    checkpoint.writeValue(t.second);
+  }
+}
+
+static bool deserializeTimes(oms::Checkpoint& checkpoint, std::map<oms::ComRef, double>& times)
+{
+  uint64_t n;
+  if (!checkpoint.readValue(n))
+    return false;
+
+  times.clear();
+  for (uint64_t i = 0; i < n; ++i)
+  {
+    std::string name;
+    double t;
+    if (!checkpoint.readString(name) || !checkpoint.readValue(t))
+      return false;
+    times[oms::ComRef(name)] = t;
+  }
+  return true;
+}
+
+oms_status_enu_t oms::SystemWC::serializeSolverState(Checkpoint& checkpoint)
+{
+  checkpoint.writeValue(stepSize);
+  checkpoint.writeValue<uint64_t>(multirateStep);
+  serializeTimes(checkpoint, lastCommunicationTimes);
+  serializeTimes(checkpoint, mav_aheadComponents);
+  return oms_status_ok;
+}
+
+oms_status_enu_t oms::SystemWC::deserializeSolverState(Checkpoint& checkpoint)
+{
+  uint64_t step;
+  if (!checkpoint.readValue(stepSize) || !checkpoint.readValue(step) ||
+      !deserializeTimes(checkpoint, lastCommunicationTimes) ||
+      !deserializeTimes(checkpoint, mav_aheadComponents))
+    return logError("Checkpoint doesn't match the solver state of system " + std::string(getFullCref()));
+
+  multirateStep = step;
+  return oms_status_ok;
+}
+
 oms_status_enu_t oms::SystemWC::getRealOutputDerivative(const ComRef& cref, SignalDerivative& der)
 {
   if (!getModel().validState(oms_modelState_simulation))
@@ -732,6 +1093,10 @@ oms_status_enu_t oms::SystemWC::getInputs(oms::DirectedGraph& graph, std::vector
     {
       int input = sortedConnections[i].connections[0].second;
 
+      // the input derivatives aren't supported for array connections
+      if (graph.getNodes()[input].isArray())
+        continue;
+
       if (graph.getNodes()[input].getType() == oms_signal_type_real)
       {
         double value = 0.0;
@@ -753,6 +1118,9 @@ oms_status_enu_t oms::SystemWC::setInputsDer(oms::DirectedGraph& graph, const st
     {
       int input = sortedConnections[i].connections[0].second;
 
+      if (graph.getNodes()[input].isArray())
+        continue;
+
       if (graph.getNodes()[input].getType() == oms_signal_type_real)
       {
         if (oms_status_ok != setRealInputDerivative(graph.getNodes()[input].getName(), inputsDer[derI++]))
@@ -763,59 +1131,67 @@ oms_status_enu_t oms::SystemWC::setInputsDer(oms::DirectedGraph& graph, const st
   return oms_status_ok;
 }
 
-oms_status_enu_t oms::SystemWC::getInputAndOutput(oms::DirectedGraph& graph, std::vector<double>& inputVect, std::vector<double>& outputVect, std::map<ComRef, Component*> FMUcomponents)
+/**
+ * @brief Collects the real inputs and outputs of all connections between the given FMUs.
+ *
+ * Connections that are part of an algebraic loop are included as well. The
+ * nominal value of each output is used to scale the error estimate, and the
+ * component of each output to find the FMUs that need to be rolled back.
+ */
+oms_status_enu_t oms::SystemWC::getInputAndOutput(oms::DirectedGraph& graph, std::vector<double>& inputVect, std::vector<double>& outputVect, std::vector<double>& nominalVect, std::vector<ComRef>& ownerVect, const std::map<ComRef, Component*>& FMUcomponents)
 {
   // FMUcomponents in will be list of FMUs that CAN GET FMUs
   const std::vector< scc_t >& sortedConnections = graph.getSortedConnections();
   inputVect.clear();
-  int inCount = 0;
   outputVect.clear();
-  int outCount = 0;
+  nominalVect.clear();
+  ownerVect.clear();
 
-  for(int i=0; i < sortedConnections.size(); i++)
+  for (const scc_t& scc : sortedConnections)
   {
-    if (!sortedConnections[i].thisIsALoop)
+    for (const std::pair<int, int>& connection : scc.connections)
     {
-      logDebug("DEBUGGING: Size of sortedConnections[i] is: "+std::to_string(sortedConnections[i].connections.size()));
-      int input = sortedConnections[i].connections[0].second;
-      oms::ComRef inputName(graph.getNodes()[input].getName());
+      const Connector& input = graph.getNodes()[connection.second];
+      const Connector& output = graph.getNodes()[connection.first];
+      if (input.getType() != oms_signal_type_real || output.getType() != oms_signal_type_real)
+        continue;
+
+      oms::ComRef inputName(input.getName());
       oms::ComRef inputModel = inputName.pop_front();
-      logDebug(inputModel);
-      int output = sortedConnections[i].connections[0].first;
-      oms::ComRef outputName(graph.getNodes()[output].getName());
+      oms::ComRef outputName(output.getName());
       oms::ComRef outputModel = outputName.pop_front();
-      logDebug(outputModel);
-      if (FMUcomponents.find(inputModel) != FMUcomponents.end())
+
+      auto outputComponent = FMUcomponents.find(outputModel);
+      if (FMUcomponents.find(inputModel) == FMUcomponents.end() || outputComponent == FMUcomponents.end())
+        continue;
+
+      const Variable* var = outputComponent->second->getVariable(outputName);
+      if (input.isArray())
       {
-        if (FMUcomponents.find(outputModel) != FMUcomponents.end())
-        {
-          if (graph.getNodes()[input].getType() == oms_signal_type_real)
-          {
-            double inValue = 0.0;
-            if (oms_status_ok != getReal(graph.getNodes()[input].getName(), inValue)) return oms_status_error;
-            logDebug("DEBUGGING: found a real input called: "+std::string(graph.getNodes()[output].getName()));
-            inputVect.push_back(inValue);
-            inCount++;
-          }
-          if (graph.getNodes()[output].getType() == oms_signal_type_real)
-          {
-            double outValue = 0.0;
-            if (oms_status_ok != getReal(graph.getNodes()[output].getName(), outValue)) return oms_status_error;
-            logDebug("DEBUGGING: found a real output called: "+std::string(graph.getNodes()[output].getName()));
-            outputVect.push_back(outValue);
-            outCount++;
-          }
-        }
+        const size_t size = input.getArraySize();
+        arrayBuffer.resize(2*size);
+        if (oms_status_ok != getRealArray(input.getName(), arrayBuffer.data(), size)) return oms_status_error;
+        if (oms_status_ok != getRealArray(output.getName(), arrayBuffer.data() + size, size)) return oms_status_error;
+        inputVect.insert(inputVect.end(), arrayBuffer.begin(), arrayBuffer.begin() + size);
+        outputVect.insert(outputVect.end(), arrayBuffer.begin() + size, arrayBuffer.end());
+        nominalVect.insert(nominalVect.end(), size, var ? var->getNominal() : 1.0);
+        ownerVect.insert(ownerVect.end(), size, outputModel);
+        continue;
       }
+
+      double inValue = 0.0;
+      double outValue = 0.0;
+      if (oms_status_ok != getReal(input.getName(), inValue)) return oms_status_error;
+      if (oms_status_ok != getReal(output.getName(), outValue)) return oms_status_error;
+
+      inputVect.push_back(inValue);
+      outputVect.push_back(outValue);
+      nominalVect.push_back(var ? var->getNominal() : 1.0);
+      ownerVect.push_back(outputModel);
     }
-    else
-    {
-      logDebug("DEBUGGING: Exiting cuz algebraic loop!");
-      return oms_status_error; // algebraic loop: TODO
-    }
-    logDebug("DEBUGGING: we have added "+std::to_string(inCount)+" inputs and "+std::to_string(outCount)+" outputs to the vectors.");
   }
 
+  logDebug("DEBUGGING: we have added " + std::to_string(inputVect.size()) + " inputs and " + std::to_string(outputVect.size()) + " outputs to the vectors.");
   return oms_status_ok;
 }
 
@@ -836,11 +1212,37 @@ oms_status_enu_t oms::SystemWC::updateInputs(oms::DirectedGraph& graph)
       size_t output = sortedConnections[i].connections[0].first;
       size_t input = sortedConnections[i].connections[0].second;
 
-      if (graph.getNodes()[input].getType() == oms_signal_type_real)
+      // inputs of elements with an activation ratio are held between their communication points
+      if (getCommunicationLag(graph.getNodes()[input].getName()) > 0.0)
+        continue;
+
+      // array connections are transferred as a whole
+      if (graph.getNodes()[input].isArray())
+      {
+        if (graph.getNodes()[input].getType() != oms_signal_type_real)
+          return logError("Only real arrays can be connected: " + std::string(graph.getNodes()[input].getName()));
+
+        arrayBuffer.resize(graph.getNodes()[input].getArraySize());
+        if (oms_status_ok != getRealArray(graph.getNodes()[output].getName(), arrayBuffer.data(), arrayBuffer.size())) return oms_status_error;
+        if (!sortedConnections[i].suppressUnitConversion && sortedConnections[i].factor != 1.0)
+          for (double& value : arrayBuffer)
+            value *= sortedConnections[i].factor;
+        if (oms_status_ok != setRealArray(graph.getNodes()[input].getName(), arrayBuffer.data(), arrayBuffer.size())) return oms_status_error;
+      }
+      else if (graph.getNodes()[input].getType() == oms_signal_type_real)
       {
         double value = 0.0;
         if (oms_status_ok != getReal(graph.getNodes()[output].getName(), value)) return oms_status_error;
 
+        // outputs of elements with an activation ratio are extrapolated from their last communication point
+        const double lag = getCommunicationLag(graph.getNodes()[output].getName());
+        if (lag > 0.0 && Flags::InputExtrapolation())
+        {
+          SignalDerivative der;
+          if (oms_status_ok == getRealOutputDerivative(graph.getNodes()[output].getName(), der) && der.getMaxDerivativeOrder() > 0)
+            value += der.getDerivatives()[0]*lag;
+        }
+
         // Check for unit conversion and suppressUnitConversion. Set the value multiplied by factor.
         // By default, factor = 1.0. For example, mm to m will be (factor * value) => (10^-3 * value).
         if (sortedConnections[i].suppressUnitConversion)
@@ -63,10 +63,11 @@ namespace oms
     std::string getSolverName() const;
     oms_status_enu_t setSolverMethod(std::string);
     oms_status_enu_t setSolver(oms_solver_enu_t solver) {if (solver > oms_solver_wc_min && solver < oms_solver_wc_max) {solverMethod=solver; return oms_status_ok;} return oms_status_error;}
+    oms_status_enu_t setActivationRatio(const ComRef& cref, int k);
 
     oms_status_enu_t getInputs(DirectedGraph& graph, std::vector<double>& inputs);
     oms_status_enu_t setInputsDer(oms::DirectedGraph& graph, const std::vector<double>& inputsDer);
-    oms_status_enu_t getInputAndOutput(DirectedGraph& graph, std::vector<double>& inputVect,std::vector<double>& outputVect,std::map<ComRef, Component*> FMUcomponents);
+    oms_status_enu_t getInputAndOutput(DirectedGraph& graph, std::vector<double>& inputVect, std::vector<double>& outputVect, std::vector<double>& nominalVect, std::vector<ComRef>& ownerVect, const std::map<ComRef, Component*>& FMUcomponents);
     oms_status_enu_t updateInputs(DirectedGraph& graph);
 
     oms_status_enu_t getRealOutputDerivative(const ComRef& cref, SignalDerivative& der);
@@ -79,10 +80,20 @@ namespace oms
   protected:
     SystemWC(const ComRef& cref, Model* parentModel, System* parentSystem);
 
+    oms_status_enu_t serializeSolverState(Checkpoint& checkpoint);
+    oms_status_enu_t deserializeSolverState(Checkpoint& checkpoint);
+
     // stop the compiler generating methods copying the object
     SystemWC(SystemWC const& copy);            ///< not implemented
     SystemWC& operator=(SystemWC const& copy); ///< not implemented
 
+  private:
+    void updateRollbackClusters();
+    void getActiveElements(double tNext, std::map<ComRef, System*>& activeSubSystems, std::map<ComRef, Component*>& activeComponents);
+    double getCommunicationLag(const ComRef& signal) const;
+    oms_status_enu_t stepEventComponents(double& tNext);
+    oms_status_enu_t callComponents(const std::map<ComRef, Component*>& components, oms_status_enu_t (Component::*method)());
+
   private:
     unsigned int h_id;
     unsigned int roll_iter_id;
@@ -92,14 +103,22 @@ namespace oms
     double maxError = 0.0;
     double normError = 0.0;
     unsigned int rollBackIt = 0;
+    std::vector<double> arrayBuffer; ///< values of array connections in updateInputs
 
     // oms_solver_wc_ma
     int masiMax;
+    std::map<ComRef, int> activationRatios;          ///< components and subsystems that are only stepped every k-th step
+    std::map<ComRef, double> lastCommunicationTimes; ///< last communication point of the elements with an activation ratio
+    unsigned long multirateStep = 0;                 ///< number of steps since initialization
+    double communicationStopTime = 0.0;              ///< end of the current stepUntil, or the stop time for single steps; the steps of solver ma end there
 
     // oms_solver_wc_mav || oms_solver_wc_mav2
     bool mav_doDoubleStep;
     std::map<ComRef, Component*> mav_FMUcomponents;
     std::map<ComRef, Component*> mav_canGetAndSetStateFMUcomponents;
+    std::map<ComRef, int> mav_clusters;           ///< coupled cluster of each component, see updateRollbackClusters()
+    std::vector<bool> mav_isolatedClusters;        ///< cluster consists only of components that can get and set their state
+    std::map<ComRef, double> mav_aheadComponents;  ///< components that weren't rolled back, with their time
   };
 }
 
@@ -1780,6 +1780,9 @@ oms_status_enu_t oms::Values::parseModelDescriptionFmi3(const filesystem::path&
           // check for units
           if (strlen(it_->attribute("unit").as_string()) != 0)
             modelDescriptionVariableUnits[ComRef(it_->attribute("name").as_string())] = it_->attribute("unit").as_string();
+          // derivatives refer to their state by value reference
+          if (it_->attribute("derivative"))
+            modelDescriptionDerivatives[it_->attribute("valueReference").as_uint()] = it_->attribute("derivative").as_uint();
         }
         if (std::string(it_->name()) == "Int64" ||
             std::string(it_->name()) == "Int32" ||
@@ -1877,6 +1880,28 @@ oms_status_enu_t oms::Values::parseModelDescriptionFmi3(const filesystem::path&
   return oms_status_ok;
 }
 
+void oms::Values::copyModelDescription(const Values& source)
+{
+  modelDescriptionBooleanStartValues = source.modelDescriptionBooleanStartValues;
+  modelDescriptionRealStartValues = source.modelDescriptionRealStartValues;
+  modelDescriptionIntegerStartValues = source.modelDescriptionIntegerStartValues;
+  modelDescriptionStringStartValues = source.modelDescriptionStringStartValues;
+
+  modelStructureOutputs = source.modelStructureOutputs;
+  modelStructureDerivatives = source.modelStructureDerivatives;
+  modelStructureInitialUnknowns = source.modelStructureInitialUnknowns;
+  modelDescriptionDerivatives = source.modelDescriptionDerivatives;
+
+  modelStructureOutputDependencyExist = source.modelStructureOutputDependencyExist;
+  modelStructureDerivativesDependencyExist = source.modelStructureDerivativesDependencyExist;
+  modelStructureInitialUnknownsDependencyExist = source.modelStructureInitialUnknownsDependencyExist;
+
+  modelDescriptionVariableUnits = source.modelDescriptionVariableUnits;
+  modeldescriptionUnitDefinitions = source.modeldescriptionUnitDefinitions;
+  modeldescriptionTypeDefinitions = source.modeldescriptionTypeDefinitions;
+  modeldescriptionEnumeration = source.modeldescriptionEnumeration;
+}
+
 void oms::Values::parseModelStructureDependencies(std::string &dependencies, std::vector<int> &dependencyList)
 {
   std::stringstream ss(dependencies);
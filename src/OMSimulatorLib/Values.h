@@ -112,6 +112,7 @@ namespace oms
 
     oms_status_enu_t parseModelDescription(const filesystem::path& root, std::string& guid_); ///< path without the filename, i.e. modelDescription.xml
     oms_status_enu_t parseModelDescriptionFmi3(const filesystem::path& root, std::string& guid_); ///< path without the filename, i.e. modelDescription.xml
+    void copyModelDescription(const Values& source); ///< takes over what parseModelDescription() read for another instance of the same FMU
 
     oms_status_enu_t rename(const oms::ComRef& oldCref, const oms::ComRef& newCref);
     oms_status_enu_t renameInResources(const oms::ComRef& oldCref, const oms::ComRef& newCref);
@@ -152,6 +153,7 @@ namespace oms
     std::map<int, std::vector<int>> modelStructureOutputs;            ///< output and its dependencies from <ModelStructure>
     std::map<int, std::vector<int>> modelStructureDerivatives;        ///< derivatives and its dependencies from <ModelStructure>
     std::map<int, std::vector<int>> modelStructureInitialUnknowns;    ///< initialUnknowns and its dependencies from <ModelStructure>
+    std::map<unsigned int, unsigned int> modelDescriptionDerivatives; ///< value references of FMI 3.0 derivatives and their states
 
     std::map<int, bool> modelStructureOutputDependencyExist;
     std::map<int, bool> modelStructureDerivativesDependencyExist;
@@ -33,6 +33,7 @@
 
 #include "Logging.h"
 #include "Util.h"
+#include <cmath>
 #include <iostream>
 
 oms::Variable::Variable(fmiHandle* fmi4c, int index_, oms_component_enu_t componentType)
@@ -97,6 +98,10 @@ void oms::Variable::configureFMI2Variable(fmiHandle* fmi4c, int index_)
   // mark derivatives
   if (oms_signal_type_real == type)
   {
+    nominal = fabs(fmi2_getVariableNominal(var));
+    if (!(nominal > 0.0) || std::isinf(nominal))
+      nominal = 1.0;
+
     int derivative_index = fmi2_getVariableDerivativeIndex(var);
     if (derivative_index != 0)
     {
@@ -181,20 +186,21 @@ void oms::Variable::configureFMI3Variable(fmiHandle* fmi4c, int index_)
       break;
   }
 
-  // mark derivatives
-  if (oms_signal_type_real == type)
+  // array variables are only supported with fixed dimensions
+  for (int i = 0; i < fmi3_getVariableNumberOfDimensions(var); ++i)
   {
-    int derivative_index = fmi3_getVariableDerivativeIndex(var);
-    if (derivative_index != 0)
+    fmi3DimensionHandle* dimension = fmi3_getVariableDimensionHandle(var, i);
+    if (!fmi3_getDimensionHasStart(dimension))
     {
-      is_der = true;
-      state_index = derivative_index;
-      if (fmi3Variability_ == fmi3VariabilityContinuous)
-      {
-        is_continuous_time_der = true;
-      }
+      logWarning("Array variable " + std::string(cref) + " has a dimension that depends on a structural parameter, which isn't supported");
+      arraySize = 0;
+      break;
     }
+    arraySize *= static_cast<size_t>(fmi3_getDimensionStart(dimension));
   }
+
+  // derivatives are marked by the component with markAsDer(), since the
+  // derivative attribute is a value reference and 0 is a valid one
 }
 
 oms::Variable::~Variable()
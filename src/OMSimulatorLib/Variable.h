@@ -51,6 +51,7 @@ namespace oms
     void markAsState(size_t der_index) { is_state = true; this->der_index = der_index; }
     void markAsContinuousTimeState(size_t der_index) { is_continuous_time_state = true; this->der_index = der_index; }
     void markAsContinuousTimeDer() { is_continuous_time_der = true; }
+    void markAsDer(size_t state_index) { is_der = true; is_continuous_time_der = isContinuous(); this->state_index = state_index; }
 
     unsigned int getStateIndex() const { return state_index; }
 
@@ -75,6 +76,9 @@ namespace oms
     bool isApprox() const { return isFmi2() ? (fmi2InitialApprox == fmi2InitialProperty) : (fmi3InitialApprox == fmi3InitialProperty);}
     bool isCalculated() const { return isFmi2() ? (fmi2InitialCalculated == fmi2InitialProperty) : (fmi3InitialCalculated == fmi3InitialProperty); }
 
+    // variability attribute
+    bool isContinuous() const { return isFmi2() ? (fmi2VariabilityContinuous == fmi2Variability_) : (fmi3VariabilityContinuous == fmi3Variability_);}
+
     bool isInitialUnknown() const {
       return (isOutput() && (isApprox() || isCalculated()))
         || (isCalculatedParameter())
@@ -90,6 +94,9 @@ namespace oms
     oms_signal_type_enu_t getType() const { return type; }
     oms_signal_numeric_type_enu_t getNumericType() const {return numericType;}
     const std::string& getDescription() const { return description; }
+    double getNominal() const { return nominal; }
+    size_t getArraySize() const { return arraySize; }
+    bool isArray() const { return arraySize != 1; }
 
     bool isTypeBoolean() const { return oms_signal_type_boolean == type; }
     bool isTypeInteger() const { return oms_signal_type_integer == type || oms_signal_type_enum == type; }
@@ -100,7 +107,7 @@ namespace oms
     oms_causality_enu_t getCausality() const;
 
     unsigned int getIndex() const { return index; }
-    oms::Connector makeConnector(const oms::ComRef& owner) const { return oms::Connector(getCausality(), type, cref, owner); }
+    oms::Connector makeConnector(const oms::ComRef& owner) const { oms::Connector connector(getCausality(), type, cref, owner); connector.setArraySize(arraySize); return connector; }
 
   private:
 
@@ -109,6 +116,8 @@ namespace oms
 
     ComRef cref;
     std::string description;
+    double nominal = 1.0; ///< nominal attribute of real variables, 1.0 otherwise
+    size_t arraySize = 1; ///< number of elements of FMI 3.0 array variables, 0 if the dimensions aren't fixed
     oms_component_enu_t componentType;
 
     // FMI 2.0 specific members
@@ -130,7 +139,7 @@ namespace oms
     oms_signal_type_enu_t type;
     oms_signal_numeric_type_enu_t numericType;
     unsigned int index; ///< index origin = 0
-    size_t state_index; ///< index origin = 0
+    size_t state_index; ///< index origin = 1 for FMI 2.0, value reference of the state for FMI 3.0
     size_t der_index; ///< index origin = 0
     bool fmi2;
     bool fmi3;
@@ -535,6 +535,23 @@ static int OMSimulatorLua_oms_addSystem(lua_State *L)
   return 1;
 }
 
+//oms_status_enu_t oms_cloneModel(const char* cref, const char* newCref);
+static int OMSimulatorLua_oms_cloneModel(lua_State *L)
+{
+  if (lua_gettop(L) != 2)
+    return luaL_error(L, "expecting exactly 2 arguments");
+  luaL_checktype(L, 1, LUA_TSTRING);
+  luaL_checktype(L, 2, LUA_TSTRING);
+
+  const char* cref = lua_tostring(L, 1);
+  const char* newCref = lua_tostring(L, 2);
+  oms_status_enu_t status = oms_cloneModel(cref, newCref);
+
+  lua_pushinteger(L, status);
+
+  return 1;
+}
+
 //oms_status_enu_t oms_copySystem(const char* source, const char* target);
 static int OMSimulatorLua_oms_copySystem(lua_State *L)
 {
@@ -772,6 +789,22 @@ static int OMSimulatorLua_oms_getSolver(lua_State *L)
   return 2;
 }
 
+//oms_status_enu_t oms_setActivationRatio(const char* cref, int k);
+static int OMSimulatorLua_oms_setActivationRatio(lua_State *L)
+{
+  if (lua_gettop(L) != 2)
+    return luaL_error(L, "expecting exactly 2 arguments");
+  luaL_checktype(L, 1, LUA_TSTRING);
+  luaL_checktype(L, 2, LUA_TNUMBER);
+
+  const char* cref = lua_tostring(L, 1);
+  int k = lua_tointeger(L, 2);
+
+  oms_status_enu_t status = oms_setActivationRatio(cref, k);
+  lua_pushinteger(L, status);
+  return 1;
+}
+
 //oms_status_enu_t oms_setBoolean(const char* cref, bool value);
 static int OMSimulatorLua_oms_setBoolean(lua_State *L)
 {
@@ -1101,6 +1134,36 @@ static int OMSimulatorLua_oms_initialize(lua_State *L)
   return 1;
 }
 
+//oms_status_enu_t oms_initializeFromCheckpoint(const char* cref, const char* filename);
+static int OMSimulatorLua_oms_initializeFromCheckpoint(lua_State *L)
+{
+  if (lua_gettop(L) != 2)
+    return luaL_error(L, "expecting exactly 2 arguments");
+  luaL_checktype(L, 1, LUA_TSTRING);
+  luaL_checktype(L, 2, LUA_TSTRING);
+
+  const char* cref = lua_tostring(L, 1);
+  const char* filename = lua_tostring(L, 2);
+  oms_status_enu_t status = oms_initializeFromCheckpoint(cref, filename);
+  lua_pushinteger(L, status);
+  return 1;
+}
+
+//oms_status_enu_t oms_saveCheckpoint(const char* cref, const char* filename);
+static int OMSimulatorLua_oms_saveCheckpoint(lua_State *L)
+{
+  if (lua_gettop(L) != 2)
+    return luaL_error(L, "expecting exactly 2 arguments");
+  luaL_checktype(L, 1, LUA_TSTRING);
+  luaL_checktype(L, 2, LUA_TSTRING);
+
+  const char* cref = lua_tostring(L, 1);
+  const char* filename = lua_tostring(L, 2);
+  oms_status_enu_t status = oms_saveCheckpoint(cref, filename);
+  lua_pushinteger(L, status);
+  return 1;
+}
+
 //oms_status_enu_t oms_terminate(const char* ident);
 static int OMSimulatorLua_oms_terminate(lua_State *L)
 {
@@ -1193,6 +1256,23 @@ static int OMSimulatorLua_oms_setResultFile(lua_State *L)
   return 1;
 }
 
+//oms_status_enu_t oms_setCheckpointFile(const char* cref, const char* filename, double interval);
+static int OMSimulatorLua_oms_setCheckpointFile(lua_State *L)
+{
+  if (lua_gettop(L) != 3)
+    return luaL_error(L, "expecting exactly 3 arguments");
+  luaL_checktype(L, 1, LUA_TSTRING);
+  luaL_checktype(L, 2, LUA_TSTRING);
+  luaL_checktype(L, 3, LUA_TNUMBER);
+
+  const char* cref = lua_tostring(L, 1);
+  const char* filename = lua_tostring(L, 2);
+  double interval = lua_tonumber(L, 3);
+  oms_status_enu_t status = oms_setCheckpointFile(cref, filename, interval);
+  lua_pushinteger(L, status);
+  return 1;
+}
+
 //OMSAPI oms_status_enu_t OMSCALL oms_setSolver(const char* cref, oms_solver_enu_t solver);
 static int OMSimulatorLua_oms_setSolver(lua_State *L)
 {
@@ -1322,6 +1402,7 @@ DLLEXPORT int luaopen_OMSimulatorLua(lua_State *L)
   REGISTER_LUA_CALL(oms_addSignalsToResults);
   REGISTER_LUA_CALL(oms_addSubModel);
   REGISTER_LUA_CALL(oms_addSystem);
+  REGISTER_LUA_CALL(oms_cloneModel);
   REGISTER_LUA_CALL(oms_compareSimulationResults);
   REGISTER_LUA_CALL(oms_copySystem);
   REGISTER_LUA_CALL(oms_delete);
@@ -1353,6 +1434,7 @@ DLLEXPORT int luaopen_OMSimulatorLua(lua_State *L)
   REGISTER_LUA_CALL(oms_importFile);
   REGISTER_LUA_CALL(oms_importSnapshot);
   REGISTER_LUA_CALL(oms_initialize);
+  REGISTER_LUA_CALL(oms_initializeFromCheckpoint);
   REGISTER_LUA_CALL(oms_instantiate);
   REGISTER_LUA_CALL(oms_list);
   REGISTER_LUA_CALL(oms_listVariants);
@@ -1366,7 +1448,10 @@ DLLEXPORT int luaopen_OMSimulatorLua(lua_State *L)
   REGISTER_LUA_CALL(oms_reset);
   REGISTER_LUA_CALL(oms_referenceResources);
   REGISTER_LUA_CALL(oms_reduceSSV);
+  REGISTER_LUA_CALL(oms_saveCheckpoint);
+  REGISTER_LUA_CALL(oms_setActivationRatio);
   REGISTER_LUA_CALL(oms_setBoolean);
+  REGISTER_LUA_CALL(oms_setCheckpointFile);
   REGISTER_LUA_CALL(oms_setCommandLineOption);
   REGISTER_LUA_CALL(oms_setFixedStepSize);
   REGISTER_LUA_CALL(oms_setInteger);
@@ -1400,6 +1485,7 @@ DLLEXPORT int luaopen_OMSimulatorLua(lua_State *L)
   // oms_solver_enu_t
   REGISTER_LUA_ENUM(oms_solver_sc_explicit_euler);
   REGISTER_LUA_ENUM(oms_solver_sc_cvode);
+  REGISTER_LUA_ENUM(oms_solver_sc_dopri5);
   REGISTER_LUA_ENUM(oms_solver_wc_ma);
   REGISTER_LUA_ENUM(oms_solver_wc_mav);
   REGISTER_LUA_ENUM(oms_solver_wc_mav2);
@@ -13,6 +13,21 @@ class Status(Enum):
   pending = 5
 
 
+class Solver(Enum):
+  '''Enumeration for solver methods (oms_solver_enu_t).'''
+  none = 0
+  sc_min = 1
+  sc_explicit_euler = 2
+  sc_cvode = 3
+  sc_dopri5 = 4
+  sc_max = 5
+  wc_min = 6
+  wc_ma = 7
+  wc_mav = 8
+  wc_mav2 = 9
+  wc_max = 10
+
+
 class capi:
   def __init__(self):
     dirname = os.path.dirname(__file__)
@@ -44,6 +59,8 @@ class capi:
     self.obj.oms_addSubModel.restype = ctypes.c_int
     self.obj.oms_addSystem.argtypes = [ctypes.c_char_p, ctypes.c_int]
     self.obj.oms_addSystem.restype = ctypes.c_int
+    self.obj.oms_cloneModel.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+    self.obj.oms_cloneModel.restype = ctypes.c_int
     self.obj.oms_delete.argtypes = [ctypes.c_char_p]
     self.obj.oms_delete.restype = ctypes.c_int
     self.obj.oms_getVersion.argtypes = None
@@ -60,10 +77,20 @@ class capi:
     self.obj.oms_getVariableType.restype = ctypes.c_int
     self.obj.oms_initialize.argtypes = [ctypes.c_char_p]
     self.obj.oms_initialize.restype = ctypes.c_int
+    self.obj.oms_initializeFromCheckpoint.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+    self.obj.oms_initializeFromCheckpoint.restype = ctypes.c_int
     self.obj.oms_instantiate.argtypes = [ctypes.c_char_p]
     self.obj.oms_instantiate.restype = ctypes.c_int
     self.obj.oms_newModel.argtypes = [ctypes.c_char_p]
     self.obj.oms_newModel.restype = ctypes.c_int
+    self.obj.oms_reset.argtypes = [ctypes.c_char_p]
+    self.obj.oms_reset.restype = ctypes.c_int
+    self.obj.oms_saveCheckpoint.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+    self.obj.oms_saveCheckpoint.restype = ctypes.c_int
+    self.obj.oms_setActivationRatio.argtypes = [ctypes.c_char_p, ctypes.c_int]
+    self.obj.oms_setActivationRatio.restype = ctypes.c_int
+    self.obj.oms_setCheckpointFile.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_double]
+    self.obj.oms_setCheckpointFile.restype = ctypes.c_int
     self.obj.oms_setCommandLineOption.argtypes = [ctypes.c_char_p]
     self.obj.oms_setCommandLineOption.restype = ctypes.c_int
     self.obj.oms_setTempDirectory.argtypes = [ctypes.c_char_p]
@@ -80,6 +107,10 @@ class capi:
     self.obj.oms_setString.restype = ctypes.c_int
     self.obj.oms_setResultFile.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int]
     self.obj.oms_setResultFile.restype = ctypes.c_int
+    self.obj.oms_setLogFile.argtypes = [ctypes.c_char_p]
+    self.obj.oms_setLogFile.restype = ctypes.c_int
+    self.obj.oms_setSolver.argtypes = [ctypes.c_char_p, ctypes.c_int]
+    self.obj.oms_setSolver.restype = ctypes.c_int
     self.obj.oms_simulate.argtypes = [ctypes.c_char_p]
     self.obj.oms_simulate.restype = ctypes.c_int
     self.obj.oms_stepUntil.argtypes = [ctypes.c_char_p, ctypes.c_double]
@@ -106,6 +137,11 @@ class capi:
     status = self.obj.oms_addSystem(system_name.encode('utf-8'), system_type)
     return Status(status)
 
+  def cloneModel(self, cref, newCref) -> Status:
+    '''Creates an independent copy of a model in the virgin state.'''
+    status = self.obj.oms_cloneModel(cref.encode(), newCref.encode())
+    return Status(status)
+
   def delete(self, cref):
     status = self.obj.oms_delete(cref.encode())
     return Status(status)
@@ -145,6 +181,11 @@ class capi:
     status = self.obj.oms_initialize(cref.encode())
     return Status(status)
 
+  def initializeFromCheckpoint(self, cref, filename) -> Status:
+    '''Initializes the model and continues from a checkpoint.'''
+    status = self.obj.oms_initializeFromCheckpoint(cref.encode(), filename.encode())
+    return Status(status)
+
   def instantiate(self, cref):
     status = self.obj.oms_instantiate(cref.encode())
     return Status(status)
@@ -154,6 +195,26 @@ class capi:
     status = self.obj.oms_newModel(model_name.encode('utf-8'))
     return Status(status)
 
+  def reset(self, cref) -> Status:
+    '''Resets the model after a simulation run, so that it can be initialized again.'''
+    status = self.obj.oms_reset(cref.encode())
+    return Status(status)
+
+  def saveCheckpoint(self, cref, filename) -> Status:
+    '''Writes a checkpoint of a model in simulation mode.'''
+    status = self.obj.oms_saveCheckpoint(cref.encode(), filename.encode())
+    return Status(status)
+
+  def setActivationRatio(self, cref, k: int) -> Status:
+    '''Steps a component or subsystem of a weakly coupled system only every k-th step.'''
+    status = self.obj.oms_setActivationRatio(cref.encode(), k)
+    return Status(status)
+
+  def setCheckpointFile(self, cref, filename, interval) -> Status:
+    '''Writes a checkpoint every interval seconds of simulation time.'''
+    status = self.obj.oms_setCheckpointFile(cref.encode(), filename.encode(), interval)
+    return Status(status)
+
   def setCommandLineOption(self, cmd):
     status = self.obj.oms_setCommandLineOption(cmd.encode())
     return Status(status)
@@ -194,6 +255,16 @@ class capi:
     status = self.obj.oms_setResultFile(cref.encode(), filename.encode(), bufferSize)
     return Status(status)
 
+  def setLogFile(self, filename) -> Status:
+    '''Redirects the log to the given file; an empty filename restores stdout.'''
+    status = self.obj.oms_setLogFile(filename.encode())
+    return Status(status)
+
+  def setSolver(self, cref, solver: Solver) -> Status:
+    '''Sets the solver method of a system.'''
+    status = self.obj.oms_setSolver(cref.encode(), solver.value)
+    return Status(status)
+
   def simulate(self, cref) -> Status:
     '''Exits initialization mode and runs the simulation until stopTime is reached.'''
     status = self.obj.oms_simulate(cref.encode())
@@ -202,7 +273,7 @@ class capi:
   def stepUntil(self, model, stopTime) -> Status:
     '''Step the simulation until the specified stop time.
     Note: If the model is in initialization mode, this will exit initialization mode.'''
-    status = self.obj.oms_stepUntil(model, stopTime)
+    status = self.obj.oms_stepUntil(model.encode(), stopTime)
     return Status(status)
 
   def terminate(self, cref) -> Status:
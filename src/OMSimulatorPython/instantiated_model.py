@@ -3,6 +3,7 @@ from OMSimulator.cref import CRef
 from OMSimulator.system import System
 from OMSimulator.values import Values
 from OMSimulator.variable import Causality, SignalType
+import copy
 import json
 import tempfile
 class InstantiatedModel:
@@ -240,6 +241,12 @@ class InstantiatedModel:
     if status != Status.ok:
       raise RuntimeError(f"Failed to initialize model: {status}")
 
+  def initializeFromCheckpoint(self, filename: str):
+    """Initializes the model and continues from a checkpoint written by saveCheckpoint()."""
+    status = Capi.initializeFromCheckpoint(self.modelName, filename)
+    if status != Status.ok:
+      raise RuntimeError(f"Failed to initialize model from checkpoint {filename}: {status}")
+
   def simulate(self):
     status = Capi.simulate(self.modelName)
     if status != Status.ok:
@@ -250,8 +257,28 @@ class InstantiatedModel:
     if status != Status.ok:
       raise RuntimeError(f"Failed to step until {stopTime}: {status}")
 
+  def saveCheckpoint(self, filename: str):
+    status = Capi.saveCheckpoint(self.modelName, filename)
+    if status != Status.ok:
+      raise RuntimeError(f"Failed to save checkpoint {filename}: {status}")
+
+  def setCheckpointFile(self, filename: str, interval: float):
+    status = Capi.setCheckpointFile(self.modelName, filename, interval)
+    if status != Status.ok:
+      raise RuntimeError(f"Failed to set checkpoint file {filename}: {status}")
+
+  def setActivationRatio(self, cref: CRef, k: int):
+    """Steps a component or subsystem only every k-th communication step of its system."""
+    name = ".".join(cref.names[:-1])
+    if name not in self.mappedCrefs:
+      raise KeyError(f"Missing required key: '{name}'")
+
+    status = Capi.setActivationRatio(".".join([self.mappedCrefs[name], cref.names[-1]]), k)
+    if status != Status.ok:
+      raise RuntimeError(f"Failed to set activation ratio for {cref}: {status}")
+
   def setResultFile(self, filename: str):
-    status = Capi.setResultFile("model", filename)
+    status = Capi.setResultFile(self.modelName, filename)
     if status !=Status.ok:
       raise RuntimeError(f"Failed to setResultFile {filename}: {status}")
 
@@ -260,6 +287,27 @@ class InstantiatedModel:
     if status != Status.ok:
       raise RuntimeError(f"Failed to terminate model: {status}")
 
+  def reset(self):
+    """Resets the model after a simulation run, so that it can be initialized again."""
+    status = Capi.reset(self.modelName)
+    if status != Status.ok:
+      raise RuntimeError(f"Failed to reset model: {status}")
+
+  def clone(self, modelName: str):
+    """Returns an independent, instantiated copy of the model."""
+    status = Capi.cloneModel(self.modelName, modelName)
+    if status != Status.ok:
+      raise RuntimeError(f"Failed to clone model: {status}")
+    status = Capi.instantiate(modelName)
+    if status != Status.ok:
+      raise RuntimeError(f"Failed to instantiate model: {status}")
+
+    clone = copy.copy(self)
+    clone.modelName = modelName
+    clone.apiCall = []
+    clone.mappedCrefs = {key: modelName + value[len(self.modelName):] for key, value in self.mappedCrefs.items()}
+    return clone
+
   def delete(self):
     status = Capi.delete(self.modelName)
     if status != Status.ok:
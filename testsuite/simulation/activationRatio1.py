@@ -0,0 +1,43 @@
+## status: correct
+## teardown_command: rm -rf activationRatio1.ssp model_res.mat
+## linux: yes
+## ucrt64: yes
+## win: yes
+## mac: yes
+
+from OMSimulator import SSP, CRef, Settings
+
+Settings.suppressPath = True
+
+
+# This example steps one of two identical FMUs only every 300th step of the
+# system (communication interval 0.3). Both FMUs integrate with a fixed step
+# of 0.1 internally, so they must agree whenever the system returns, also at
+# the end of a stepUntil that isn't a communication point of the slow FMU.
+
+model = SSP()
+model.addResource('../resources/Dahlquist.fmu', new_name='resources/Dahlquist.fmu')
+model.addComponent(CRef('default', 'fast'), 'resources/Dahlquist.fmu')
+model.addComponent(CRef('default', 'slow'), 'resources/Dahlquist.fmu')
+model.export('activationRatio1.ssp')
+
+model2 = SSP('activationRatio1.ssp')
+instantiated_model = model2.instantiate()
+instantiated_model.setActivationRatio(CRef('default', 'slow'), 300)
+instantiated_model.initialize()
+
+for stopTime in [0.25, 0.5, 1.0]:
+  instantiated_model.stepUntil(stopTime)
+  fast = instantiated_model.getValue(CRef('default', 'fast', 'x'))
+  slow = instantiated_model.getValue(CRef('default', 'slow', 'x'))
+  print(f"info:    {stopTime}: fast.x = {round(fast, 6)}, slow.x = {round(slow, 6)}", flush=True)
+
+instantiated_model.terminate()
+instantiated_model.delete()
+
+## Result:
+## info:    Result file: model_res.mat (bufferSize=1)
+## info:    0.25: fast.x = 0.81, slow.x = 0.81
+## info:    0.5: fast.x = 0.59049, slow.x = 0.59049
+## info:    1.0: fast.x = 0.348678, slow.x = 0.348678
+## endResult
@@ -0,0 +1,56 @@
+## status: correct
+## teardown_command: rm -rf algLoopExtrapolation1.ssp algLoopExtrapolation1.log model_res.mat
+## linux: yes
+## ucrt64: yes
+## win: yes
+## mac: yes
+
+from OMSimulator import SSP, CRef, Settings, Capi
+
+Settings.suppressPath = True
+
+
+# This example solves the algebraic loop y = u2 + 0.5*y in a weakly coupled
+# system, starting each solve from a quadratic extrapolation of the previous
+# solutions (--algLoopExtrapolation=2). Only the orders 0, 1 and 2 are
+# accepted.
+# The solver output depends on the platform and goes to a log file.
+
+Capi.setLogFile('algLoopExtrapolation1.log')
+Capi.setCommandLineOption('--algLoopExtrapolation=2')
+
+model = SSP()
+model.addResource('../resources/Modelica.Blocks.Math.Gain.fmu', new_name='resources/Gain.fmu')
+model.addResource('../resources/Modelica.Blocks.Math.Add.fmu', new_name='resources/Add.fmu')
+model.addComponent(CRef('default', 'Add'), 'resources/Add.fmu')
+model.addComponent(CRef('default', 'Gain'), 'resources/Gain.fmu')
+model.addConnection(CRef('default', 'Add', 'y'), CRef('default', 'Gain', 'u'))
+model.addConnection(CRef('default', 'Gain', 'y'), CRef('default', 'Add', 'u1'))
+model.export('algLoopExtrapolation1.ssp')
+
+model2 = SSP('algLoopExtrapolation1.ssp')
+instantiated_model = model2.instantiate()
+instantiated_model.setValue(CRef('default', 'Gain', 'k'), 0.5)
+instantiated_model.setValue(CRef('default', 'Add', 'u2'), 1.0)
+
+instantiated_model.initialize()
+instantiated_model.simulate()
+y = instantiated_model.getValue(CRef('default', 'Add', 'y'))
+instantiated_model.terminate()
+instantiated_model.delete()
+Capi.setLogFile('')
+
+print(f"info:    algebraic loop: y = {round(y, 3)}", flush=True)
+
+status = Capi.setCommandLineOption('--algLoopExtrapolation=3')
+print(f"info:    --algLoopExtrapolation=3: {status}", flush=True)
+
+## Result:
+## info:    Logging information has been saved to "algLoopExtrapolation1.log"
+## info:    algebraic loop: y = 2.0
+## error:   [SetFlag] Invalid value: "3" for flag --algLoopExtrapolation
+## error:   [SetCommandLineOption] Invalid value: "--algLoopExtrapolation=3"
+## info:    --algLoopExtrapolation=3: Status.error
+## info:    0 warnings
+## info:    2 errors
+## endResult
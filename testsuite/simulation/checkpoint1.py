@@ -0,0 +1,54 @@
+## status: correct
+## teardown_command: rm -rf checkpoint1.ssp checkpoint1.omsc model_res.mat
+## linux: yes
+## ucrt64: yes
+## win: yes
+## mac: yes
+
+from OMSimulator import SSP, CRef, Settings
+
+Settings.suppressPath = True
+
+
+# This example simulates a model, saves a checkpoint in between and resumes
+# the simulation from that checkpoint after a reset. The resumed run must
+# reproduce the trajectory of the first run.
+
+model = SSP()
+model.addResource('../resources/Dahlquist.fmu', new_name='resources/Dahlquist.fmu')
+model.addComponent(CRef('default', 'Dahlquist'), 'resources/Dahlquist.fmu')
+model.export('checkpoint1.ssp')
+
+model2 = SSP('checkpoint1.ssp')
+instantiated_model = model2.instantiate()
+instantiated_model.initialize()
+# stop between two communication points to check that the time is restored
+instantiated_model.stepUntil(0.5005)
+x_checkpoint = instantiated_model.getValue(CRef('default', 'Dahlquist', 'x'))
+instantiated_model.saveCheckpoint('checkpoint1.omsc')
+instantiated_model.stepUntil(1.0)
+x_first = instantiated_model.getValue(CRef('default', 'Dahlquist', 'x'))
+
+instantiated_model.reset()
+instantiated_model.initializeFromCheckpoint('checkpoint1.omsc')
+x_resumed = instantiated_model.getValue(CRef('default', 'Dahlquist', 'x'))
+instantiated_model.stepUntil(1.0)
+x_second = instantiated_model.getValue(CRef('default', 'Dahlquist', 'x'))
+
+print(f"info:    x at checkpoint: {round(x_checkpoint, 6)}", flush=True)
+print(f"info:    x after resume: {round(x_resumed, 6)}", flush=True)
+print(f"info:    x at stop time: {round(x_second, 6)}", flush=True)
+print(f"info:    same trajectory: {x_first == x_second}", flush=True)
+
+instantiated_model.terminate()
+instantiated_model.delete()
+
+## Result:
+## info:    Result file: model_res.mat (bufferSize=1)
+## info:    Resumed from checkpoint at time 0.500500
+## info:    Result file: model_res.mat (bufferSize=1)
+## info:    x at checkpoint: 0.59049
+## info:    x after resume: 0.59049
+## info:    x at stop time: 0.348678
+## info:    same trajectory: True
+## endResult
@@ -0,0 +1,53 @@
+## status: correct
+## teardown_command: rm -rf cloneModel1.ssp model_res.mat clone_res.mat
+## linux: yes
+## ucrt64: yes
+## win: yes
+## mac: yes
+
+from OMSimulator import SSP, CRef, Settings
+
+Settings.suppressPath = True
+
+
+# This example clones an instantiated model, changes a parameter of the clone
+# and simulates both models. The original model must not be affected.
+
+model = SSP()
+model.addResource('../resources/Dahlquist.fmu', new_name='resources/Dahlquist.fmu')
+model.addComponent(CRef('default', 'Dahlquist'), 'resources/Dahlquist.fmu')
+model.export('cloneModel1.ssp')
+
+model2 = SSP('cloneModel1.ssp')
+instantiated_model = model2.instantiate()
+clone = instantiated_model.clone('clone')
+clone.setValue(CRef('default', 'Dahlquist', 'k'), 2.0)
+
+instantiated_model.initialize()
+instantiated_model.simulate()
+clone.initialize()
+clone.simulate()
+
+print(f"info: model:", flush=True)
+print(f"info:    default.Dahlquist.k: {instantiated_model.getValue(CRef('default', 'Dahlquist', 'k'))}", flush=True)
+print(f"info:    default.Dahlquist.x: {round(instantiated_model.getValue(CRef('default', 'Dahlquist', 'x')), 6)}", flush=True)
+print(f"info: clone:", flush=True)
+print(f"info:    default.Dahlquist.k: {clone.getValue(CRef('default', 'Dahlquist', 'k'))}", flush=True)
+print(f"info:    default.Dahlquist.x: {round(clone.getValue(CRef('default', 'Dahlquist', 'x')), 6)}", flush=True)
+
+# the original can only be deleted after its clones
+clone.terminate()
+clone.delete()
+instantiated_model.terminate()
+instantiated_model.delete()
+
+## Result:
+## info:    Result file: model_res.mat (bufferSize=1)
+## info:    Result file: clone_res.mat (bufferSize=1)
+## info: model:
+## info:    default.Dahlquist.k: 1.0
+## info:    default.Dahlquist.x: 0.348678
+## info: clone:
+## info:    default.Dahlquist.k: 2.0
+## info:    default.Dahlquist.x: 0.107374
+## endResult
@@ -0,0 +1,53 @@
+## status: correct
+## teardown_command: rm -rf coupledRHS1.ssp coupledRHS1.log model_res.mat
+## linux: yes
+## ucrt64: yes
+## win: yes
+## mac: yes
+
+import math
+
+from OMSimulator import SSP, CRef, Settings, Capi
+
+Settings.suppressPath = True
+
+
+# This example simulates the feedback loop der(y) = -y in a strongly coupled
+# system with CVODE. The output of the gain is propagated to the integrator
+# in each evaluation of the right-hand side (--coupledRHS) instead of once
+# per step.
+# The solver statistics depend on the platform and go to a log file.
+
+Capi.setLogFile('coupledRHS1.log')
+Capi.setCommandLineOption('--coupledRHS=true')
+
+model = SSP()
+model.addResource('../resources/Modelica.Blocks.Continuous.Integrator.fmu', new_name='resources/Integrator.fmu')
+model.addResource('../resources/Modelica.Blocks.Math.Gain.fmu', new_name='resources/Gain.fmu')
+model.newSolver({'name' : 'solver1', 'method': 'cvode', 'tolerance': 1e-4})
+model.addComponent(CRef('default', 'Integrator'), 'resources/Integrator.fmu')
+model.addComponent(CRef('default', 'Gain'), 'resources/Gain.fmu')
+model.setSolver(CRef('default', 'Integrator'), 'solver1')
+model.setSolver(CRef('default', 'Gain'), 'solver1')
+model.addConnection(CRef('default', 'Integrator', 'y'), CRef('default', 'Gain', 'u'))
+model.addConnection(CRef('default', 'Gain', 'y'), CRef('default', 'Integrator', 'u'))
+model.export('coupledRHS1.ssp')
+
+model2 = SSP('coupledRHS1.ssp')
+instantiated_model = model2.instantiate()
+instantiated_model.setValue(CRef('default', 'Integrator', 'y_start'), 1.0)
+instantiated_model.setValue(CRef('default', 'Gain', 'k'), -1.0)
+
+instantiated_model.initialize()
+instantiated_model.simulate()
+y = instantiated_model.getValue(CRef('default', 'Integrator', 'y'))
+instantiated_model.terminate()
+instantiated_model.delete()
+Capi.setLogFile('')
+
+print(f"info:    y(1) = {round(y, 3)}, error < 1e-3: {abs(y - math.exp(-1)) < 1e-3}", flush=True)
+
+## Result:
+## info:    Logging information has been saved to "coupledRHS1.log"
+## info:    y(1) = 0.368, error < 1e-3: True
+## endResult
@@ -0,0 +1,57 @@
+## status: correct
+## teardown_command: rm -rf reset1.ssp model_res.mat
+## linux: yes
+## ucrt64: yes
+## win: yes
+## mac: yes
+
+from OMSimulator import SSP, CRef, Settings
+
+Settings.suppressPath = True
+
+
+# This example simulates a model, resets it and simulates it again without
+# instantiating the FMUs again. The second run must match the first one; the
+# third run uses a different parameter value.
+
+model = SSP()
+model.addResource('../resources/Dahlquist.fmu', new_name='resources/Dahlquist.fmu')
+model.addComponent(CRef('default', 'Dahlquist'), 'resources/Dahlquist.fmu')
+model.export('reset1.ssp')
+
+model2 = SSP('reset1.ssp')
+instantiated_model = model2.instantiate()
+instantiated_model.initialize()
+instantiated_model.simulate()
+x_first = instantiated_model.getValue(CRef('default', 'Dahlquist', 'x'))
+
+instantiated_model.reset()
+print(f"info:    x after reset: {instantiated_model.getValue(CRef('default', 'Dahlquist', 'x'))}", flush=True)
+instantiated_model.initialize()
+instantiated_model.simulate()
+x_second = instantiated_model.getValue(CRef('default', 'Dahlquist', 'x'))
+
+instantiated_model.reset()
+instantiated_model.setValue(CRef('default', 'Dahlquist', 'k'), 2.0)
+instantiated_model.initialize()
+instantiated_model.simulate()
+x_third = instantiated_model.getValue(CRef('default', 'Dahlquist', 'x'))
+
+print(f"info:    x of the first run: {round(x_first, 6)}", flush=True)
+print(f"info:    x of the second run: {round(x_second, 6)}", flush=True)
+print(f"info:    same result: {x_first == x_second}", flush=True)
+print(f"info:    x of the third run (k=2): {round(x_third, 6)}", flush=True)
+
+instantiated_model.terminate()
+instantiated_model.delete()
+
+## Result:
+## info:    Result file: model_res.mat (bufferSize=1)
+## info:    x after reset: 1.0
+## info:    Result file: model_res.mat (bufferSize=1)
+## info:    Result file: model_res.mat (bufferSize=1)
+## info:    x of the first run: 0.348678
+## info:    x of the second run: 0.348678
+## info:    same result: True
+## info:    x of the third run (k=2): 0.107374
+## endResult